@@ -5432,6 +5432,21 @@ bpstat_check_breakpoint_conditions (bpstat bs, thread_info *thread)
       return;
     }
 
+  /* CUDA - launch filters */
+  /* Auto breakpoints are shared by all the kernels; do not stop in the
+     kernels excluded by the launch filters. */
+  if (b->type == bp_cuda_auto)
+    {
+      kernel_t kernel = cuda_current_kernel ();
+
+      if (kernel && !kernels_launch_filter_match (kernel_get_virt_code_base (kernel),
+                                                  kernel_get_grid_dim (kernel)))
+        {
+          bs->stop = 0;
+          return;
+        }
+    }
+
   /* If this is a thread/task-specific breakpoint, don't waste cpu
      evaluating the condition if this isn't the specified
      thread/task.  */
@@ -8289,6 +8304,48 @@ cuda_remove_duplicate_locations (struct bp_location *promoted_loc, struct breakp
   return true;
 }
 
+/* CUDA - lazy symbol reading */
+/* Return true if resolving breakpoint B requires the line table of the
+   device ELF images. Breakpoints on functions and addresses only need the
+   minimal symbols. */
+static bool
+cuda_breakpoint_needs_line_info (struct breakpoint *b)
+{
+  const struct explicit_location *explicit_loc;
+  const char *spec;
+  bool needs_line_info = true;
+
+  if (b->location == NULL)
+    return false;
+
+  switch (event_location_type (b->location.get ()))
+    {
+    case LINESPEC_LOCATION:
+      spec = get_linespec_location (b->location.get ())->spec_string;
+      if (spec == NULL)
+        return false;
+      TRY
+        {
+          needs_line_info = !linespec_is_function_only (spec);
+        }
+      CATCH (ex, RETURN_MASK_ERROR)
+        {
+          needs_line_info = true;
+        }
+      END_CATCH
+      return needs_line_info;
+
+    case EXPLICIT_LOCATION:
+      explicit_loc = get_explicit_location_const (b->location.get ());
+      return explicit_loc->source_filename != NULL
+          || explicit_loc->label_name != NULL
+          || explicit_loc->line_offset.sign != LINE_OFFSET_UNKNOWN;
+
+    default:
+      return false;
+    }
+}
+
 void
 cuda_resolve_breakpoints (int bp_number_from, elf_image_t elf_image)
 {
@@ -8305,6 +8362,16 @@ cuda_resolve_breakpoints (int bp_number_from, elf_image_t elf_image)
   /* conditional breakpoints might rely on cudart symbols */
   cuda_update_cudart_symbols();
 
+  /* CUDA - lazy symbol reading */
+  if (!cuda_elf_image_symbols_read (elf_image))
+    ALL_BREAKPOINTS (b)
+      if (b->number > 0 && b->number > bp_number_from
+          && cuda_breakpoint_needs_line_info (b))
+        {
+          cuda_elf_image_read_symbols (elf_image);
+          break;
+        }
+
   ALL_BREAKPOINTS_SAFE (b, tmp)
     {
       /* skip internal breakpoints */
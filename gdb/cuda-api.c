@@ -20,6 +20,9 @@
 #include "common/common-defs.h"
 #include "gdbcore.h"
 #include "remote.h"
+#include "sha1.h"
+#include "common/filestuff.h"
+#include "common/rsp-low.h"
 
 #include "cuda-api.h"
 #include "cuda-options.h"
@@ -28,6 +31,7 @@
 #include "cuda-utils.h"
 
 #include <signal.h>
+#include <sys/stat.h>
 #ifndef __ANDROID__
 #include <execinfo.h>
 #endif
@@ -938,6 +942,8 @@ cuda_api_read_device_exception_state (uint32_t dev, uint64_t *exceptionSMMask, u
     }
 }
 
+/* Device memory writers invalidate the whole memory cache: the written
+   bytes may be cached under any of the spaces a generic address aliases. */
 void
 cuda_api_write_generic_memory (uint32_t dev, uint32_t sm, uint32_t wp, uint32_t ln, uint64_t addr, const void *buf, uint32_t sz)
 {
@@ -947,6 +953,8 @@ cuda_api_write_generic_memory (uint32_t dev, uint32_t sm, uint32_t wp, uint32_t
   if (!api_initialized)
     return;
 
+  cuda_memcache_invalidate ();
+
   res = cudbgAPI->writeGenericMemory (dev, sm, wp, ln, addr, buf, sz);
   cuda_api_print_api_call_result (res);
   if (res != CUDBG_SUCCESS && res != CUDBG_ERROR_ADDRESS_NOT_IN_DEVICE_MEM)
@@ -972,6 +980,8 @@ cuda_api_write_pinned_memory (uint64_t addr, const void *buf, uint32_t sz)
   if (!api_initialized)
     return false;
 
+  cuda_memcache_invalidate ();
+
   res = cudbgAPI->writePinnedMemory (addr, buf, sz);
   cuda_api_print_api_call_result (res);
   if (res != CUDBG_SUCCESS && res != CUDBG_ERROR_MEMORY_MAPPING_FAILED)
@@ -987,6 +997,8 @@ cuda_api_write_param_memory (uint32_t dev, uint32_t sm, uint32_t wp, uint64_t ad
   if (!api_initialized)
     return;
 
+  cuda_memcache_invalidate ();
+
   res = cudbgAPI->writeParamMemory (dev, sm, wp, addr, buf, sz);
   cuda_api_print_api_call_result (res);
   if (res != CUDBG_SUCCESS)
@@ -1003,6 +1015,8 @@ cuda_api_write_shared_memory (uint32_t dev, uint32_t sm, uint32_t wp, uint64_t a
   if (!api_initialized)
     return;
 
+  cuda_memcache_invalidate ();
+
   res = cudbgAPI->writeSharedMemory (dev, sm, wp, addr, buf, sz);
   cuda_api_print_api_call_result (res);
   if (res != CUDBG_SUCCESS)
@@ -1019,6 +1033,8 @@ cuda_api_write_local_memory (uint32_t dev, uint32_t sm, uint32_t wp, uint32_t ln
   if (!api_initialized)
     return;
 
+  cuda_memcache_invalidate ();
+
   res = cudbgAPI->writeLocalMemory (dev, sm, wp, ln, addr, buf, sz);
   cuda_api_print_api_call_result (res);
   if (res != CUDBG_SUCCESS)
@@ -1160,20 +1176,97 @@ cuda_api_get_tid (uint32_t dev, uint32_t sm, uint32_t wp, uint32_t *tid)
     cuda_devsmwp_api_error (_("get thread id"), dev, sm, wp, res);
 }
 
+/* On-disk cache of the device ELF images of remote targets, keyed by the
+   SHA1 reported by the server (set cuda elf_cache_dir). */
+static std::string
+cuda_elf_cache_path (const gdb_byte *hash, const char *suffix)
+{
+  char hex[CUDA_ELF_IMAGE_HASH_SIZE * 2 + 1];
+
+  bin2hex (hash, hex, CUDA_ELF_IMAGE_HASH_SIZE);
+  return string_printf ("%s/%s%s", cuda_options_elf_cache_dir (), hex, suffix);
+}
+
+static bool
+cuda_elf_cache_load (const gdb_byte *hash, void *elfImage, uint64_t size)
+{
+  std::string path = cuda_elf_cache_path (hash, ".elf");
+  gdb_byte actual[CUDA_ELF_IMAGE_HASH_SIZE];
+  struct stat st;
+  bool hit;
+
+  gdb_file_up file = gdb_fopen_cloexec (path.c_str (), "rb");
+  if (file == NULL)
+    return false;
+
+  hit = fstat (fileno (file.get ()), &st) == 0 && (uint64_t) st.st_size == size &&
+        fread (elfImage, 1, size, file.get ()) == size;
+
+  /* Do not trust a truncated or otherwise corrupted cache entry */
+  if (hit)
+    {
+      sha1_buffer ((const char *) elfImage, size, actual);
+      hit = memcmp (actual, hash, sizeof (actual)) == 0;
+    }
+
+  cuda_trace ("ELF image cache %s: %s", hit ? "hit" : "invalid entry", path.c_str ());
+  return hit;
+}
+
+static void
+cuda_elf_cache_store (const gdb_byte *hash, const void *elfImage, uint64_t size)
+{
+  std::string path = cuda_elf_cache_path (hash, ".elf");
+  std::string tmp_path = cuda_elf_cache_path (hash, string_printf (".%d.tmp", (int) getpid ()).c_str ());
+  bool written;
+
+  if (mkdir (cuda_options_elf_cache_dir (), S_IRWXU) != 0 && errno != EEXIST)
+    return;
+
+  gdb_file_up file = gdb_fopen_cloexec (tmp_path.c_str (), "wb");
+  if (file == NULL)
+    return;
+
+  written = fwrite (elfImage, 1, size, file.get ()) == size;
+  written = fclose (file.release ()) == 0 && written;
+
+  /* Publish the entry atomically so that concurrent sessions sharing the
+     directory never read a partial image. */
+  if (!written || rename (tmp_path.c_str (), path.c_str ()) != 0)
+    unlink (tmp_path.c_str ());
+  else
+    cuda_trace ("ELF image cache store: %s", path.c_str ());
+}
+
 void
 cuda_api_get_elf_image (uint32_t dev,  uint64_t handle, bool relocated,
                         void *elfImage, uint64_t size)
 {
   CUDBGResult res;
+  CUDBGElfImageType type = relocated ? CUDBG_ELF_IMAGE_TYPE_RELOCATED : CUDBG_ELF_IMAGE_TYPE_NONRELOCATED;
+  gdb_byte hash[CUDA_ELF_IMAGE_HASH_SIZE];
+  bool cacheable = false;
 
   if (!api_initialized)
     return;
 
-  res = cudbgAPI->getElfImageByHandle (dev, handle, relocated ? CUDBG_ELF_IMAGE_TYPE_RELOCATED : CUDBG_ELF_IMAGE_TYPE_NONRELOCATED, elfImage, size);
+  /* Only transfer the images missing from the local cache */
+  if (cuda_remote && cuda_options_elf_cache_dir ())
+    {
+      cacheable = cuda_remote_query_elf_image_hash (get_current_remote_target (),
+                                                    dev, handle, type, size, hash);
+      if (cacheable && cuda_elf_cache_load (hash, elfImage, size))
+        return;
+    }
+
+  res = cudbgAPI->getElfImageByHandle (dev, handle, type, elfImage, size);
   cuda_api_print_api_call_result (res);
   if (res != CUDBG_SUCCESS)
     cuda_api_error (res, _("Failed to read the ELF image (dev=%u, handle=%llu, relocated=%d)"),
            dev, (unsigned long long)handle, relocated);
+
+  if (cacheable)
+    cuda_elf_cache_store (hash, elfImage, size);
 }
 
 void
@@ -1646,6 +1739,8 @@ cuda_api_write_global_memory (uint64_t addr, const void *buf, uint32_t buf_size)
   if (!api_initialized)
     return;
 
+  cuda_memcache_invalidate ();
+
   res = cudbgAPI->writeGlobalMemory (addr, (void *)buf, buf_size);
   cuda_api_print_api_call_result (res);
 
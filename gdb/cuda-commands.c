@@ -46,6 +46,24 @@
 #include "arch-utils.h"
 #include "block.h"
 #include "cuda-commands.h"
+#include "cuda-api.h"
+#include "target-dcache.h"
+#include "common/byte-vector.h"
+#include "common/gdb_optional.h"
+#include "readline/tilde.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+#include <zlib.h>
 
 #ifdef CUDA_DEBUG_LINE_EXTENSION
 #include "demangle.h"
@@ -56,6 +74,141 @@ const char *status_string[] =
   { "Invalid", "Pending", "Active", "Sleeping", "Terminated", "Undetermined" };
 const char *status_string_preempted = "Active (preempted)";
 
+/* Print a notice when a listing stopped at 'set cuda max_rows' rows. */
+static void
+cuda_info_print_truncated (uint32_t num_rows)
+{
+  struct ui_out *uiout = current_uiout;
+
+  if (uiout->is_mi_like_p ())
+    {
+      uiout->field_int ("truncated", 1);
+      return;
+    }
+
+  uiout->message (_("Output limited to %u rows (see \"set cuda max_rows\").\n"),
+                  num_rows);
+}
+
+/* Number of rows the columns of a streamed table are sized from */
+#define CUDA_INFO_STREAM_ROWS 64
+
+/* Output of an 'info cuda' table whose rows are produced one at a time.
+
+   ui-out tables need their column widths before the first row. In CLI
+   mode, the widths are computed from the first CUDA_INFO_STREAM_ROWS rows,
+   and every following row is printed as soon as it is produced. The first
+   screen is thus printed before the rest of the device is queried, and
+   quitting at the pager prompt stops the scan. MI tables start with their
+   number of rows, so MI output collects all the rows first.
+
+   Both are bounded by 'set cuda max_rows'. LAYOUT describes the table: its
+   row_type, and the widen, num_columns, table_id, empty_message,
+   print_header and print_row methods. */
+template<typename Layout>
+class cuda_info_table_stream
+{
+public:
+  typedef typename Layout::row_type row_type;
+
+  explicit cuda_info_table_stream (Layout &layout)
+    : m_layout (layout),
+      m_uiout (current_uiout),
+      m_max_rows (cuda_options_max_rows ())
+  {
+  }
+
+  /* Whether max_rows rows were produced. The producer then stops, and
+     calls set_truncated if there were more. */
+  bool full () const
+  {
+    return m_num_rows >= m_max_rows;
+  }
+
+  void set_truncated ()
+  {
+    m_truncated = true;
+  }
+
+  void add (row_type &&row)
+  {
+    ++m_num_rows;
+
+    if (m_table.has_value ())
+      {
+        m_layout.print_row (m_uiout, row);
+        return;
+      }
+
+    m_layout.widen (row);
+    m_rows.push_back (std::move (row));
+    if (!m_uiout->is_mi_like_p () && m_rows.size () >= CUDA_INFO_STREAM_ROWS)
+      start_table ();
+  }
+
+  /* Print the remaining rows and close the table */
+  void finish ()
+  {
+    if (!m_table.has_value ())
+      {
+        if (m_rows.empty () && !m_uiout->is_mi_like_p ())
+          {
+            m_uiout->field_string (NULL, m_layout.empty_message ());
+            return;
+          }
+        start_table ();
+      }
+    m_table.reset ();
+
+    if (m_truncated)
+      cuda_info_print_truncated (m_num_rows);
+
+    gdb_flush (gdb_stdout);
+  }
+
+private:
+  void start_table ()
+  {
+    m_table.emplace (m_uiout, m_layout.num_columns (m_uiout), m_rows.size (),
+                     m_layout.table_id ());
+    m_layout.print_header (m_uiout);
+    m_uiout->table_body ();
+
+    for (const auto &row : m_rows)
+      m_layout.print_row (m_uiout, row);
+    m_rows.clear ();
+  }
+
+  Layout &m_layout;
+  struct ui_out *m_uiout;
+  uint32_t m_max_rows;
+  uint32_t m_num_rows = 0;
+  bool m_truncated = false;
+  std::vector<row_type> m_rows;
+  gdb::optional<ui_out_emit_table> m_table;
+};
+
+/* Length of the longest "(x,y,z)" block index of the known kernels, or
+   thread index if THREADS. Streamed tables start from it, so that the rows
+   printed after the first screen still line up. */
+static size_t
+cuda_info_max_idx_width (bool threads)
+{
+  char idx[32];
+  size_t width = 0;
+  kernel_t kernel;
+  CuDim3 dim;
+
+  for (kernel = kernels_get_first_kernel (); kernel; kernel = kernels_get_next_kernel (kernel))
+    {
+      dim = threads ? kernel_get_block_dim (kernel) : kernel_get_grid_dim (kernel);
+      snprintf (idx, sizeof (idx), "(%u,%u,%u)", dim.x, dim.y, dim.z);
+      width = std::max (width, strlen (idx));
+    }
+
+  return width;
+}
+
 /* returned string must be freed */
 static char *
 get_filename (struct symtab *s)
@@ -486,14 +639,98 @@ typedef struct {
   char     threadIdx[32];
 } cuda_info_warp_t;
 
+/* Column layout of 'info cuda warps' */
+struct cuda_info_warps_layout
+{
+  typedef cuda_info_warp_t row_type;
+
+  const char *header_current              = " ";
+  const char *header_wp                   = "Wp";
+  const char *header_active_lanes_mask    = "Active Lanes Mask";
+  const char *header_divergent_lanes_mask = "Divergent Lanes Mask";
+  const char *header_active_physical_pc   = "Active Physical PC";
+  const char *header_kernel_id            = "Kernel";
+  const char *header_blockIdx             = "BlockIdx";
+  const char *header_threadIdx            = "First Active ThreadIdx";
+
+  struct { size_t current, wp, active_lanes_mask, divergent_lanes_mask, active_physical_pc, kernel_id, blockIdx,threadIdx; } width;
+
+  uint32_t current_device = -1;
+  uint32_t current_sm = -1;
+
+  cuda_info_warps_layout ()
+  {
+    width.current              = strlen (header_current);
+    width.wp                   = strlen (header_wp);
+    width.active_lanes_mask    = strlen (header_active_lanes_mask);
+    width.divergent_lanes_mask = strlen (header_divergent_lanes_mask);
+    width.active_physical_pc   = strlen (header_active_physical_pc);
+    width.kernel_id            = strlen (header_kernel_id);
+    width.blockIdx             = strlen (header_blockIdx);
+    width.threadIdx            = strlen (header_threadIdx);
+
+    width.active_lanes_mask    = std::max (width.active_lanes_mask, (size_t)10);
+    width.divergent_lanes_mask = std::max (width.divergent_lanes_mask, (size_t)10);
+    width.active_physical_pc   = std::max (width.active_physical_pc, (size_t)18);
+    width.blockIdx             = std::max (width.blockIdx, cuda_info_max_idx_width (false));
+    width.threadIdx            = std::max (width.threadIdx, cuda_info_max_idx_width (true));
+  }
+
+  void widen (const cuda_info_warp_t &w)
+  {
+    width.blockIdx = std::max (width.blockIdx, strlen (w.blockIdx));
+    width.threadIdx = std::max (width.threadIdx, strlen (w.threadIdx));
+  }
+
+  int num_columns (struct ui_out *uiout) const { return 8; }
+  const char *table_id () const { return "InfoCudaWarpsTable"; }
+  const char *empty_message () const { return _("No CUDA Warps.\n"); }
+
+  void print_header (struct ui_out *uiout)
+  {
+    uiout->table_header (width.current             , ui_right, "current"             , header_current);
+    uiout->table_header (width.wp                  , ui_right, "warp"                , header_wp);
+    uiout->table_header (width.active_lanes_mask   , ui_right, "active_lanes_mask"   , header_active_lanes_mask);
+    uiout->table_header (width.divergent_lanes_mask, ui_right, "divergent_lanes_mask", header_divergent_lanes_mask);
+    uiout->table_header (width.active_physical_pc  , ui_right, "active_physical_pc"  , header_active_physical_pc);
+    uiout->table_header (width.kernel_id           , ui_right, "kernel"              , header_kernel_id);
+    uiout->table_header (width.blockIdx            , ui_right, "blockIdx"            , header_blockIdx);
+    uiout->table_header (width.threadIdx           , ui_right, "threadIdx"           , header_threadIdx);
+  }
+
+  void print_row (struct ui_out *uiout, const cuda_info_warp_t &w)
+  {
+    if (!uiout->is_mi_like_p () &&
+        (w.device != current_device || w.sm != current_sm))
+      {
+        uiout->message ("Device %u SM %u\n", w.device, w.sm);
+        current_device = w.device;
+        current_sm     = w.sm;
+      }
+
+    ui_out_emit_tuple tuple_emitter (uiout, "InfoCudaWarpsRow");
+    uiout->field_string ("current"             , w.current ? "*" : " ");
+    uiout->field_int    ("warp"                , w.wp);
+    uiout->field_string ("active_lanes_mask"   , w.active_lanes_mask);
+    uiout->field_string ("divergent_lanes_mask", w.divergent_lanes_mask);
+    uiout->field_string ("active_physical_pc"  , w.active_physical_pc);
+    uiout->field_string ("kernel"              , w.kernel_id);
+    uiout->field_string ("blockIdx"            , w.blockIdx);
+    uiout->field_string ("threadIdx"           , w.threadIdx);
+    uiout->text         ("\n");
+  }
+};
+
+/* Produce the rows of 'info cuda warps' into TABLE. The physical iterator
+   is lazy: its size is never asked, so that the device is only queried for
+   the rows produced. */
 static void
-cuda_info_warps (const char *filter_string, cuda_info_warp_t **warps, uint32_t *num_warps)
+cuda_info_warps (const char *filter_string,
+                 cuda_info_table_stream<cuda_info_warps_layout> &table)
 {
-  uint32_t num_elements;
-  cuda_iterator iter;
   cuda_filters_t default_filter, filter;
   cuda_coords_t c;
-  cuda_info_warp_t *w;
+  cuda_info_warp_t w;
   uint64_t active_physical_pc;
   uint32_t kernel_id;
   uint64_t active_lanes_mask, divergent_lanes_mask;
@@ -501,33 +738,35 @@ cuda_info_warps (const char *filter_string, cuda_info_warp_t **warps, uint32_t *
   CuDim3 threadIdx;
   kernel_t kernel;
 
-  /* sanity checks */
-  gdb_assert (warps);
-  gdb_assert (num_warps);
-
   /* set the filter */
   default_filter = CUDA_WILDCARD_FILTERS;
   default_filter.coords.dev = CUDA_CURRENT;
   default_filter.coords.sm  = CUDA_CURRENT;
   filter = cuda_build_filter (filter_string, &default_filter, CMD_FILTER);
 
-  /* get the list of sms */
-  iter = cuda_iterator_create (CUDA_ITERATOR_TYPE_WARPS, &filter.coords, CUDA_SELECT_ALL);
-  num_elements = cuda_iterator_get_size (iter);
-  *warps = (cuda_info_warp_t *) xmalloc (num_elements * sizeof (**warps));
-  *num_warps = 0;
+  /* get the list of warps */
+  cuda_iterator_up iter (cuda_iterator_create (CUDA_ITERATOR_TYPE_WARPS, &filter.coords,
+                                               CUDA_SELECT_ALL));
 
-  /* compile the needed info for each device */
-  for (cuda_iterator_start (iter), w = *warps;
-       !cuda_iterator_end (iter);
-       cuda_iterator_next (iter), ++w)
+  /* compile the needed info for each warp */
+  for (cuda_iterator_start (iter.get ());
+       !cuda_iterator_end (iter.get ());
+       cuda_iterator_next (iter.get ()))
     {
-      c  = cuda_iterator_get_current (iter);
+      QUIT;
+
+      if (table.full ())
+        {
+          table.set_truncated ();
+          break;
+        }
 
-      w->current              = cuda_coords_is_current (&c);
-      w->device               = c.dev;
-      w->sm                   = c.sm;
-      w->wp                   = c.wp;
+      c  = cuda_iterator_get_current (iter.get ());
+
+      w.current              = cuda_coords_is_current (&c);
+      w.device               = c.dev;
+      w.sm                   = c.sm;
+      w.wp                   = c.wp;
 
       if (warp_is_valid (c.dev, c.sm, c.wp))
         {
@@ -539,123 +778,35 @@ cuda_info_warps (const char *filter_string, cuda_info_warp_t **warps, uint32_t *
           active_physical_pc   = warp_get_active_pc (c.dev, c.sm, c.wp);
           threadIdx            = lane_get_thread_idx (c.dev, c.sm, c.wp, __builtin_ctz(active_lanes_mask));
 
-          snprintf (w->active_lanes_mask    , sizeof (w->active_lanes_mask)    , "0x%016llx"      , (unsigned long long)active_lanes_mask);
-          snprintf (w->divergent_lanes_mask , sizeof (w->divergent_lanes_mask) , "0x%016llx"      , (unsigned long long)divergent_lanes_mask);
-          snprintf (w->kernel_id            , sizeof (w->kernel_id)            , "%u"          , kernel_id);
-          snprintf (w->blockIdx             , sizeof (w->blockIdx)             , "(%u,%u,%u)"  , blockIdx.x, blockIdx.y, blockIdx.z);
-          snprintf (w->threadIdx            , sizeof (w->threadIdx)            , "(%u,%u,%u)"  , threadIdx.x, threadIdx.y, threadIdx.z);
-          snprintf (w->active_physical_pc   , sizeof (w->active_physical_pc)   , "0x%016llx"   , (unsigned long long)active_physical_pc);
+          snprintf (w.active_lanes_mask    , sizeof (w.active_lanes_mask)    , "0x%016llx"      , (unsigned long long)active_lanes_mask);
+          snprintf (w.divergent_lanes_mask , sizeof (w.divergent_lanes_mask) , "0x%016llx"      , (unsigned long long)divergent_lanes_mask);
+          snprintf (w.kernel_id            , sizeof (w.kernel_id)            , "%u"          , kernel_id);
+          snprintf (w.blockIdx             , sizeof (w.blockIdx)             , "(%u,%u,%u)"  , blockIdx.x, blockIdx.y, blockIdx.z);
+          snprintf (w.threadIdx            , sizeof (w.threadIdx)            , "(%u,%u,%u)"  , threadIdx.x, threadIdx.y, threadIdx.z);
+          snprintf (w.active_physical_pc   , sizeof (w.active_physical_pc)   , "0x%016llx"   , (unsigned long long)active_physical_pc);
         }
       else
         {
-          snprintf (w->active_lanes_mask    , sizeof (w->active_lanes_mask)    , "0x%016llx", 0ULL);
-          snprintf (w->divergent_lanes_mask , sizeof (w->divergent_lanes_mask) , "0x%016llx", 0ULL);
-          snprintf (w->kernel_id            , sizeof (w->kernel_id)            , "n/a");
-          snprintf (w->blockIdx             , sizeof (w->blockIdx)             , "n/a");
-          snprintf (w->threadIdx            , sizeof (w->threadIdx)            , "n/a");
-          snprintf (w->active_physical_pc   , sizeof (w->active_physical_pc   ), "n/a");
+          snprintf (w.active_lanes_mask    , sizeof (w.active_lanes_mask)    , "0x%016llx", 0ULL);
+          snprintf (w.divergent_lanes_mask , sizeof (w.divergent_lanes_mask) , "0x%016llx", 0ULL);
+          snprintf (w.kernel_id            , sizeof (w.kernel_id)            , "n/a");
+          snprintf (w.blockIdx             , sizeof (w.blockIdx)             , "n/a");
+          snprintf (w.threadIdx            , sizeof (w.threadIdx)            , "n/a");
+          snprintf (w.active_physical_pc   , sizeof (w.active_physical_pc   ), "n/a");
         }
 
-      ++*num_warps;
+      table.add (std::move (w));
     }
-
-  cuda_iterator_destroy (iter);
-}
-
-static void
-cuda_info_warps_destroy (cuda_info_warp_t *warps)
-{
-  xfree (warps);
 }
 
 void
 info_cuda_warps_command (const char *arg)
 {
-  cuda_info_warp_t *warps, *w;
-  uint32_t i, num_warps, current_device, current_sm;
-  struct { size_t current, wp, active_lanes_mask, divergent_lanes_mask, active_physical_pc, kernel_id, blockIdx,threadIdx; } width;
-
-  /* column headers */
-  const char *header_current              = " ";
-  const char *header_wp                   = "Wp";
-  const char *header_active_lanes_mask    = "Active Lanes Mask";
-  const char *header_divergent_lanes_mask = "Divergent Lanes Mask";
-  const char *header_active_physical_pc   = "Active Physical PC";
-  const char *header_kernel_id            = "Kernel";
-  const char *header_blockIdx             = "BlockIdx";
-  const char *header_threadIdx            = "First Active ThreadIdx";
-  struct ui_out *uiout = current_uiout;
-
-  /* get the information */
-  cuda_info_warps (arg, &warps, &num_warps);
-
-  /* output message if the list is empty */
-  if (num_warps == 0 && !uiout->is_mi_like_p ())
-    {
-      uiout->field_string (NULL, _("No CUDA Warps.\n"));
-      return;
-    }
-
-  /* column widths */
-  width.current              = strlen (header_current);
-  width.wp                   = strlen (header_wp);
-  width.active_lanes_mask    = strlen (header_active_lanes_mask);
-  width.divergent_lanes_mask = strlen (header_divergent_lanes_mask);
-  width.active_physical_pc   = strlen (header_active_physical_pc);
-  width.kernel_id            = strlen (header_kernel_id);
-  width.blockIdx             = strlen (header_blockIdx);
-  width.threadIdx            = strlen (header_threadIdx);
-
-  width.active_lanes_mask    = std::max (width.active_lanes_mask, (size_t)10);
-  width.divergent_lanes_mask = std::max (width.divergent_lanes_mask, (size_t)10);
-  width.active_physical_pc   = std::max (width.active_physical_pc, (size_t)18);
-  for (w = warps, i = 0;i < num_warps; ++i, ++w)
-    {
-      width.blockIdx = std::max (width.blockIdx, strlen (w->blockIdx));
-      width.threadIdx = std::max (width.threadIdx, strlen (w->threadIdx));
-    }
-
-  {
-    /* print table header */
-    ui_out_emit_table table_emitter (uiout, 8, num_warps, "InfoCudaWarpsTable");
-    uiout->table_header (width.current             , ui_right, "current"             , header_current);
-    uiout->table_header (width.wp                  , ui_right, "warp"                , header_wp);
-    uiout->table_header (width.active_lanes_mask   , ui_right, "active_lanes_mask"   , header_active_lanes_mask);
-    uiout->table_header (width.divergent_lanes_mask, ui_right, "divergent_lanes_mask", header_divergent_lanes_mask);
-    uiout->table_header (width.active_physical_pc  , ui_right, "active_physical_pc"  , header_active_physical_pc);
-    uiout->table_header (width.kernel_id           , ui_right, "kernel"              , header_kernel_id);
-    uiout->table_header (width.blockIdx            , ui_right, "blockIdx"            , header_blockIdx);
-    uiout->table_header (width.threadIdx           , ui_right, "threadIdx"           , header_threadIdx);
-    uiout->table_body ();
-
-    /* print table rows */
-    for (w = warps, i = 0, current_device = -1, current_sm = -1; i < num_warps; ++i, ++w)
-      {
-
-	if (!uiout->is_mi_like_p () &&
-	    (w->device != current_device || w->sm != current_sm))
-	  {
-	    uiout->message ("Device %u SM %u\n", w->device, w->sm);
-	    current_device = w->device;
-	    current_sm     = w->sm;
-	  }
+  cuda_info_warps_layout layout;
+  cuda_info_table_stream<cuda_info_warps_layout> table (layout);
 
-	ui_out_emit_tuple tuple_emitter (uiout, "InfoCudaWarpsRow");
-	uiout->field_string ("current"             , w->current ? "*" : " ");
-	uiout->field_int    ("warp"                , w->wp);
-	uiout->field_string ("active_lanes_mask"   , w->active_lanes_mask);
-	uiout->field_string ("divergent_lanes_mask", w->divergent_lanes_mask);
-	uiout->field_string ("active_physical_pc"  , w->active_physical_pc);
-	uiout->field_string ("kernel"              , w->kernel_id);
-	uiout->field_string ("blockIdx"            , w->blockIdx);
-	uiout->field_string ("threadIdx"           , w->threadIdx);
-	uiout->text         ("\n");
-      }
-  }
-  
-  gdb_flush (gdb_stdout);
-
-  cuda_info_warps_destroy (warps);
+  cuda_info_warps (arg, table);
+  table.finish ();
 }
 
 typedef struct {
@@ -670,23 +821,94 @@ typedef struct {
   const char     *exception;
 } cuda_info_lane_t;
 
+/* Column layout of 'info cuda lanes' */
+struct cuda_info_lanes_layout
+{
+  typedef cuda_info_lane_t row_type;
+
+  const char *header_current     = " ";
+  const char *header_ln          = "Ln";
+  const char *header_state       = "State";
+  const char *header_physical_pc = "Physical PC";
+  const char *header_thread_idx  = "ThreadIdx";
+  const char *header_exception   = "Exception";
+
+  struct { size_t current, ln, state, physical_pc, thread_idx, exception; } width;
+
+  uint32_t current_device = -1;
+  uint32_t current_sm = -1;
+  uint32_t current_wp = -1;
+
+  cuda_info_lanes_layout ()
+  {
+    width.current     = strlen (header_current);
+    width.ln          = strlen (header_ln);
+    width.state       = strlen (header_state);
+    width.physical_pc = strlen (header_physical_pc);
+    width.thread_idx  = strlen (header_thread_idx);
+    width.exception   = strlen (header_exception);
+
+    width.state       = std::max (width.state, strlen ("divergent"));
+    width.physical_pc = std::max (width.physical_pc, (size_t)18);
+    width.thread_idx  = std::max (width.thread_idx, cuda_info_max_idx_width (true));
+  }
+
+  void widen (const cuda_info_lane_t &l)
+  {
+    width.thread_idx = std::max (width.thread_idx, strlen (l.threadIdx));
+    width.exception = std::max (width.exception, strlen (l.exception));
+  }
+
+  int num_columns (struct ui_out *uiout) const { return 6; }
+  const char *table_id () const { return "InfoCudaLanesTable"; }
+  const char *empty_message () const { return _("No CUDA Lanes.\n"); }
+
+  void print_header (struct ui_out *uiout)
+  {
+    uiout->table_header (width.current     , ui_right, "current"     , header_current);
+    uiout->table_header (width.ln          , ui_right, "lane"        , header_ln);
+    uiout->table_header (width.state       , ui_center, "state"       , header_state);
+    uiout->table_header (width.physical_pc , ui_center, "physical_pc" , header_physical_pc);
+    uiout->table_header (width.thread_idx  , ui_right, "threadIdx"   , header_thread_idx);
+    uiout->table_header (width.exception   , ui_center, "exception"   , header_exception);
+  }
+
+  void print_row (struct ui_out *uiout, const cuda_info_lane_t &l)
+  {
+    if (!uiout->is_mi_like_p () &&
+        (l.device != current_device || l.sm != current_sm || l.wp != current_wp))
+      {
+        uiout->message ("Device %u SM %u Warp %u\n", l.device, l.sm, l.wp);
+        current_device = l.device;
+        current_sm     = l.sm;
+        current_wp     = l.wp;
+      }
+
+    ui_out_emit_tuple tuple_emitter (uiout, "InfoCudaLanesRow");
+    uiout->field_string ("current"    , l.current ? "*" : " ");
+    uiout->field_int    ("lane"       , l.ln);
+    uiout->field_string ("state"      , l.state);
+    uiout->field_string ("physical_pc", l.physical_pc);
+    uiout->field_string ("threadIdx"  , l.threadIdx);
+    uiout->field_string ("exception"  , l.exception);
+    uiout->text         ("\n");
+  }
+};
+
+/* Produce the rows of 'info cuda lanes' into TABLE (lazily, see
+   cuda_info_warps) */
 static void
-cuda_info_lanes (const char *filter_string, cuda_info_lane_t **lanes, uint32_t *num_lanes)
+cuda_info_lanes (const char *filter_string,
+                 cuda_info_table_stream<cuda_info_lanes_layout> &table)
 {
   CuDim3 threadIdx;
-  uint32_t num_elements;
-  cuda_iterator iter;
   cuda_filters_t default_filter, filter;
   cuda_coords_t c;
-  cuda_info_lane_t *l;
+  cuda_info_lane_t l;
   uint64_t physical_pc;
   bool active;
   CUDBGException_t exception;
 
-  /* sanity checks */
-  gdb_assert (lanes);
-  gdb_assert (num_lanes);
-
   /* set the filter */
   default_filter = CUDA_WILDCARD_FILTERS;
   default_filter.coords.dev = CUDA_CURRENT;
@@ -695,23 +917,29 @@ cuda_info_lanes (const char *filter_string, cuda_info_lane_t **lanes, uint32_t *
   filter = cuda_build_filter (filter_string, &default_filter, CMD_FILTER);
 
   /* get the list of lanes */
-  iter = cuda_iterator_create (CUDA_ITERATOR_TYPE_LANES, &filter.coords, CUDA_SELECT_ALL);
-  num_elements = cuda_iterator_get_size (iter);
-  *lanes = (cuda_info_lane_t *) xmalloc (num_elements * sizeof (**lanes));
-  *num_lanes = 0;
+  cuda_iterator_up iter (cuda_iterator_create (CUDA_ITERATOR_TYPE_LANES, &filter.coords,
+                                               CUDA_SELECT_ALL));
 
-  /* compile the needed info for each device */
-  for (cuda_iterator_start (iter), l = *lanes;
-       !cuda_iterator_end (iter);
-       cuda_iterator_next (iter), ++l)
+  /* compile the needed info for each lane */
+  for (cuda_iterator_start (iter.get ());
+       !cuda_iterator_end (iter.get ());
+       cuda_iterator_next (iter.get ()))
     {
-      c  = cuda_iterator_get_current (iter);
+      QUIT;
+
+      if (table.full ())
+        {
+          table.set_truncated ();
+          break;
+        }
 
-      l->current     = cuda_coords_is_current (&c);
-      l->device      = c.dev;
-      l->sm          = c.sm;
-      l->wp          = c.wp;
-      l->ln          = c.ln;
+      c  = cuda_iterator_get_current (iter.get ());
+
+      l.current     = cuda_coords_is_current (&c);
+      l.device      = c.dev;
+      l.sm          = c.sm;
+      l.wp          = c.wp;
+      l.ln          = c.ln;
 
       if (lane_is_valid (c.dev, c.sm, c.wp, c.ln))
         {
@@ -720,110 +948,31 @@ cuda_info_lanes (const char *filter_string, cuda_info_lane_t **lanes, uint32_t *
           physical_pc = lane_get_pc (c.dev, c.sm, c.wp, c.ln);
           exception   = lane_get_exception (c.dev, c.sm, c.wp, c.ln);
 
-          snprintf (l->state      , sizeof (l->state)      , "%s", active ? "active" : "divergent");
-          snprintf (l->threadIdx  , sizeof (l->threadIdx)  , "(%u,%u,%u)", threadIdx.x, threadIdx.y, threadIdx.z);
-          snprintf (l->physical_pc, sizeof (l->physical_pc), "0x%016llx", (unsigned long long)physical_pc);
-          l->exception = exception == CUDBG_EXCEPTION_NONE ? "None" : cuda_exception_type_to_name (exception);
+          snprintf (l.state      , sizeof (l.state)      , "%s", active ? "active" : "divergent");
+          snprintf (l.threadIdx  , sizeof (l.threadIdx)  , "(%u,%u,%u)", threadIdx.x, threadIdx.y, threadIdx.z);
+          snprintf (l.physical_pc, sizeof (l.physical_pc), "0x%016llx", (unsigned long long)physical_pc);
+          l.exception = exception == CUDBG_EXCEPTION_NONE ? "None" : cuda_exception_type_to_name (exception);
         }
       else
         {
-          snprintf (l->state      , sizeof (l->state)      , "inactive");
-          snprintf (l->threadIdx  , sizeof (l->threadIdx)  , "n/a");
-          snprintf (l->physical_pc, sizeof (l->physical_pc), "n/a");
-          l->exception = "n/a";
+          snprintf (l.state      , sizeof (l.state)      , "inactive");
+          snprintf (l.threadIdx  , sizeof (l.threadIdx)  , "n/a");
+          snprintf (l.physical_pc, sizeof (l.physical_pc), "n/a");
+          l.exception = "n/a";
         }
 
-      ++*num_lanes;
+      table.add (std::move (l));
     }
-
-  cuda_iterator_destroy (iter);
-}
-
-static void
-cuda_info_lanes_destroy (cuda_info_lane_t *lanes)
-{
-  xfree (lanes);
 }
 
 void
 info_cuda_lanes_command (const char *arg)
 {
-  cuda_info_lane_t *lanes, *l;
-  uint32_t i, num_lanes, current_device, current_sm, current_wp;
-  struct { size_t current, ln, state, physical_pc, thread_idx, exception; } width;
-
-  /* column headers */
-  const char *header_current     = " ";
-  const char *header_ln          = "Ln";
-  const char *header_state       = "State";
-  const char *header_physical_pc = "Physical PC";
-  const char *header_thread_idx  = "ThreadIdx";
-  const char *header_exception   = "Exception";
-  struct ui_out *uiout = current_uiout;
-
-  /* get the information */
-  cuda_info_lanes (arg, &lanes, &num_lanes);
-
-  /* output message if the list is empty */
-  if (num_lanes == 0 && !uiout->is_mi_like_p ())
-    {
-      uiout->field_string (NULL, _("No CUDA Lanes.\n"));
-      return;
-    }
-
-  /* column widths */
-  width.current     = strlen (header_current);
-  width.ln          = strlen (header_ln);
-  width.state       = strlen (header_state);
-  width.physical_pc = strlen (header_physical_pc);
-  width.thread_idx  = strlen (header_thread_idx);
-  width.exception  = strlen (header_exception);
-
-  width.state       = std::max (width.state, strlen ("divergent"));
-  width.physical_pc = std::max (width.physical_pc, (size_t)18);
-  for (l = lanes, i = 0; i < num_lanes; ++i, ++l)
-    {
-      width.thread_idx = std::max (width.thread_idx, strlen (l->threadIdx));
-      width.exception = std::max (width.exception, strlen (l->exception));
-    }
-
-  {
-    /* print table header */
-    ui_out_emit_table table_emitter (uiout, 6, num_lanes, "InfoCudaLanesTable");
-    uiout->table_header (width.current     , ui_right, "current"     , header_current);
-    uiout->table_header (width.ln          , ui_right, "lane"        , header_ln);
-    uiout->table_header (width.state       , ui_center, "state"       , header_state);
-    uiout->table_header (width.physical_pc , ui_center, "physical_pc" , header_physical_pc);
-    uiout->table_header (width.thread_idx  , ui_right, "threadIdx"   , header_thread_idx);
-    uiout->table_header (width.exception   , ui_center, "exception"   , header_exception);
-    uiout->table_body ();
-
-    /* print table rows */
-    for (l = lanes, i = 0, current_device = -1, current_sm = -1, current_wp = -1; i < num_lanes; ++i, ++l)
-      {
-	if (!uiout->is_mi_like_p () &&
-	    (l->device != current_device || l->sm != current_sm || l->wp != current_wp))
-	  {
-	    uiout->message ("Device %u SM %u Warp %u\n", l->device, l->sm, l->wp);
-	    current_device = l->device;
-	    current_sm     = l->sm;
-	    current_wp     = l->wp;
-	  }
-
-	ui_out_emit_tuple tuple_emitter (uiout, "InfoCudaLanesRow");
-	uiout->field_string ("current"    , l->current ? "*" : " ");
-	uiout->field_int    ("lane"       , l->ln);
-	uiout->field_string ("state"      , l->state);
-	uiout->field_string ("physical_pc", l->physical_pc);
-	uiout->field_string ("threadIdx"  , l->threadIdx);
-	uiout->field_string ("exception"  , l->exception);
-	uiout->text         ("\n");
-      }
-  }
-  
-  gdb_flush (gdb_stdout);
+  cuda_info_lanes_layout layout;
+  cuda_info_table_stream<cuda_info_lanes_layout> table (layout);
 
-  cuda_info_lanes_destroy (lanes);
+  cuda_info_lanes (arg, table);
+  table.finish ();
 }
 
 typedef struct {
@@ -1018,21 +1167,134 @@ typedef struct {
   uint32_t       sm;
 } cuda_info_block_t;
 
-static void
-cuda_info_blocks_build (const char *filter_string, cuda_info_block_t **blocks, uint32_t *num_blocks)
+/* Column layout of 'info cuda blocks', with or without coalescing */
+struct cuda_info_blocks_layout
+{
+  typedef cuda_info_block_t row_type;
+
+  const char *header_current   = " ";
+  const char *header_kernel    = "Kernel";
+  const char *header_block_idx = "BlockIdx";
+  const char *header_from      = "BlockIdx";
+  const char *header_to        = "To BlockIdx";
+  const char *header_count     = "Count";
+  const char *header_state     = "State";
+  const char *header_device    = "Dev";
+  const char *header_sm        = "SM";
+
+  struct { size_t current, kernel, block_idx, from, to, count, state, device, sm; } width;
+
+  bool coalesced = cuda_options_coalescing ();
+  uint64_t kernel_id = ~0ULL;
+
+  cuda_info_blocks_layout ()
+  {
+    width.current   = strlen (header_current);
+    width.kernel    = strlen (header_kernel);
+    width.block_idx = strlen (header_block_idx);
+    width.from      = strlen (header_from);
+    width.to        = strlen (header_to);
+    width.count     = strlen (header_count);
+    width.state     = strlen (header_state);
+    width.device    = strlen (header_device);
+    width.sm        = strlen (header_sm);
+
+    width.state     = std::max (width.state, sizeof ("running") - 1);
+    width.block_idx = std::max (width.block_idx, cuda_info_max_idx_width (false));
+    width.from      = std::max (width.from, cuda_info_max_idx_width (false));
+    width.to        = std::max (width.to, cuda_info_max_idx_width (false));
+  }
+
+  void widen (const cuda_info_block_t &b)
+  {
+    width.block_idx = std::max (width.block_idx, strlen (b.start_block_idx_string));
+    width.from      = std::max (width.from, strlen (b.start_block_idx_string));
+    width.to        = std::max (width.to  , strlen (b.end_block_idx_string));
+  }
+
+  /* 'kernel' is only present in MI output */
+  int num_columns (struct ui_out *uiout) const
+  {
+    return uiout->is_mi_like_p () ? 6 : 5;
+  }
+
+  const char *table_id () const
+  {
+    return coalesced ? "CoalescedInfoCudaBlocksTable" : "UncoalescedInfoCudaBlocksTable";
+  }
+
+  const char *empty_message () const { return _("No CUDA blocks.\n"); }
+
+  void print_header (struct ui_out *uiout)
+  {
+    uiout->table_header (width.current    , ui_right, "current"  , header_current);
+    if (uiout->is_mi_like_p ())
+      uiout->table_header (width.kernel   , ui_right, "kernel"   , header_kernel);
+    if (coalesced)
+      {
+        uiout->table_header (width.from   , ui_right, "from"     , header_from);
+        uiout->table_header (width.to     , ui_right, "to"       , header_to);
+        uiout->table_header (width.count  , ui_right, "count"    , header_count);
+        uiout->table_header (width.state  , ui_right, "state"    , header_state);
+      }
+    else
+      {
+        uiout->table_header (width.block_idx, ui_right, "blockIdx", header_block_idx);
+        uiout->table_header (width.state  , ui_right, "state"    , header_state);
+        uiout->table_header (width.device , ui_right, "device"   , header_device);
+        uiout->table_header (width.sm     , ui_right, "sm"       , header_sm);
+      }
+  }
+
+  void print_row (struct ui_out *uiout, const cuda_info_block_t &b)
+  {
+    if (!uiout->is_mi_like_p () && b.kernel_id != kernel_id)
+      {
+        /* row are grouped per kernel only in CLI output */
+        uiout->message ("Kernel %llu\n", (unsigned long long)b.kernel_id),
+        kernel_id = b.kernel_id;
+      }
+
+    if (coalesced)
+      {
+        ui_out_emit_tuple tuple_emitter (uiout, "CoalescedInfoCudaBlocksRow");
+        uiout->field_string ("current" , b.current ? "*" : " ");
+        if (uiout->is_mi_like_p ())
+          uiout->field_int  ("kernel"  , b.kernel_id);
+        uiout->field_string ("from"    , b.start_block_idx_string);
+        uiout->field_string ("to"      , b.end_block_idx_string);
+        uiout->field_int    ("count"   , b.count);
+        uiout->field_string ("state"   , "running");
+        uiout->text         ("\n");
+      }
+    else
+      {
+        ui_out_emit_tuple tuple_emitter (uiout, "UncoalescedInfoCudaBlocksRow");
+        uiout->field_string ("current" , b.current ? "*" : " ");
+        if (uiout->is_mi_like_p ())
+          uiout->field_int  ("kernel"  , b.kernel_id);
+        uiout->field_string ("blockIdx", b.start_block_idx_string);
+        uiout->field_string ("state"   , "running");
+        uiout->field_int    ("device"  , b.device);
+        uiout->field_int    ("sm"      , b.sm);
+        uiout->text         ("\n");
+      }
+  }
+};
+
+/* Produce the rows of 'info cuda blocks' into TABLE. A row is added as soon
+   as its range of blocks is closed, and the iteration stops before starting
+   a row past 'set cuda max_rows'. */
+static void
+cuda_info_blocks_build (const char *filter_string,
+                        cuda_info_table_stream<cuda_info_blocks_layout> &table)
 {
-  uint32_t i, num_elements;
-  cuda_iterator iter;
   cuda_filters_t default_filter, filter;
   cuda_coords_t c, expected;
   CuDim3 prev_block_idx = { CUDA_INVALID, CUDA_INVALID, CUDA_INVALID };
   kernel_t kernel;
-  cuda_info_block_t *b;
-  bool first_entry, break_of_contiguity;
-
-  /* sanity checks */
-  gdb_assert (blocks);
-  gdb_assert (num_blocks);
+  cuda_info_block_t b;
+  bool open_range, break_of_contiguity;
 
   /* make valgrind not complain */
   expected = CUDA_INVALID_COORDS;
@@ -1043,50 +1305,58 @@ cuda_info_blocks_build (const char *filter_string, cuda_info_block_t **blocks, u
   filter = cuda_build_filter (filter_string, &default_filter, CMD_FILTER);
 
   /* get the list of blocks */
-  iter = cuda_iterator_create (CUDA_ITERATOR_TYPE_BLOCKS, &filter.coords, CUDA_SELECT_VALID);
-  num_elements = cuda_iterator_get_size (iter);
-  *blocks = (cuda_info_block_t *) xmalloc (num_elements * sizeof (**blocks));
-  *num_blocks = 0;
+  cuda_iterator_up iter (cuda_iterator_create (CUDA_ITERATOR_TYPE_BLOCKS, &filter.coords,
+                                               CUDA_SELECT_VALID));
 
   /* compile the needed info for each block */
-  for (cuda_iterator_start (iter), first_entry = true, i = 0, b = *blocks;
-       !cuda_iterator_end (iter);
-       cuda_iterator_next (iter),  first_entry = false, ++i)
+  for (cuda_iterator_start (iter.get ()), open_range = false;
+       !cuda_iterator_end (iter.get ());
+       cuda_iterator_next (iter.get ()))
     {
-      c  = cuda_iterator_get_current (iter);
+      QUIT;
+
+      c  = cuda_iterator_get_current (iter.get ());
       kernel = kernels_find_kernel_by_grid_id (c.dev, c.gridId);
 
       /* data for the current iteration */
       break_of_contiguity = cuda_coords_compare_logical (&expected, &c) != 0;
 
       /* close the current range */
-      if (!first_entry && (break_of_contiguity || !cuda_options_coalescing ()))
+      if (open_range && (break_of_contiguity || !cuda_options_coalescing ()))
         {
-          b->end_block_idx = prev_block_idx;
-          snprintf (b->end_block_idx_string, sizeof (b->end_block_idx_string),
+          b.end_block_idx = prev_block_idx;
+          snprintf (b.end_block_idx_string, sizeof (b.end_block_idx_string),
                     "(%u,%u,%u)", prev_block_idx.x, prev_block_idx.y, prev_block_idx.z);
-          ++b;
-          ++*num_blocks;
+          table.add (std::move (b));
+          open_range = false;
         }
 
       /* start a new range */
-      if (first_entry || break_of_contiguity || !cuda_options_coalescing ())
+      if (!open_range)
         {
-          b->kernel          = kernel;
-          b->current         = false;
-          b->start_block_idx = c.blockIdx;
-          b->count           = 0;
-          b->kernel_id       = kernel_get_id (kernel);
-          b->kernel_dim      = kernel_get_dimensions (kernel);
-          b->device          = c.dev;
-          b->sm              = c.sm;
-          snprintf (b->start_block_idx_string, sizeof (b->start_block_idx_string),
+          /* enough rows, do not query the remaining blocks */
+          if (table.full ())
+            {
+              table.set_truncated ();
+              break;
+            }
+
+          b.kernel          = kernel;
+          b.current         = false;
+          b.start_block_idx = c.blockIdx;
+          b.count           = 0;
+          b.kernel_id       = kernel_get_id (kernel);
+          b.kernel_dim      = kernel_get_dimensions (kernel);
+          b.device          = c.dev;
+          b.sm              = c.sm;
+          snprintf (b.start_block_idx_string, sizeof (b.start_block_idx_string),
                     "(%u,%u,%u)", c.blockIdx.x, c.blockIdx.y, c.blockIdx.z);
+          open_range = true;
         }
 
       /* update the current range */
-      b->current |= cuda_coords_is_current (&c);
-      ++b->count;
+      b.current |= cuda_coords_is_current (&c);
+      ++b.count;
 
       /* data for the next iteration */
       prev_block_idx = c.blockIdx;
@@ -1097,190 +1367,23 @@ cuda_info_blocks_build (const char *filter_string, cuda_info_block_t **blocks, u
     }
 
   /* close the last range */
-  if (num_elements > 0)
-    {
-      b->end_block_idx = c.blockIdx;
-      snprintf (b->end_block_idx_string, sizeof (b->end_block_idx_string),
-                "(%u,%u,%u)", c.blockIdx.x, c.blockIdx.y, c.blockIdx.z);
-      ++*num_blocks;
-    }
-
-  cuda_iterator_destroy (iter);
-}
-
-static void
-cuda_info_blocks_destroy (cuda_info_block_t *blocks)
-{
-  xfree (blocks);
-}
-
-static void
-info_cuda_blocks_print_uncoalesced (cuda_info_block_t *blocks, uint32_t num_blocks)
-{
-  cuda_info_block_t *b;
-  uint32_t i, num_columns;
-  uint64_t kernel_id;
-  struct { size_t current, kernel, block_idx, state, device, sm; } width;
-
-  /* column headers */
-  const char *header_current   = " ";
-  const char *header_kernel    = "Kernel";
-  const char *header_block_idx = "BlockIdx";
-  const char *header_state     = "State";
-  const char *header_device    = "Dev";
-  const char *header_sm        = "SM";
-  struct ui_out *uiout = current_uiout;
-
-  /* sanity checks */
-  gdb_assert (!cuda_options_coalescing ());
-
-  /* output message if the list is empty */
-  if (num_blocks == 0 && !uiout->is_mi_like_p ())
-    {
-      uiout->field_string (NULL, _("No CUDA blocks.\n"));
-      return;
-    }
-
-  /* column widths */
-  width.current   = strlen (header_current);
-  width.kernel    = strlen (header_kernel);
-  width.block_idx = strlen (header_block_idx);
-  width.state     = strlen (header_state);
-  width.device    = strlen (header_device);
-  width.sm        = strlen (header_sm);
-
-  width.state = std::max (width.state, sizeof ("running") - 1);
-  for (b = blocks, i = 0; i < num_blocks; ++i, ++b)
-    width.block_idx = std::max (width.block_idx, strlen (b->start_block_idx_string));
-
-  /* print table header ('kernel' is only present in MI output) */
-  num_columns = uiout->is_mi_like_p () ? 6 : 5;
-
-  ui_out_emit_table table_emitter (uiout, num_columns, num_blocks, "UncoalescedInfoCudaBlocksTable");
-  uiout->table_header (width.current  , ui_right, "current"  , header_current);
-  if (uiout->is_mi_like_p ())
-    uiout->table_header (width.kernel , ui_right, "kernel"   , header_kernel);
-  uiout->table_header (width.block_idx, ui_right, "blockIdx" , header_block_idx);
-  uiout->table_header (width.state    , ui_right, "state"    , header_state);
-  uiout->table_header (width.device   , ui_right, "device"   , header_device);
-  uiout->table_header (width.sm       , ui_right, "sm"       , header_sm);
-  uiout->table_body ();
-
-  /* print table rows */
-  for (b = blocks, i = 0, kernel_id = ~0ULL; i < num_blocks; ++i, ++b)
-    {
-      if (!uiout->is_mi_like_p () && b->kernel_id != kernel_id)
-        {
-          /* row are grouped per kernel only in CLI output */
-          uiout->message ("Kernel %llu\n", (unsigned long long)b->kernel_id),
-          kernel_id = b->kernel_id;
-        }
-
-      ui_out_emit_tuple tuple_emitter (uiout, "UncoalescedInfoCudaBlocksRow");
-      uiout->field_string ("current" , b->current ? "*" : " ");
-      if (uiout->is_mi_like_p ())
-        uiout->field_int  ("kernel"  , b->kernel_id);
-      uiout->field_string ("blockIdx", b->start_block_idx_string);
-      uiout->field_string ("state"   , "running");
-      uiout->field_int	  ("device"  , b->device);
-      uiout->field_int	  ("sm"      , b->sm);
-      uiout->text         ("\n");
-    }
-}
-
-static void
-info_cuda_blocks_print_coalesced (cuda_info_block_t *blocks, uint32_t num_blocks)
-{
-  cuda_info_block_t *b;
-  uint32_t i, num_columns;
-  uint64_t kernel_id;
-  struct { size_t current, kernel, from, to, count, state; } width;
-
-  /* column headers */
-  const char *header_current   = " ";
-  const char *header_kernel    = "Kernel";
-  const char *header_from      = "BlockIdx";
-  const char *header_to        = "To BlockIdx";
-  const char *header_count     = "Count";
-  const char *header_state     = "State";
-  struct ui_out *uiout = current_uiout;
-
-  /* sanity checks */
-  gdb_assert (cuda_options_coalescing ());
-
-  /* output message if the list is empty */
-  if (num_blocks == 0 && !uiout->is_mi_like_p ())
-    {
-      uiout->field_string (NULL, _("No CUDA blocks.\n"));
-      return;
-    }
-
-  /* column widths */
-  width.current   = strlen (header_current);
-  width.kernel    = strlen (header_kernel);
-  width.from      = strlen (header_from);
-  width.to        = strlen (header_to);
-  width.count     = strlen (header_count);
-  width.state     = strlen (header_state);
-
-  width.state = std::max (width.state, sizeof ("running") - 1);
-  for (b = blocks, i = 0; i < num_blocks; ++i, ++b)
-    {
-      width.from = std::max (width.from, strlen (b->start_block_idx_string));
-      width.to   = std::max (width.to  , strlen (b->end_block_idx_string));
-    }
-
-  /* print table header ('kernel' is only present in MI output) */
-  num_columns = uiout->is_mi_like_p () ? 6 : 5;
-
-  ui_out_emit_table table_emitter (uiout, num_columns, num_blocks, "CoalescedInfoCudaBlocksTable");
-  uiout->table_header (width.current  , ui_right, "current"  , header_current);
-  if (uiout->is_mi_like_p ())
-    uiout->table_header (width.kernel , ui_right, "kernel"   , header_kernel);
-  uiout->table_header (width.from     , ui_right, "from"     , header_from);
-  uiout->table_header (width.to       , ui_right, "to"       , header_to);
-  uiout->table_header (width.count    , ui_right, "count"    , header_count);
-  uiout->table_header (width.state    , ui_right, "state"    , header_state);
-  uiout->table_body   ();
-
-  /* print table rows */
-  for (b = blocks, i = 0, kernel_id = ~0ULL; i < num_blocks; ++i, ++b)
+  if (open_range)
     {
-      if (!uiout->is_mi_like_p () && b->kernel_id != kernel_id)
-        {
-          /* row are grouped per kernel only in CLI output */
-          uiout->message ("Kernel %llu\n", (unsigned long long)b->kernel_id),
-          kernel_id = b->kernel_id;
-        }
-
-      ui_out_emit_tuple tuple_emitter (uiout, "CoalescedInfoCudaBlocksRow");
-      uiout->field_string ("current" , b->current ? "*" : " ");
-      if (uiout->is_mi_like_p ())
-        uiout->field_int  ("kernel"  , b->kernel_id);
-      uiout->field_string ("from"    , b->start_block_idx_string);
-      uiout->field_string ("to"      , b->end_block_idx_string);
-      uiout->field_int	  ("count"   , b->count);
-      uiout->field_string ("state"   , "running");
-      uiout->text         ("\n");
+      b.end_block_idx = prev_block_idx;
+      snprintf (b.end_block_idx_string, sizeof (b.end_block_idx_string),
+                "(%u,%u,%u)", prev_block_idx.x, prev_block_idx.y, prev_block_idx.z);
+      table.add (std::move (b));
     }
 }
 
 void
 info_cuda_blocks_command (const char *arg)
 {
-  cuda_info_block_t *blocks;
-  uint32_t num_blocks;
-
-  cuda_info_blocks_build (arg, &blocks, &num_blocks);
-
-  if (cuda_options_coalescing ())
-    info_cuda_blocks_print_coalesced (blocks, num_blocks);
-  else
-    info_cuda_blocks_print_uncoalesced (blocks, num_blocks);
-
-  gdb_flush (gdb_stdout);
+  cuda_info_blocks_layout layout;
+  cuda_info_table_stream<cuda_info_blocks_layout> table (layout);
 
-  cuda_info_blocks_destroy (blocks);
+  cuda_info_blocks_build (arg, table);
+  table.finish ();
 }
 
 
@@ -1289,7 +1392,7 @@ typedef struct {
   kernel_t       kernel;
   uint64_t       kernel_id;
   uint64_t       pc;
-  char          *filename;
+  gdb::unique_xmalloc_ptr<char> filename;
   uint32_t       line;
   CuDim3         start_block_idx;
   CuDim3         start_thread_idx;
@@ -1307,27 +1410,163 @@ typedef struct {
   uint32_t       ln;
 } cuda_info_thread_t;
 
+/* Column layout of 'info cuda threads', with or without coalescing */
+struct cuda_info_threads_layout
+{
+  typedef cuda_info_thread_t row_type;
+
+  const char *header_current          = " ";
+  const char *header_kernel           = "Kernel";
+  const char *header_block_idx        = "BlockIdx";
+  const char *header_thread_idx       = "ThreadIdx";
+  const char *header_end_block_idx    = "To BlockIdx";
+  const char *header_end_thread_idx   = "ThreadIdx";
+  const char *header_count            = "Count";
+  const char *header_pc               = "Virtual PC";
+  const char *header_device           = "Dev";
+  const char *header_sm               = "SM";
+  const char *header_warp             = "Wp";
+  const char *header_lane             = "Ln";
+  const char *header_filename         = "Filename";
+  const char *header_line             = "Line";
+
+  struct { size_t current, kernel, block_idx, thread_idx, end_block_idx, end_thread_idx,
+      count, pc, device, sm, wp, ln, filename, line; } width;
+
+  bool coalesced = cuda_options_coalescing ();
+  uint64_t kernel_id = ~0ULL;
+
+  cuda_info_threads_layout ()
+  {
+    width.current        = strlen (header_current);
+    width.kernel         = strlen (header_kernel);
+    width.block_idx      = strlen (header_block_idx);
+    width.thread_idx     = strlen (header_thread_idx);
+    width.end_block_idx  = strlen (header_end_block_idx);
+    width.end_thread_idx = strlen (header_end_thread_idx);
+    width.count          = strlen (header_count);
+    width.pc             = strlen (header_pc);
+    width.device         = strlen (header_device);
+    width.sm             = strlen (header_sm);
+    width.wp             = strlen (header_warp);
+    width.ln             = strlen (header_lane);
+    width.filename       = strlen (header_filename);
+    width.line           = strlen (header_line);
+
+    width.pc             = std::max (width.pc, (size_t)18);
+    width.line           = std::max (width.line, (size_t)5);
+    width.block_idx      = std::max (width.block_idx, cuda_info_max_idx_width (false));
+    width.thread_idx     = std::max (width.thread_idx, cuda_info_max_idx_width (true));
+    width.end_block_idx  = std::max (width.end_block_idx, cuda_info_max_idx_width (false));
+    width.end_thread_idx = std::max (width.end_thread_idx, cuda_info_max_idx_width (true));
+  }
+
+  void widen (const cuda_info_thread_t &t)
+  {
+    width.block_idx      = std::max (width.block_idx, strlen (t.start_block_idx_string));
+    width.thread_idx     = std::max (width.thread_idx, strlen (t.start_thread_idx_string));
+    width.end_block_idx  = std::max (width.end_block_idx, strlen (t.end_block_idx_string));
+    width.end_thread_idx = std::max (width.end_thread_idx, strlen (t.end_thread_idx_string));
+    width.filename       = std::max (width.filename, t.filename ? strlen (t.filename.get ()) : 0);
+  }
+
+  /* 'kernel' is only present in MI output */
+  int num_columns (struct ui_out *uiout) const
+  {
+    return (coalesced ? 9 : 10) + (uiout->is_mi_like_p () ? 1 : 0);
+  }
+
+  const char *table_id () const
+  {
+    return coalesced ? "CoalescedInfoCudaThreadsTable" : "UncoalescedInfoCudaThreadsTable";
+  }
+
+  const char *empty_message () const { return _("No CUDA threads.\n"); }
+
+  void print_header (struct ui_out *uiout)
+  {
+    uiout->table_header (width.current       , ui_right, "current"       , header_current);
+    if (uiout->is_mi_like_p ())
+      uiout->table_header (width.kernel      , ui_right, "kernel"        , header_kernel);
+    if (coalesced)
+      {
+        uiout->table_header (width.block_idx     , ui_right, "from_blockIdx" , header_block_idx);
+        uiout->table_header (width.thread_idx    , ui_right, "from_threadIdx", header_thread_idx);
+        uiout->table_header (width.end_block_idx , ui_right, "to_blockIdx"   , header_end_block_idx);
+        uiout->table_header (width.end_thread_idx, ui_right, "to_threadIdx"  , header_end_thread_idx);
+        uiout->table_header (width.count         , ui_right, "count"         , header_count);
+        uiout->table_header (width.pc            , ui_right, "virtual_pc"    , header_pc);
+      }
+    else
+      {
+        uiout->table_header (width.block_idx , ui_right, "blockIdx"  , header_block_idx);
+        uiout->table_header (width.thread_idx, ui_right, "threadIdx" , header_thread_idx);
+        uiout->table_header (width.pc        , ui_right, "virtual_pc", header_pc);
+        uiout->table_header (width.device    , ui_right, "device"    , header_device);
+        uiout->table_header (width.sm        , ui_right, "sm"        , header_sm);
+        uiout->table_header (width.wp        , ui_right, "warp"      , header_warp);
+        uiout->table_header (width.ln        , ui_right, "lane"      , header_lane);
+      }
+    uiout->table_header (width.filename      , ui_right, "filename"      , header_filename);
+    uiout->table_header (width.line          , ui_right, "line"          , header_line);
+  }
+
+  void print_row (struct ui_out *uiout, const cuda_info_thread_t &t)
+  {
+    if (!uiout->is_mi_like_p () && t.kernel_id != kernel_id)
+      {
+        /* row are grouped per kernel only in CLI output */
+        uiout->message ("Kernel %llu\n", (unsigned long long)t.kernel_id),
+        kernel_id = t.kernel_id;
+      }
+
+    ui_out_emit_tuple tuple_emitter (uiout, coalesced ? "CoalescedInfoCudaThreadsRow"
+                                                      : "UncoalescedInfoCudaThreadsRow");
+    uiout->field_string ("current"         , t.current ? "*" : " ");
+    if (uiout->is_mi_like_p ())
+      uiout->field_int  ("kernel"          , t.kernel_id);
+    if (coalesced)
+      {
+        uiout->field_string ("from_blockIdx" , t.start_block_idx_string);
+        uiout->field_string ("from_threadIdx", t.start_thread_idx_string);
+        uiout->field_string ("to_blockIdx"   , t.end_block_idx_string);
+        uiout->field_string ("to_threadIdx"  , t.end_thread_idx_string);
+        uiout->field_int    ("count"         , t.count);
+        uiout->field_fmt    ("virtual_pc"    , "0x%016llx", (unsigned long long)t.pc);
+      }
+    else
+      {
+        uiout->field_string ("blockIdx"  , t.start_block_idx_string);
+        uiout->field_string ("threadIdx" , t.start_thread_idx_string);
+        uiout->field_fmt    ("virtual_pc", "0x%016llx", (unsigned long long)t.pc);
+        uiout->field_int    ("device"    , t.device);
+        uiout->field_int    ("sm"        , t.sm);
+        uiout->field_int    ("warp"      , t.wp);
+        uiout->field_int    ("lane"      , t.ln);
+      }
+    uiout->field_string ("filename"        , t.filename ? t.filename.get () : "n/a");
+    uiout->field_int    ("line"            , t.line);
+    uiout->text         ("\n");
+  }
+};
+
+/* Produce the rows of 'info cuda threads' into TABLE, like
+   cuda_info_blocks_build. */
 static void
-cuda_info_threads_build (const char *filter_string, cuda_info_thread_t **threads, uint32_t *num_threads)
+cuda_info_threads_build (const char *filter_string,
+                         cuda_info_table_stream<cuda_info_threads_layout> &table)
 {
-  uint32_t i, num_elements;
   uint64_t pc = 0, prev_pc = 0;
-  cuda_iterator iter;
   cuda_filters_t default_filter, filter;
   cuda_coords_t  c, expected;
   CuDim3 prev_block_idx = { CUDA_INVALID, CUDA_INVALID, CUDA_INVALID };
   CuDim3 prev_thread_idx = { CUDA_INVALID, CUDA_INVALID, CUDA_INVALID };
   kernel_t kernel;
-  cuda_info_thread_t *t;
+  cuda_info_thread_t t;
   struct symtab_and_line sal, prev_sal;
-  bool first_entry, break_of_contiguity;
+  bool open_range, break_of_contiguity;
   struct value_print_options opts;
 
-  /* sanity checks */
-  gdb_assert (threads);
-  gdb_assert (num_threads);
-  *num_threads = 0;
-
   /* make valgrind not complain */
   expected = CUDA_INVALID_COORDS;
 
@@ -1340,16 +1579,17 @@ cuda_info_threads_build (const char *filter_string, cuda_info_thread_t **threads
   filter = cuda_build_filter (filter_string, &default_filter, CMD_FILTER);
 
   /* get the list of threads */
-  iter = cuda_iterator_create (CUDA_ITERATOR_TYPE_THREADS, &filter.coords, CUDA_SELECT_VALID);
-  num_elements = cuda_iterator_get_size (iter);
-  *threads = (cuda_info_thread_t *) xmalloc (num_elements * sizeof (**threads));
+  cuda_iterator_up iter (cuda_iterator_create (CUDA_ITERATOR_TYPE_THREADS, &filter.coords,
+                                               CUDA_SELECT_VALID));
 
-  /* compile the needed info for each block */
-  for (cuda_iterator_start (iter), first_entry = true, i = 0, t = *threads, num_elements = 0;
-       !cuda_iterator_end (iter);
-       cuda_iterator_next (iter), ++i)
+  /* compile the needed info for each thread */
+  for (cuda_iterator_start (iter.get ()), open_range = false;
+       !cuda_iterator_end (iter.get ());
+       cuda_iterator_next (iter.get ()))
     {
-      c  = cuda_iterator_get_current (iter);
+      QUIT;
+
+      c  = cuda_iterator_get_current (iter.get ());
       kernel = kernels_find_kernel_by_grid_id (c.dev, c.gridId);
       pc = lane_get_virtual_pc (c.dev, c.sm, c.wp, c.ln);
 
@@ -1357,7 +1597,7 @@ cuda_info_threads_build (const char *filter_string, cuda_info_thread_t **threads
         continue;
 
       if (pc != prev_pc) /* optimization */
-        sal = find_pc_line (pc, 0);
+        sal = cuda_find_pc_line (pc);
 
       /* data for the current iteration */
       break_of_contiguity =
@@ -1366,46 +1606,53 @@ cuda_info_threads_build (const char *filter_string, cuda_info_thread_t **threads
         (!opts.addressprint && sal.line != prev_sal.line);
 
       /* close the current range */
-      if (!first_entry && (break_of_contiguity || !cuda_options_coalescing ()))
+      if (open_range && (break_of_contiguity || !cuda_options_coalescing ()))
         {
-          t->end_block_idx  = prev_block_idx;
-          t->end_thread_idx = prev_thread_idx;
-          snprintf (t->end_block_idx_string, sizeof (t->end_block_idx_string),
+          t.end_block_idx  = prev_block_idx;
+          t.end_thread_idx = prev_thread_idx;
+          snprintf (t.end_block_idx_string, sizeof (t.end_block_idx_string),
                     "(%u,%u,%u)", prev_block_idx.x, prev_block_idx.y, prev_block_idx.z);
-          snprintf (t->end_thread_idx_string, sizeof (t->end_thread_idx_string),
+          snprintf (t.end_thread_idx_string, sizeof (t.end_thread_idx_string),
                     "(%u,%u,%u)", prev_thread_idx.x, prev_thread_idx.y, prev_thread_idx.z);
-          ++t;
-          ++*num_threads;
+          table.add (std::move (t));
+          open_range = false;
         }
 
       /* start a new range */
-      if (first_entry || break_of_contiguity || !cuda_options_coalescing ())
+      if (!open_range)
         {
-          t->kernel           = kernel;
-          t->current          = false;
-          t->pc               = pc;
-          t->line             = sal.line;
-          t->start_block_idx  = c.blockIdx;
-          t->start_thread_idx = c.threadIdx;
-          t->count            = 0;
-          t->kernel_id        = kernel_get_id (kernel);
-          t->kernel_dim       = kernel_get_dimensions (kernel);
-          t->device           = c.dev;
-          t->sm               = c.sm;
-          t->wp               = c.wp;
-          t->ln               = c.ln;
-          t->filename         = get_filename (sal.symtab);
-
-          snprintf (t->start_block_idx_string, sizeof (t->start_block_idx_string),
+          /* enough rows, do not query the remaining threads */
+          if (table.full ())
+            {
+              table.set_truncated ();
+              break;
+            }
+
+          t.kernel           = kernel;
+          t.current          = false;
+          t.pc               = pc;
+          t.line             = sal.line;
+          t.start_block_idx  = c.blockIdx;
+          t.start_thread_idx = c.threadIdx;
+          t.count            = 0;
+          t.kernel_id        = kernel_get_id (kernel);
+          t.kernel_dim       = kernel_get_dimensions (kernel);
+          t.device           = c.dev;
+          t.sm               = c.sm;
+          t.wp               = c.wp;
+          t.ln               = c.ln;
+          t.filename.reset (get_filename (sal.symtab));
+
+          snprintf (t.start_block_idx_string, sizeof (t.start_block_idx_string),
                     "(%u,%u,%u)", c.blockIdx.x, c.blockIdx.y, c.blockIdx.z);
-          snprintf (t->start_thread_idx_string, sizeof (t->start_thread_idx_string),
+          snprintf (t.start_thread_idx_string, sizeof (t.start_thread_idx_string),
                     "(%u,%u,%u)", c.threadIdx.x, c.threadIdx.y, c.threadIdx.z);
+          open_range = true;
         }
 
       /* update the current range */
-      t->current |= cuda_coords_is_current (&c);
-      ++t->count;
-      first_entry = false;
+      t.current |= cuda_coords_is_current (&c);
+      ++t.count;
 
       /* data for the next iteration */
       prev_pc  = pc;
@@ -1418,247 +1665,397 @@ cuda_info_threads_build (const char *filter_string, cuda_info_thread_t **threads
       expected.threadIdx = c.threadIdx;
       cuda_coords_increment_thread (&expected, kernel_get_grid_dim (kernel),
                                     kernel_get_block_dim (kernel));
-      ++num_elements;
     }
 
   /* close the last range */
-  if (num_elements > 0)
+  if (open_range)
     {
-      t->end_block_idx  = prev_block_idx;
-      t->end_thread_idx = prev_thread_idx;
-      snprintf (t->end_block_idx_string, sizeof (t->end_block_idx_string),
+      t.end_block_idx  = prev_block_idx;
+      t.end_thread_idx = prev_thread_idx;
+      snprintf (t.end_block_idx_string, sizeof (t.end_block_idx_string),
                 "(%u,%u,%u)", prev_block_idx.x, prev_block_idx.y, prev_block_idx.z);
-      snprintf (t->end_thread_idx_string, sizeof (t->end_thread_idx_string),
+      snprintf (t.end_thread_idx_string, sizeof (t.end_thread_idx_string),
                 "(%u,%u,%u)", prev_thread_idx.x, prev_thread_idx.y, prev_thread_idx.z);
-      ++*num_threads;
+      table.add (std::move (t));
     }
+}
 
-  cuda_iterator_destroy (iter);
+void
+info_cuda_threads_command (const char *arg)
+{
+  cuda_info_threads_layout layout;
+  cuda_info_table_stream<cuda_info_threads_layout> table (layout);
+
+  cuda_info_threads_build (arg, table);
+  table.finish ();
 }
 
-static void
-cuda_info_threads_destroy (cuda_info_thread_t *threads, uint32_t num_threads)
+typedef struct {
+  uint64_t       kernel_id;
+  uint64_t       pc;
+  uint32_t       count;
+  gdb::unique_xmalloc_ptr<char> function;
+  gdb::unique_xmalloc_ptr<char> filename;
+  uint32_t       line;
+} cuda_info_pc_t;
+
+static bool
+cuda_info_pc_less (const cuda_info_pc_t &a, const cuda_info_pc_t &b)
 {
-  uint32_t i = 0;
-  cuda_info_thread_t *t = NULL;
+  if (a.kernel_id != b.kernel_id)
+    return a.kernel_id < b.kernel_id;
+  if (a.count != b.count)
+    return a.count > b.count;
+  return a.pc < b.pc;
+}
 
-  for (t = threads, i = 0; i < num_threads; ++i, ++t)
-    xfree (t->filename);
+/* Key of the source line of P, used to merge the entries of a line */
+static std::string
+cuda_info_pc_line_key (const cuda_info_pc_t &p)
+{
+  std::string key = string_printf ("%llu:%u:", (unsigned long long)p.kernel_id, p.line);
 
-  xfree (threads);
+  key += p.function ? p.function.get () : "";
+  key += '\0';
+  key += p.filename ? p.filename.get () : "";
+  return key;
 }
 
+/* Build a histogram of the virtual PCs of all the valid lanes matching the
+   filter. The lanes are visited in a single pass over the physical warps,
+   which reads the state of each warp once, and each distinct PC is only
+   symbolized once. Without address printing, the PCs of the same source
+   line are merged into a single entry. */
 static void
-info_cuda_threads_print_uncoalesced (cuda_info_thread_t *threads, uint32_t num_threads)
+cuda_info_pcs_build (const char *filter_string, std::vector<cuda_info_pc_t> *pcs)
 {
-  cuda_info_thread_t *b;
-  uint32_t i, num_columns;
-  uint64_t kernel_id;
-  struct { size_t current, kernel, block_idx, thread_idx, pc, device, sm, wp, ln, filename, line; } width;
+  cuda_filters_t default_filter, filter;
+  cuda_coords_t c;
+  std::map<std::pair<uint64_t, uint64_t>, uint32_t> counts;
+  struct symtab_and_line sal;
+  struct value_print_options opts;
+  const char *function;
+  cuda_info_pc_t p;
 
-  /* column headers */
-  const char *header_current    = " ";
-  const char *header_kernel     = "Kernel";
-  const char *header_block_idx  = "BlockIdx";
-  const char *header_thread_idx = "ThreadIdx";
-  const char *header_pc         = "Virtual PC";
-  const char *header_device     = "Dev";
-  const char *header_sm         = "SM";
-  const char *header_warp       = "Wp";
-  const char *header_lane       = "Ln";
-  const char *header_filename   = "Filename";
-  const char *header_line       = "Line";
-  struct ui_out *uiout = current_uiout;
+  gdb_assert (pcs);
 
-  /* sanity checks */
-  gdb_assert (!cuda_options_coalescing ());
+  get_user_print_options (&opts);
 
-  /* output message if the list is empty */
-  if (num_threads == 0 && !uiout->is_mi_like_p ())
-    {
-      uiout->field_string (NULL, _("No CUDA threads.\n"));
-      return;
-    }
+  /* get the filter */
+  default_filter = CUDA_WILDCARD_FILTERS;
+  filter = cuda_build_filter (filter_string, &default_filter, CMD_FILTER);
 
-  /* column widths */
-  width.current    = strlen (header_current);
-  width.kernel     = strlen (header_kernel);
-  width.block_idx  = strlen (header_block_idx);
-  width.thread_idx = strlen (header_thread_idx);
-  width.pc         = strlen (header_pc);
-  width.device     = strlen (header_device);
-  width.sm         = strlen (header_sm);
-  width.wp         = strlen (header_warp);
-  width.ln         = strlen (header_lane);
-  width.filename   = strlen (header_filename);
-  width.line       = strlen (header_line);
-
-  for (b = threads, i = 0; i < num_threads; ++i, ++b)
+  /* count the lanes per kernel and virtual PC */
+  {
+    cuda_iterator_up iter (cuda_iterator_create (CUDA_ITERATOR_TYPE_LANES, &filter.coords,
+                                                 CUDA_SELECT_VALID));
+    for (cuda_iterator_start (iter.get ());
+         !cuda_iterator_end (iter.get ());
+         cuda_iterator_next (iter.get ()))
+      {
+        QUIT;
+
+        c = cuda_iterator_get_current (iter.get ());
+        ++counts[std::make_pair (c.kernelId, lane_get_virtual_pc (c.dev, c.sm, c.wp, c.ln))];
+      }
+  }
+
+  /* symbolize each distinct PC */
+  pcs->clear ();
+  for (const auto &entry : counts)
     {
-      width.pc         = std::max (width.pc, (size_t)18);
-      width.block_idx  = std::max (width.block_idx, strlen (b->start_block_idx_string));
-      width.thread_idx = std::max (width.thread_idx, strlen (b->start_thread_idx_string));
-      width.filename   = std::max (width.filename, b->filename ? strlen (b->filename): 0);
-      width.line       = std::max (width.line, (size_t)5);
+      sal = cuda_find_pc_line (entry.first.second);
+      function = cuda_find_function_name_from_pc (entry.first.second, true);
+
+      p.kernel_id = entry.first.first;
+      p.pc        = entry.first.second;
+      p.count     = entry.second;
+      p.function.reset (function ? xstrdup (function) : NULL);
+      p.filename.reset (get_filename (sal.symtab));
+      p.line      = sal.line;
+      pcs->push_back (std::move (p));
     }
 
-  /* print table header ('kernel' is only present in MI output) */
-  num_columns = uiout->is_mi_like_p () ? 11 : 10;
-  ui_out_emit_table table_emitter (uiout, num_columns, num_threads, "UncoalescedInfoCudaThreadsTable");
-  uiout->table_header (width.current   , ui_right, "current"   , header_current);
-  if (uiout->is_mi_like_p ())
-    uiout->table_header (width.kernel  , ui_right, "kernel"    , header_kernel);
-  uiout->table_header (width.block_idx , ui_right, "blockIdx"  , header_block_idx);
-  uiout->table_header (width.thread_idx, ui_right, "threadIdx" , header_thread_idx);
-  uiout->table_header (width.pc        , ui_right, "virtual_pc", header_pc);
-  uiout->table_header (width.device    , ui_right, "device"    , header_device);
-  uiout->table_header (width.sm        , ui_right, "sm"        , header_sm);
-  uiout->table_header (width.wp        , ui_right, "warp"      , header_warp);
-  uiout->table_header (width.ln        , ui_right, "lane"      , header_lane);
-  uiout->table_header (width.filename  , ui_right, "filename"  , header_filename);
-  uiout->table_header (width.line      , ui_right, "line"      , header_line);
-  uiout->table_body ();
-
-  /* print table rows */
-  for (b = threads, i = 0, kernel_id = ~0ULL; i < num_threads; ++i, ++b)
+  /* merge the entries of the same line */
+  if (!opts.addressprint)
     {
-      if (!uiout->is_mi_like_p () && b->kernel_id != kernel_id)
+      std::vector<cuda_info_pc_t> merged;
+      std::unordered_map<std::string, size_t> index;
+
+      for (auto &entry : *pcs)
         {
-          /* row are grouped per kernel only in CLI output */
-          uiout->message ("Kernel %llu\n", (unsigned long long)b->kernel_id),
-          kernel_id = b->kernel_id;
+          auto found = index.emplace (cuda_info_pc_line_key (entry), merged.size ());
+          if (found.second)
+            merged.push_back (std::move (entry));
+          else
+            merged[found.first->second].count += entry.count;
         }
 
-      ui_out_emit_tuple tuple_emitter (uiout, "UncoalescedInfoCudaThreadsRow");
-      uiout->field_string ("current"   , b->current ? "*" : " ");
-      if (uiout->is_mi_like_p ())
-        uiout->field_int  ("kernel"    , b->kernel_id);
-      uiout->field_string ("blockIdx"  , b->start_block_idx_string);
-      uiout->field_string ("threadIdx" , b->start_thread_idx_string);
-      uiout->field_fmt    ("virtual_pc", "0x%016llx", (unsigned long long)b->pc);
-      uiout->field_int    ("device"    , b->device);
-      uiout->field_int    ("sm"        , b->sm);
-      uiout->field_int    ("warp"      , b->wp);
-      uiout->field_int    ("lane"      , b->ln);
-      uiout->field_string ("filename"  , b->filename ? b->filename : "n/a");
-      uiout->field_int    ("line"      , b->line);
-      uiout->text         ("\n");
+      pcs->swap (merged);
     }
+
+  std::sort (pcs->begin (), pcs->end (), cuda_info_pc_less);
 }
 
-static void
-info_cuda_threads_print_coalesced (cuda_info_thread_t *threads, uint32_t num_threads)
+void
+info_cuda_pcs_command (const char *arg)
 {
-  cuda_info_thread_t *b;
-  uint32_t i, num_columns;
+  std::vector<cuda_info_pc_t> pcs;
+  uint32_t num_columns;
   uint64_t kernel_id;
-  struct { size_t current, kernel, start_block_idx, start_thread_idx, end_block_idx,
-      end_thread_idx, count, pc, filename, line; } width;
+  struct value_print_options opts;
+  struct { size_t kernel, count, pc, function, filename, line; } width;
 
   /* column headers */
-  const char *header_current          = " ";
-  const char *header_kernel           = "Kernel";
-  const char *header_start_block_idx  = "BlockIdx";
-  const char *header_start_thread_idx = "ThreadIdx";
-  const char *header_end_block_idx    = "To BlockIdx";
-  const char *header_end_thread_idx   = "ThreadIdx";
-  const char *header_count            = "Count";
-  const char *header_pc               = "Virtual PC";
-  const char *header_filename         = "Filename";
-  const char *header_line             = "Line";
+  const char *header_kernel   = "Kernel";
+  const char *header_count    = "Count";
+  const char *header_pc       = "Virtual PC";
+  const char *header_function = "Function";
+  const char *header_filename = "Filename";
+  const char *header_line     = "Line";
   struct ui_out *uiout = current_uiout;
 
-  /* sanity checks */
-  gdb_assert (cuda_options_coalescing ());
+  get_user_print_options (&opts);
+
+  /* get the information */
+  cuda_info_pcs_build (arg, &pcs);
 
   /* output message if the list is empty */
-  if (num_threads == 0 && !uiout->is_mi_like_p ())
+  if (pcs.empty () && !uiout->is_mi_like_p ())
     {
       uiout->field_string (NULL, _("No CUDA threads.\n"));
       return;
     }
 
   /* column widths */
-  width.current          = strlen (header_current);
-  width.kernel           = strlen (header_kernel);
-  width.start_block_idx  = strlen (header_start_block_idx);
-  width.start_thread_idx = strlen (header_start_thread_idx);
-  width.end_block_idx    = strlen (header_end_block_idx);
-  width.end_thread_idx   = strlen (header_end_thread_idx);
-  width.count            = strlen (header_count);
-  width.pc               = strlen (header_pc);
-  width.filename         = strlen (header_filename);
-  width.line             = strlen (header_line);
-
-  for (b = threads, i = 0; i < num_threads; ++i, ++b)
+  width.kernel   = strlen (header_kernel);
+  width.count    = strlen (header_count);
+  width.pc       = std::max (strlen (header_pc), (size_t)18);
+  width.function = strlen (header_function);
+  width.filename = strlen (header_filename);
+  width.line     = std::max (strlen (header_line), (size_t)5);
+
+  for (const auto &p : pcs)
     {
-      width.pc               = std::max (width.pc, (size_t)18);
-      width.start_block_idx  = std::max (width.start_block_idx, strlen (b->start_block_idx_string));
-      width.start_thread_idx = std::max (width.start_thread_idx, strlen (b->start_thread_idx_string));
-      width.end_block_idx    = std::max (width.end_block_idx, strlen (b->end_block_idx_string));
-      width.end_thread_idx   = std::max (width.end_thread_idx, strlen (b->end_thread_idx_string));
-      width.filename         = std::max (width.filename, b->filename ? strlen (b->filename) : 0);
-      width.line             = std::max (width.line, (size_t)5);
+      width.function = std::max (width.function, p.function ? strlen (p.function.get ()) : 2);
+      width.filename = std::max (width.filename, p.filename ? strlen (p.filename.get ()) : 3);
     }
 
-  /* print table header ('kernel' is only present in MI output) */
-  num_columns = uiout->is_mi_like_p () ? 10 : 9;
-  ui_out_emit_table table_emitter (uiout, num_columns, num_threads, "CoalescedInfoCudaThreadsTable");
-  uiout->table_header (width.current         , ui_right, "current"        , header_current);
-  if (uiout->is_mi_like_p ())
-    uiout->table_header (width.kernel        , ui_right, "kernel"         , header_kernel);
-  uiout->table_header (width.start_block_idx , ui_right, "from_blockIdx"  , header_start_block_idx);
-  uiout->table_header (width.start_thread_idx, ui_right, "from_threadIdx" , header_start_thread_idx);
-  uiout->table_header (width.end_block_idx   , ui_right, "to_blockIdx"    , header_end_block_idx);
-  uiout->table_header (width.end_thread_idx  , ui_right, "to_threadIdx"   , header_end_thread_idx);
-  uiout->table_header (width.count           , ui_right, "count"          , header_count);
-  uiout->table_header (width.pc              , ui_right, "virtual_pc"     , header_pc);
-  uiout->table_header (width.filename        , ui_right, "filename"       , header_filename);
-  uiout->table_header (width.line            , ui_right, "line"           , header_line);
-  uiout->table_body ();
+  {
+    /* print table header ('kernel' is only present in MI output, 'virtual_pc'
+       only when printing addresses) */
+    num_columns = 4 + (uiout->is_mi_like_p () ? 1 : 0) + (opts.addressprint ? 1 : 0);
+    ui_out_emit_table table_emitter (uiout, num_columns, pcs.size (), "InfoCudaPcsTable");
+    if (uiout->is_mi_like_p ())
+      uiout->table_header (width.kernel, ui_right, "kernel"    , header_kernel);
+    uiout->table_header (width.count   , ui_right, "count"     , header_count);
+    if (opts.addressprint)
+      uiout->table_header (width.pc    , ui_right, "virtual_pc", header_pc);
+    uiout->table_header (width.function, ui_left , "function"  , header_function);
+    uiout->table_header (width.filename, ui_right, "filename"  , header_filename);
+    uiout->table_header (width.line    , ui_right, "line"      , header_line);
+    uiout->table_body ();
 
-  /* print table rows */
-  for (b = threads, i = 0, kernel_id = ~0ULL; i < num_threads; ++i, ++b)
+    /* print table rows */
+    kernel_id = ~0ULL;
+    for (const auto &p : pcs)
+      {
+        if (!uiout->is_mi_like_p () && p.kernel_id != kernel_id)
+          {
+            /* row are grouped per kernel only in CLI output */
+            uiout->message ("Kernel %llu\n", (unsigned long long)p.kernel_id);
+            kernel_id = p.kernel_id;
+          }
+
+        ui_out_emit_tuple tuple_emitter (uiout, "InfoCudaPcsRow");
+        if (uiout->is_mi_like_p ())
+          uiout->field_int  ("kernel"    , p.kernel_id);
+        uiout->field_int    ("count"     , p.count);
+        if (opts.addressprint)
+          uiout->field_fmt  ("virtual_pc", "0x%016llx", (unsigned long long)p.pc);
+        uiout->field_string ("function"  , p.function ? p.function.get () : "??");
+        uiout->field_string ("filename"  , p.filename ? p.filename.get () : "n/a");
+        uiout->field_int    ("line"      , p.line);
+        uiout->text         ("\n");
+      }
+  }
+
+  gdb_flush (gdb_stdout);
+}
+
+typedef struct {
+  uint64_t              kernel_id;
+  std::vector<uint64_t> pcs;
+  int32_t               first_level; /* unwinder level of pcs[0], the others
+                                        being return addresses */
+  uint32_t              count;
+  char                  block_idx[32];
+  char                  thread_idx[32];
+} cuda_info_backtrace_t;
+
+/* Collect the call stack of every valid lane matching the filter and group
+   the lanes with identical stacks. The call stacks are read warp by warp
+   and cached in the lane state, so that the unwinder does not query the
+   debugger API again for the lanes later put in focus. */
+static void
+cuda_info_backtraces_build (const char *filter_string,
+                            std::vector<cuda_info_backtrace_t> *backtraces)
+{
+  cuda_filters_t default_filter, filter;
+  cuda_coords_t c, last;
+  std::map<std::tuple<uint64_t, int32_t, std::vector<uint64_t>>, size_t> index;
+  std::vector<uint64_t> pcs;
+  int32_t call_depth, first_level, level;
+
+  gdb_assert (backtraces);
+
+  /* get the filter */
+  default_filter = CUDA_WILDCARD_FILTERS;
+  filter = cuda_build_filter (filter_string, &default_filter, CMD_FILTER);
+
+  backtraces->clear ();
+  memset (&last, 0, sizeof (last));
+  last.valid = false;
+
+  cuda_iterator_up iter (cuda_iterator_create (CUDA_ITERATOR_TYPE_LANES, &filter.coords,
+                                               CUDA_SELECT_VALID));
+  for (cuda_iterator_start (iter.get ());
+       !cuda_iterator_end (iter.get ());
+       cuda_iterator_next (iter.get ()))
     {
-      if (!uiout->is_mi_like_p () && b->kernel_id != kernel_id)
+      QUIT;
+
+      c = cuda_iterator_get_current (iter.get ());
+
+      /* fetch the call stacks of the whole warp at once */
+      if (!last.valid || c.dev != last.dev || c.sm != last.sm || c.wp != last.wp)
         {
-          /* row are grouped per kernel only in CLI output */
-          uiout->message ("Kernel %llu\n", (unsigned long long)b->kernel_id),
-          kernel_id = b->kernel_id;
+          warp_update_call_stacks (c.dev, c.sm, c.wp);
+          last = c;
         }
 
-      ui_out_emit_tuple tuple_emitter (uiout, "CoalescedInfoCudaThreadsRow");
-      uiout->field_string ("current"       , b->current ? "*" : " ");
-      if (uiout->is_mi_like_p ())
-        uiout->field_int  ("kernel"        , b->kernel_id);
-      uiout->field_string ("from_blockIdx" , b->start_block_idx_string);
-      uiout->field_string ("from_threadIdx", b->start_thread_idx_string);
-      uiout->field_string ("to_blockIdx"   , b->end_block_idx_string);
-      uiout->field_string ("to_threadIdx"  , b->end_thread_idx_string);
-      uiout->field_int	  ("count"         , b->count);
-      uiout->field_fmt    ("virtual_pc"    , "0x%016llx", (unsigned long long)b->pc);
-      uiout->field_string ("filename"      , b->filename ? b->filename : "n/a");
-      uiout->field_int	  ("line"          , b->line);
-      uiout->text         ("\n");
+      /* same frames as the unwinder: the virtual PC, then the return
+         addresses, the syscall frames being optionally skipped */
+      call_depth = lane_get_call_depth (c.dev, c.sm, c.wp, c.ln);
+      first_level = cuda_options_hide_internal_frames ()
+                    ? lane_get_syscall_call_depth (c.dev, c.sm, c.wp, c.ln) : 0;
+
+      pcs.clear ();
+      for (level = first_level; level <= call_depth; ++level)
+        pcs.push_back (level == 0
+                       ? lane_get_virtual_pc (c.dev, c.sm, c.wp, c.ln)
+                       : lane_get_virtual_return_address (c.dev, c.sm, c.wp, c.ln,
+                                                          level - 1));
+
+      auto key = std::make_tuple (c.kernelId, first_level, pcs);
+      auto found = index.find (key);
+      if (found != index.end ())
+        {
+          ++(*backtraces)[found->second].count;
+          continue;
+        }
+
+      /* remember the first lane with each call stack */
+      cuda_info_backtrace_t bt;
+      bt.kernel_id   = c.kernelId;
+      bt.pcs         = pcs;
+      bt.first_level = first_level;
+      bt.count       = 1;
+      snprintf (bt.block_idx, sizeof (bt.block_idx), "(%u,%u,%u)",
+                c.blockIdx.x, c.blockIdx.y, c.blockIdx.z);
+      snprintf (bt.thread_idx, sizeof (bt.thread_idx), "(%u,%u,%u)",
+                c.threadIdx.x, c.threadIdx.y, c.threadIdx.z);
+      index.emplace (std::move (key), backtraces->size ());
+      backtraces->push_back (bt);
     }
+
+  /* most common call stacks first, per kernel */
+  std::stable_sort (backtraces->begin (), backtraces->end (),
+                    [] (const cuda_info_backtrace_t &a, const cuda_info_backtrace_t &b)
+                    {
+                      if (a.kernel_id != b.kernel_id)
+                        return a.kernel_id < b.kernel_id;
+                      return a.count > b.count;
+                    });
 }
 
+/* Print the distinct call stacks of the lanes matching the filter, with the
+   number of lanes sharing each of them. Each distinct stack is symbolized
+   once, directly from the PCs, so inlined frames are not expanded. */
 void
-info_cuda_threads_command (const char *arg)
+info_cuda_backtraces_command (const char *arg)
 {
-  cuda_info_thread_t *threads;
-  uint32_t num_threads;
+  std::vector<cuda_info_backtrace_t> backtraces;
+  struct value_print_options opts;
+  struct symtab_and_line sal;
+  const char *function;
+  uint32_t level;
+  struct ui_out *uiout = current_uiout;
+
+  get_user_print_options (&opts);
 
-  cuda_info_threads_build (arg, &threads, &num_threads);
+  /* get the information */
+  cuda_info_backtraces_build (arg, &backtraces);
 
-  if (cuda_options_coalescing ())
-    info_cuda_threads_print_coalesced (threads, num_threads);
-  else
-    info_cuda_threads_print_uncoalesced (threads, num_threads);
+  /* output message if the list is empty */
+  if (backtraces.empty () && !uiout->is_mi_like_p ())
+    {
+      uiout->field_string (NULL, _("No CUDA threads.\n"));
+      return;
+    }
 
-  gdb_flush (gdb_stdout);
+  {
+    ui_out_emit_list list_emitter (uiout, "InfoCudaBacktraces");
+    for (const auto &bt : backtraces)
+      {
+        QUIT;
+
+        ui_out_emit_tuple tuple_emitter (uiout, "InfoCudaBacktrace");
+        uiout->text         ("Kernel ");
+        uiout->field_int    ("kernel"   , bt.kernel_id);
+        uiout->text         (", ");
+        uiout->field_int    ("count"    , bt.count);
+        uiout->text         (bt.count == 1 ? " thread" : " threads");
+        uiout->text         (", first at block ");
+        uiout->field_string ("blockIdx" , bt.block_idx);
+        uiout->text         (" thread ");
+        uiout->field_string ("threadIdx", bt.thread_idx);
+        uiout->text         (":\n");
+
+        ui_out_emit_list frames_emitter (uiout, "frames");
+        for (level = 0; level < bt.pcs.size (); ++level)
+          {
+            /* return addresses are looked up at the call instruction, like
+               find_frame_sal does */
+            sal      = cuda_find_pc_line (bt.first_level + level == 0
+                                          ? bt.pcs[level] : bt.pcs[level] - 1);
+            function = cuda_find_function_name_from_pc (bt.pcs[level], true);
+            gdb::unique_xmalloc_ptr<char> filename (get_filename (sal.symtab));
+
+            ui_out_emit_tuple frame_emitter (uiout, "frame");
+            uiout->text         ("  #");
+            uiout->field_int    ("level", level);
+            uiout->text         ("  ");
+            if (opts.addressprint)
+              {
+                uiout->field_fmt ("addr", "0x%016llx", (unsigned long long)bt.pcs[level]);
+                uiout->text      (" in ");
+              }
+            uiout->field_string ("func" , function ? function : "??");
+            uiout->text         (" ()");
+            if (filename)
+              {
+                uiout->text         (" at ");
+                uiout->field_string ("file", filename.get ());
+                uiout->text         (":");
+                uiout->field_int    ("line", sal.line);
+              }
+            uiout->text         ("\n");
+          }
+      }
+  }
 
-  cuda_info_threads_destroy (threads, num_threads);
+  gdb_flush (gdb_stdout);
 }
 
 typedef struct {
@@ -2303,6 +2700,10 @@ static struct {
              "information about all the active blocks in the current kernel" },
   { "threads",          info_cuda_threads_command,
              "information about all the active threads in the current kernel" },
+  { "pcs",              info_cuda_pcs_command,
+             "histogram of the PCs of all the active threads, per kernel" },
+  { "backtraces",       info_cuda_backtraces_command,
+             "distinct call stacks of all the active threads, per kernel" },
   { "launch trace",     info_cuda_launch_trace_command,
              "information about the parent kernels of the kernel in focus" },
   { "launch children",  info_cuda_launch_children_command,
@@ -2353,6 +2754,9 @@ info_cuda_command (const char *arg, int from_tty)
 }
 
 struct cmd_list_element *cudalist;
+static struct cmd_list_element *cudadumplist;
+static struct cmd_list_element *cudarestorelist;
+static struct cmd_list_element *cudafindlist;
 
 void
 cuda_command_switch (const char *switch_string)
@@ -2520,6 +2924,937 @@ cuda_thread_command (const char *arg, int from_tty)
   cuda_command_all ("thread", arg);
 }
 
+typedef struct {
+  std::string   value;
+  uint32_t      count;
+  char          block_idx[32];
+  char          thread_idx[32];
+} cuda_foreach_value_t;
+
+static bool
+cuda_foreach_value_more_frequent (const cuda_foreach_value_t &a, const cuda_foreach_value_t &b)
+{
+  return a.count > b.count;
+}
+
+/* Split 'cuda foreach' arguments into the optional filter and the
+   expression, separated by a standalone '--'. */
+static const char *
+cuda_foreach_split_args (const char *arg, std::string *filter_string)
+{
+  const char *p;
+
+  for (p = arg; (p = strstr (p, "--")) != NULL; p += 2)
+    if ((p == arg || isspace (p[-1])) && (p[2] == 0 || isspace (p[2])))
+      {
+        filter_string->assign (arg, p - arg);
+        return skip_spaces (p + 2);
+      }
+
+  filter_string->clear ();
+  return arg;
+}
+
+/* Walk over the valid lanes matching a filter, putting each of them in
+   focus. The iterator is destroyed and the original focus restored when
+   the walk goes out of scope, including on error or interrupt. */
+class cuda_foreach_walk
+{
+public:
+  explicit cuda_foreach_walk (cuda_coords_t *filter)
+  {
+    cuda_focus_init (&m_focus);
+    cuda_focus_save (&m_focus);
+    m_iter.reset (cuda_iterator_create (CUDA_ITERATOR_TYPE_LANES, filter, CUDA_SELECT_VALID));
+  }
+
+  ~cuda_foreach_walk ()
+  {
+    m_iter.reset ();
+
+    TRY
+      {
+        cuda_focus_restore (&m_focus);
+      }
+    CATCH (ex, RETURN_MASK_ALL)
+      {
+        /* We're in a dtor, there's really nothing else we can do but
+           ignore the error. */
+      }
+    END_CATCH
+  }
+
+  DISABLE_COPY_AND_ASSIGN (cuda_foreach_walk);
+
+  cuda_iterator get () const
+  {
+    return m_iter.get ();
+  }
+
+private:
+  cuda_focus_t m_focus;
+  cuda_iterator_up m_iter;
+};
+
+/* Once the first lane of a warp was evaluated, read the registers and the
+   local memory it used for all the other lanes of the warp, one backend
+   call per lane. Their evaluations are then served from the caches. */
+static void
+cuda_foreach_prefetch_warp (const cuda_coords_t &c)
+{
+  TRY
+    {
+      warp_prefetch_registers (c.dev, c.sm, c.wp, c.ln);
+      cuda_memcache_prefetch_warp (c.dev, c.sm, c.wp, c.ln);
+    }
+  CATCH (e, RETURN_MASK_ERROR)
+    {
+      /* the lanes read what they need when evaluated */
+    }
+  END_CATCH
+}
+
+/* Evaluate an expression in every valid lane matching the filter and print
+   the distinct values with the number of lanes holding them. Lanes are
+   visited warp by warp. The first lane of each warp is evaluated normally,
+   then the registers and local memory lines it read are fetched for the
+   rest of the warp at once. Shared memory lines are cached per warp, and
+   the expression is only parsed once per distinct PC. */
+static void
+cuda_foreach_command (const char *arg, int from_tty)
+{
+  std::string filter_string;
+  const char *exp;
+  cuda_filters_t default_filter, filter;
+  cuda_coords_t c, last;
+  struct value_print_options opts;
+  std::unordered_map<CORE_ADDR, expression_up> expressions;
+  std::unordered_map<std::string, size_t> index;
+  std::vector<cuda_foreach_value_t> values;
+  uint32_t num_lanes = 0;
+  struct { size_t count, block_idx, thread_idx, value; } width;
+
+  /* column headers */
+  const char *header_count      = "Count";
+  const char *header_block_idx  = "BlockIdx";
+  const char *header_thread_idx = "ThreadIdx";
+  const char *header_value      = "Value";
+  struct ui_out *uiout = current_uiout;
+
+  if (!arg || !*arg)
+    error_no_arg (_("expression"));
+
+  exp = cuda_foreach_split_args (arg, &filter_string);
+  if (!*exp)
+    error_no_arg (_("expression"));
+
+  if (filter_string.empty () && !cuda_focus_is_device ())
+    error (_("Focus is not set on any active CUDA kernel."));
+
+  /* get the filter, the current warp by default */
+  default_filter = CUDA_WILDCARD_FILTERS;
+  default_filter.coords.dev = CUDA_CURRENT;
+  default_filter.coords.sm  = CUDA_CURRENT;
+  default_filter.coords.wp  = CUDA_CURRENT;
+  filter = cuda_build_filter (filter_string.c_str (), &default_filter, CMD_FILTER);
+
+  get_user_print_options (&opts);
+
+  memset (&last, 0, sizeof (last));
+  last.valid = false;
+
+  {
+    /* the original focus is restored once all the lanes are visited */
+    cuda_foreach_walk walk (&filter.coords);
+
+    for (cuda_iterator_start (walk.get ());
+         !cuda_iterator_end (walk.get ());
+         cuda_iterator_next (walk.get ()))
+      {
+        string_file stb;
+        CORE_ADDR pc;
+        CuDim3 block_idx, thread_idx;
+        bool first_in_warp;
+
+        QUIT;
+
+        c  = cuda_iterator_get_current (walk.get ());
+        pc = lane_get_virtual_pc (c.dev, c.sm, c.wp, c.ln);
+
+        first_in_warp = !last.valid || c.dev != last.dev || c.sm != last.sm || c.wp != last.wp;
+        last = c;
+
+        TRY
+          {
+            switch_to_cuda_thread (&c);
+
+            auto it = expressions.find (pc);
+            if (it == expressions.end ())
+              it = expressions.emplace (pc, parse_expression (exp)).first;
+
+            struct value *val = evaluate_expression (it->second.get ());
+            common_val_print (val, &stb, 0, &opts, current_language);
+          }
+        CATCH (e, RETURN_MASK_ERROR)
+          {
+            stb.printf ("<error: %s>", e.message);
+          }
+        END_CATCH
+
+        if (first_in_warp)
+          cuda_foreach_prefetch_warp (c);
+
+        ++num_lanes;
+
+        auto found = index.find (stb.string ());
+        if (found != index.end ())
+          {
+            ++values[found->second].count;
+            continue;
+          }
+
+        /* remember the first lane holding each value */
+        cuda_foreach_value_t v;
+        block_idx  = c.blockIdx;
+        thread_idx = c.threadIdx;
+        v.value = stb.string ();
+        v.count = 1;
+        snprintf (v.block_idx, sizeof (v.block_idx), "(%u,%u,%u)",
+                  block_idx.x, block_idx.y, block_idx.z);
+        snprintf (v.thread_idx, sizeof (v.thread_idx), "(%u,%u,%u)",
+                  thread_idx.x, thread_idx.y, thread_idx.z);
+        index.emplace (v.value, values.size ());
+        values.push_back (std::move (v));
+      }
+  }
+
+  /* output message if the list is empty */
+  if (num_lanes == 0 && !uiout->is_mi_like_p ())
+    {
+      uiout->field_string (NULL, _("No CUDA lanes.\n"));
+      return;
+    }
+
+  /* most frequent values first, lanes order otherwise */
+  std::stable_sort (values.begin (), values.end (), cuda_foreach_value_more_frequent);
+
+  /* column widths */
+  width.count      = strlen (header_count);
+  width.block_idx  = strlen (header_block_idx);
+  width.thread_idx = strlen (header_thread_idx);
+  width.value      = strlen (header_value);
+
+  for (const auto &v : values)
+    {
+      width.block_idx  = std::max (width.block_idx, strlen (v.block_idx));
+      width.thread_idx = std::max (width.thread_idx, strlen (v.thread_idx));
+    }
+
+  {
+    /* print table header (blockIdx and threadIdx are the first lane with
+       the value) */
+    ui_out_emit_table table_emitter (uiout, 4, values.size (), "CudaForeachTable");
+    uiout->table_header (width.count     , ui_right, "count"    , header_count);
+    uiout->table_header (width.block_idx , ui_right, "blockIdx" , header_block_idx);
+    uiout->table_header (width.thread_idx, ui_right, "threadIdx", header_thread_idx);
+    uiout->table_header (width.value     , ui_left , "value"    , header_value);
+    uiout->table_body ();
+
+    /* print table rows */
+    for (const auto &v : values)
+      {
+        ui_out_emit_tuple tuple_emitter (uiout, "CudaForeachRow");
+        uiout->field_int    ("count"    , v.count);
+        uiout->field_string ("blockIdx" , v.block_idx);
+        uiout->field_string ("threadIdx", v.thread_idx);
+        uiout->field_string ("value"    , v.value.c_str ());
+        uiout->text         ("\n");
+      }
+  }
+
+  gdb_flush (gdb_stdout);
+}
+
+/* cuda dump / cuda restore
+
+   Large device buffers are copied in chunks of CUDA_MEMDUMP_CHUNK_SIZE.
+   The backend is only ever called from the main thread, while a worker
+   thread writes (or reads) the file, optionally through zlib, so that
+   the device transfer of one chunk overlaps the file I/O of another.
+   The same commands work on core files, since the reads go through the
+   regular debugger API. */
+
+#define CUDA_MEMDUMP_CHUNK_SIZE   (16U * 1024 * 1024)
+#define CUDA_MEMDUMP_NUM_CHUNKS   4
+#define CUDA_MEMDUMP_PROGRESS     (256ULL * 1024 * 1024)
+
+typedef enum {
+  CUDA_MEMDUMP_GLOBAL,
+  CUDA_MEMDUMP_SHARED,
+} cuda_memdump_space_t;
+
+typedef struct {
+  gdb::byte_vector data;
+  uint32_t len;
+} cuda_memdump_chunk_t;
+
+/* Chunks go round between two queues: the producer fills empty chunks
+   and queues them as full, the consumer drains full chunks and hands
+   them back as empty. Destroying the pipe aborts and joins the worker,
+   so that an error or a Ctrl-C on the main thread does not leave it
+   behind. */
+class cuda_memdump_pipe
+{
+public:
+  cuda_memdump_pipe ()
+  {
+    for (int i = 0; i < CUDA_MEMDUMP_NUM_CHUNKS; ++i)
+      {
+        m_chunks[i].data.resize (CUDA_MEMDUMP_CHUNK_SIZE);
+        m_empty.push_back (&m_chunks[i]);
+      }
+  }
+
+  ~cuda_memdump_pipe ()
+  {
+    abort ();
+    if (m_worker.joinable ())
+      m_worker.join ();
+  }
+
+  template <typename F>
+  void start (F &&worker)
+  {
+    m_worker = std::thread (std::forward<F> (worker));
+  }
+
+  /* Wait for the worker to finish and report its error, if any */
+  void join ()
+  {
+    if (m_worker.joinable ())
+      m_worker.join ();
+    if (!m_error.empty ())
+      error ("%s", m_error.c_str ());
+  }
+
+  /* Take a chunk from the empty (FULL false) or full (FULL true) queue.
+     Returns NULL once the pipe is aborted, or once it is closed and no
+     full chunk is left. */
+  cuda_memdump_chunk_t *pop (bool full)
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+    std::deque<cuda_memdump_chunk_t *> &queue = full ? m_full : m_empty;
+
+    m_cond.wait (lock, [&] { return m_aborted || !queue.empty () || (full && m_closed); });
+    if (m_aborted || queue.empty ())
+      return NULL;
+
+    cuda_memdump_chunk_t *chunk = queue.front ();
+    queue.pop_front ();
+    return chunk;
+  }
+
+  void push (bool full, cuda_memdump_chunk_t *chunk)
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    (full ? m_full : m_empty).push_back (chunk);
+    m_cond.notify_all ();
+  }
+
+  /* The producer has queued its last chunk */
+  void close ()
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_closed = true;
+    m_cond.notify_all ();
+  }
+
+  /* Called by the worker thread, which must not throw */
+  void fail (const char *msg)
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    if (m_error.empty ())
+      m_error = msg;
+    m_aborted = true;
+    m_cond.notify_all ();
+  }
+
+  void abort ()
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_aborted = true;
+    m_cond.notify_all ();
+  }
+
+private:
+  cuda_memdump_chunk_t m_chunks[CUDA_MEMDUMP_NUM_CHUNKS];
+  std::deque<cuda_memdump_chunk_t *> m_empty;
+  std::deque<cuda_memdump_chunk_t *> m_full;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_closed = false;
+  bool m_aborted = false;
+  std::string m_error;
+  std::thread m_worker;
+};
+
+static void
+cuda_memdump_read (cuda_memdump_space_t space, const cuda_coords_t *c,
+                   CORE_ADDR addr, gdb_byte *buf, uint32_t len)
+{
+  if (space == CUDA_MEMDUMP_SHARED)
+    cuda_api_read_shared_memory (c->dev, c->sm, c->wp, addr, buf, len);
+  else
+    cuda_api_read_global_memory (addr, buf, len);
+}
+
+static void
+cuda_memdump_write (cuda_memdump_space_t space, const cuda_coords_t *c,
+                    CORE_ADDR addr, const gdb_byte *buf, uint32_t len)
+{
+  if (space == CUDA_MEMDUMP_SHARED)
+    cuda_api_write_shared_memory (c->dev, c->sm, c->wp, addr, buf, len);
+  else
+    cuda_api_write_global_memory (addr, buf, len);
+}
+
+/* Shared memory is addressed through the warp in focus */
+static void
+cuda_memdump_get_coords (cuda_memdump_space_t space, cuda_coords_t *c)
+{
+  memset (c, 0, sizeof *c);
+  if (space != CUDA_MEMDUMP_SHARED)
+    return;
+
+  if (!cuda_focus_is_device () ||
+      cuda_coords_get_current_physical (&c->dev, &c->sm, &c->wp, &c->ln))
+    error (_("Focus is not set on any active CUDA kernel."));
+}
+
+static void
+cuda_memdump_progress (const char *verb, ULONGEST done, ULONGEST total,
+                       ULONGEST *next_report, int from_tty)
+{
+  if (!from_tty || done < *next_report)
+    return;
+
+  if (total)
+    printf_unfiltered (_("%s %s of %s bytes (%u%%)\n"), verb, pulongest (done),
+                       pulongest (total), (unsigned) (done * 100 / total));
+  else
+    printf_unfiltered (_("%s %s bytes\n"), verb, pulongest (done));
+  gdb_flush (gdb_stdout);
+  *next_report = done + CUDA_MEMDUMP_PROGRESS;
+}
+
+static void
+cuda_memdump_summary (const char *verb, ULONGEST bytes,
+                      std::chrono::steady_clock::time_point start)
+{
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - start;
+  double secs = std::max (elapsed.count (), 1e-6);
+
+  printf_filtered (_("%s %s bytes in %.2f s (%.1f MB/s).\n"), verb, pulongest (bytes),
+                   secs, bytes / secs / (1024 * 1024));
+}
+
+/* cuda dump SPACE [-z] FILE START STOP */
+static void
+cuda_dump_memory (cuda_memdump_space_t space, const char *args, int from_tty)
+{
+  cuda_coords_t c;
+  CORE_ADDR start, stop, addr;
+  ULONGEST next_report = CUDA_MEMDUMP_PROGRESS;
+  bool compress = false;
+  int argi = 0;
+
+  gdb_argv argv (args);
+  if (argv.count () > 0 && strcmp (argv[0], "-z") == 0)
+    {
+      compress = true;
+      ++argi;
+    }
+  if (argv.count () - argi != 3)
+    error (_("Usage: cuda dump %s [-z] FILE START STOP"),
+           space == CUDA_MEMDUMP_SHARED ? "shared" : "global");
+
+  gdb::unique_xmalloc_ptr<char> filename (tilde_expand (argv[argi]));
+  start = parse_and_eval_address (argv[argi + 1]);
+  stop  = parse_and_eval_address (argv[argi + 2]);
+  if (stop <= start)
+    error (_("Invalid memory range [%s, %s)."), paddress (target_gdbarch (), start),
+           paddress (target_gdbarch (), stop));
+
+  cuda_memdump_get_coords (space, &c);
+
+  gzFile file = gzopen (filename.get (), compress ? "wb" : "wbT");
+  if (!file)
+    perror_with_name (filename.get ());
+
+  auto start_time = std::chrono::steady_clock::now ();
+  TRY
+    {
+      cuda_memdump_pipe pipe;
+
+      pipe.start ([&] ()
+        {
+          cuda_memdump_chunk_t *chunk;
+
+          while ((chunk = pipe.pop (true)))
+            {
+              if (gzwrite (file, chunk->data.data (), chunk->len) != (int) chunk->len)
+                {
+                  int errnum;
+                  const char *msg = gzerror (file, &errnum);
+                  pipe.fail (errnum == Z_ERRNO ? safe_strerror (errno) : msg);
+                  return;
+                }
+              pipe.push (false, chunk);
+            }
+        });
+
+      for (addr = start; addr < stop; )
+        {
+          cuda_memdump_chunk_t *chunk;
+
+          QUIT;
+
+          chunk = pipe.pop (false);
+          if (!chunk)
+            break;
+
+          chunk->len = (uint32_t) std::min<ULONGEST> (stop - addr, CUDA_MEMDUMP_CHUNK_SIZE);
+          cuda_memdump_read (space, &c, addr, chunk->data.data (), chunk->len);
+          pipe.push (true, chunk);
+
+          addr += chunk->len;
+          cuda_memdump_progress (_("Dumped"), addr - start, stop - start, &next_report, from_tty);
+        }
+
+      pipe.close ();
+      pipe.join ();
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      gzclose (file);
+      throw_exception (except);
+    }
+  END_CATCH
+
+  if (gzclose (file) != Z_OK)
+    error (_("Failed to write %s."), filename.get ());
+
+  cuda_memdump_summary (_("Dumped"), stop - start, start_time);
+}
+
+/* cuda restore SPACE FILE START */
+static void
+cuda_restore_memory (cuda_memdump_space_t space, const char *args, int from_tty)
+{
+  cuda_coords_t c;
+  CORE_ADDR start, addr;
+  ULONGEST next_report = CUDA_MEMDUMP_PROGRESS;
+
+  gdb_argv argv (args);
+  if (argv.count () != 2)
+    error (_("Usage: cuda restore %s FILE START"),
+           space == CUDA_MEMDUMP_SHARED ? "shared" : "global");
+
+  gdb::unique_xmalloc_ptr<char> filename (tilde_expand (argv[0]));
+  start = parse_and_eval_address (argv[1]);
+
+  cuda_memdump_get_coords (space, &c);
+
+  /* gzread reads uncompressed files as they are */
+  gzFile file = gzopen (filename.get (), "rb");
+  if (!file)
+    perror_with_name (filename.get ());
+  gzbuffer (file, 1024 * 1024);
+
+  auto start_time = std::chrono::steady_clock::now ();
+  addr = start;
+  TRY
+    {
+      cuda_memdump_pipe pipe;
+
+      pipe.start ([&] ()
+        {
+          cuda_memdump_chunk_t *chunk;
+          int len;
+
+          while ((chunk = pipe.pop (false)))
+            {
+              len = gzread (file, chunk->data.data (), CUDA_MEMDUMP_CHUNK_SIZE);
+              if (len < 0)
+                {
+                  int errnum;
+                  const char *msg = gzerror (file, &errnum);
+                  pipe.fail (errnum == Z_ERRNO ? safe_strerror (errno) : msg);
+                  return;
+                }
+              if (len == 0)
+                break;
+              chunk->len = len;
+              pipe.push (true, chunk);
+            }
+          pipe.close ();
+        });
+
+      /* Device memory is about to change under the caches */
+      cuda_memcache_invalidate ();
+      target_dcache_invalidate ();
+
+      cuda_memdump_chunk_t *chunk;
+      while ((chunk = pipe.pop (true)))
+        {
+          QUIT;
+
+          cuda_memdump_write (space, &c, addr, chunk->data.data (), chunk->len);
+          addr += chunk->len;
+          pipe.push (false, chunk);
+
+          cuda_memdump_progress (_("Restored"), addr - start, 0, &next_report, from_tty);
+        }
+
+      pipe.join ();
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      gzclose (file);
+      throw_exception (except);
+    }
+  END_CATCH
+
+  gzclose (file);
+  cuda_memdump_summary (_("Restored"), addr - start, start_time);
+}
+
+/* cuda find
+
+   Same syntax as find, but reads the device memory space directly in
+   large chunks and matches on the host: memmem for byte patterns, and
+   a block-wise exponent test, which the compiler vectorizes, for the
+   NaN/Inf scans (/f for float, /d for double elements). */
+
+typedef struct {
+  char size;               /* b, h, w, g, or 0 to use the value types */
+  char scan;               /* f or d for NaN/Inf scans, 0 otherwise */
+  ULONGEST max_count;
+  CORE_ADDR start;
+  ULONGEST len;
+  gdb::byte_vector pattern;
+} cuda_find_args_t;
+
+static void
+cuda_find_parse_args (const char *args, cuda_find_args_t *fa)
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (get_current_arch ());
+  const char *s = args;
+  struct value *v;
+
+  fa->size = 0;
+  fa->scan = 0;
+  fa->max_count = ~(ULONGEST) 0;
+
+  if (args == NULL)
+    error (_("Missing search parameters."));
+
+  while (*s == '/')
+    {
+      ++s;
+      while (*s != '\0' && *s != '/' && !isspace (*s))
+        {
+          if (isdigit (*s))
+            {
+              fa->max_count = atoi (s);
+              while (isdigit (*s))
+                ++s;
+              continue;
+            }
+          switch (*s)
+            {
+            case 'b': case 'h': case 'w': case 'g':
+              fa->size = *s++;
+              break;
+            case 'f': case 'd':
+              fa->scan = *s++;
+              break;
+            default:
+              error (_("Invalid size granularity."));
+            }
+        }
+      s = skip_spaces (s);
+    }
+
+  /* search range */
+  v = parse_to_comma_and_eval (&s);
+  fa->start = value_as_address (v);
+  if (*s == ',')
+    ++s;
+  s = skip_spaces (s);
+
+  if (*s == '+')
+    {
+      LONGEST len;
+
+      ++s;
+      v = parse_to_comma_and_eval (&s);
+      len = value_as_long (v);
+      if (len <= 0)
+        error (_("Invalid length."));
+      if (fa->start + len - 1 < fa->start)
+        error (_("Search space too large."));
+      fa->len = len;
+    }
+  else
+    {
+      CORE_ADDR end;
+
+      v = parse_to_comma_and_eval (&s);
+      end = value_as_address (v);
+      if (fa->start > end)
+        error (_("Invalid search space, end precedes start."));
+      fa->len = end - fa->start + 1;
+      if (fa->len == 0)
+        error (_("Overflow in address range computation, choose smaller range."));
+    }
+  if (*s == ',')
+    ++s;
+
+  /* search pattern */
+  fa->pattern.clear ();
+  while (*s != '\0')
+    {
+      s = skip_spaces (s);
+      v = parse_to_comma_and_eval (&s);
+
+      if (fa->size)
+        {
+          int n = fa->size == 'b' ? 1 : fa->size == 'h' ? 2 : fa->size == 'w' ? 4 : 8;
+          gdb_byte bytes[8];
+
+          store_unsigned_integer (bytes, n, byte_order, value_as_long (v));
+          fa->pattern.insert (fa->pattern.end (), bytes, bytes + n);
+        }
+      else
+        {
+          const gdb_byte *contents = value_contents (v);
+          fa->pattern.insert (fa->pattern.end (), contents,
+                              contents + TYPE_LENGTH (value_type (v)));
+        }
+
+      if (*s == ',')
+        ++s;
+      s = skip_spaces (s);
+    }
+
+  if (fa->scan && !fa->pattern.empty ())
+    error (_("A NaN/Inf search takes no pattern."));
+  if (!fa->scan && fa->pattern.empty ())
+    error (_("Missing search pattern."));
+  if (fa->len < std::max<ULONGEST> (fa->pattern.size (), fa->scan == 'd' ? 8 : 4))
+    error (_("Search space too small to contain pattern."));
+}
+
+/* Return the offsets in [0, LEN) of the ELEM_SIZE aligned elements of
+   BUF whose exponent bits are all set (NaN or Inf), up to MAX_COUNT of
+   them. BUF must be ELEM_SIZE aligned in the target address space. */
+template <typename T>
+static void
+cuda_find_nonfinite (const gdb_byte *buf, size_t len, T exp_mask,
+                     ULONGEST max_count, std::vector<size_t> *found)
+{
+  const size_t block = 16;
+  size_t n = len / sizeof (T);
+  size_t i = 0;
+
+  while (i < n && found->size () < max_count)
+    {
+      /* Cheap test of a whole block first */
+      size_t end = std::min (n, i + block);
+      T elem[block];
+      bool any = false;
+
+      memcpy (elem, buf + i * sizeof (T), (end - i) * sizeof (T));
+      for (size_t j = 0; j < end - i; ++j)
+        any |= (elem[j] & exp_mask) == exp_mask;
+
+      if (any)
+        for (size_t j = 0; j < end - i && found->size () < max_count; ++j)
+          if ((elem[j] & exp_mask) == exp_mask)
+            found->push_back ((i + j) * sizeof (T));
+
+      i = end;
+    }
+}
+
+static void
+cuda_find_memory (cuda_memdump_space_t space, const char *args, int from_tty)
+{
+  struct gdbarch *gdbarch = get_current_arch ();
+  cuda_find_args_t fa;
+  cuda_coords_t c;
+  unsigned int found_count = 0;
+  CORE_ADDR last_found = 0, addr, end;
+  size_t elem_size, keep;
+
+  cuda_find_parse_args (args, &fa);
+  cuda_memdump_get_coords (space, &c);
+
+  elem_size = fa.scan == 'd' ? 8 : fa.scan == 'f' ? 4 : 1;
+  end = fa.start + fa.len;
+
+  /* NaN/Inf scans only look at naturally aligned elements */
+  addr = (fa.start + elem_size - 1) & ~(CORE_ADDR) (elem_size - 1);
+
+  /* A match may straddle two chunks: keep the tail of the previous one */
+  keep = fa.scan ? 0 : fa.pattern.size () - 1;
+  gdb::byte_vector buf (CUDA_MEMDUMP_CHUNK_SIZE + keep);
+  size_t have = 0;
+
+  while (addr < end && found_count < fa.max_count)
+    {
+      std::vector<size_t> found;
+      uint32_t len;
+      CORE_ADDR base;
+
+      QUIT;
+
+      len = (uint32_t) std::min<ULONGEST> (end - addr, CUDA_MEMDUMP_CHUNK_SIZE);
+      cuda_memdump_read (space, &c, addr, buf.data () + have, len);
+      base = addr - have;
+      have += len;
+
+      if (fa.scan == 'f')
+        cuda_find_nonfinite<uint32_t> (buf.data (), have, 0x7f800000U,
+                                       fa.max_count - found_count, &found);
+      else if (fa.scan == 'd')
+        cuda_find_nonfinite<uint64_t> (buf.data (), have, 0x7ff0000000000000ULL,
+                                       fa.max_count - found_count, &found);
+      else
+        {
+          const gdb_byte *p = buf.data ();
+          const gdb_byte *limit = buf.data () + have;
+
+          while (found.size () < fa.max_count - found_count &&
+                 (p = (const gdb_byte *) memmem (p, limit - p, fa.pattern.data (),
+                                                 fa.pattern.size ())) != NULL)
+            {
+              found.push_back (p - buf.data ());
+              ++p;
+            }
+        }
+
+      for (size_t off : found)
+        {
+          last_found = base + off;
+          printf_filtered ("%s", paddress (gdbarch, last_found));
+          if (fa.scan)
+            {
+              bool is_nan;
+              bool negative = buf[off + elem_size - 1] & 0x80;
+
+              if (elem_size == 4)
+                {
+                  uint32_t bits;
+                  memcpy (&bits, &buf[off], sizeof bits);
+                  is_nan = (bits & 0x007fffffU) != 0;
+                }
+              else
+                {
+                  uint64_t bits;
+                  memcpy (&bits, &buf[off], sizeof bits);
+                  is_nan = (bits & 0x000fffffffffffffULL) != 0;
+                }
+              printf_filtered (" %s", is_nan ? "nan" : negative ? "-inf" : "inf");
+            }
+          printf_filtered ("\n");
+          ++found_count;
+        }
+
+      addr += len;
+
+      /* Carry the bytes a straddling match could start in */
+      if (keep)
+        {
+          size_t tail = std::min (keep, have);
+          memmove (buf.data (), buf.data () + have - tail, tail);
+          have = tail;
+        }
+      else
+        have = 0;
+    }
+
+  set_internalvar_integer (lookup_internalvar ("numfound"), found_count);
+  if (found_count > 0)
+    {
+      struct type *ptr_type = builtin_type (gdbarch)->builtin_data_ptr;
+
+      set_internalvar (lookup_internalvar ("_"),
+                       value_from_pointer (ptr_type, last_found));
+    }
+
+  if (found_count == 0)
+    printf_filtered (_("Pattern not found.\n"));
+  else
+    printf_filtered (_("%d pattern%s found.\n"), found_count,
+                     found_count > 1 ? "s" : "");
+}
+
+static void
+cuda_find_global_command (const char *args, int from_tty)
+{
+  cuda_find_memory (CUDA_MEMDUMP_GLOBAL, args, from_tty);
+}
+
+static void
+cuda_find_shared_command (const char *args, int from_tty)
+{
+  cuda_find_memory (CUDA_MEMDUMP_SHARED, args, from_tty);
+}
+
+static void
+cuda_find_command (const char *arg, int from_tty)
+{
+  error (_("\"cuda find\" must be followed by a memory space: global or shared."));
+}
+
+static void
+cuda_dump_global_command (const char *args, int from_tty)
+{
+  cuda_dump_memory (CUDA_MEMDUMP_GLOBAL, args, from_tty);
+}
+
+static void
+cuda_dump_shared_command (const char *args, int from_tty)
+{
+  cuda_dump_memory (CUDA_MEMDUMP_SHARED, args, from_tty);
+}
+
+static void
+cuda_restore_global_command (const char *args, int from_tty)
+{
+  cuda_restore_memory (CUDA_MEMDUMP_GLOBAL, args, from_tty);
+}
+
+static void
+cuda_restore_shared_command (const char *args, int from_tty)
+{
+  cuda_restore_memory (CUDA_MEMDUMP_SHARED, args, from_tty);
+}
+
+static void
+cuda_dump_command (const char *arg, int from_tty)
+{
+  error (_("\"cuda dump\" must be followed by a memory space: global or shared."));
+}
+
+static void
+cuda_restore_command (const char *arg, int from_tty)
+{
+  error (_("\"cuda restore\" must be followed by a memory space: global or shared."));
+}
+
 static void
 cuda_command (const char *arg, int from_tty)
 {
@@ -2606,6 +3941,65 @@ cuda_commands_initialize (void)
   add_cmd ("thread", no_class, cuda_thread_command,
            _("Print or select the current CUDA thread."), &cudalist);
 
+  add_cmd ("foreach", no_class, cuda_foreach_command,
+           _("Evaluate an expression in every lane matching a filter.\n\
+Usage: cuda foreach [FILTER --] EXPRESSION\n\
+FILTER uses the syntax of the info cuda commands, e.g. 'block (1,0,0)',\n\
+and defaults to the current warp. The distinct values are printed with the\n\
+number of lanes holding them and the first of those lanes."), &cudalist);
+
+  add_prefix_cmd ("dump", no_class, cuda_dump_command,
+                  _("Copy CUDA device memory to a file."),
+                  &cudadumplist, "cuda dump ", 0, &cudalist);
+
+  add_cmd ("global", no_class, cuda_dump_global_command,
+           _("Copy global memory to a file.\n\
+Usage: cuda dump global [-z] FILE START STOP\n\
+Copies the global (or managed) memory in [START, STOP) to FILE, which is\n\
+compressed with zlib if -z is given. Also works on CUDA core files."), &cudadumplist);
+
+  add_cmd ("shared", no_class, cuda_dump_shared_command,
+           _("Copy shared memory to a file.\n\
+Usage: cuda dump shared [-z] FILE START STOP\n\
+Copies the shared memory of the block in focus in [START, STOP) to FILE,\n\
+which is compressed with zlib if -z is given."), &cudadumplist);
+
+  add_prefix_cmd ("restore", no_class, cuda_restore_command,
+                  _("Copy the contents of a file to CUDA device memory."),
+                  &cudarestorelist, "cuda restore ", 0, &cudalist);
+
+  add_cmd ("global", no_class, cuda_restore_global_command,
+           _("Copy the contents of a file to global memory.\n\
+Usage: cuda restore global FILE START\n\
+FILE may be compressed with zlib (as written by cuda dump -z)."), &cudarestorelist);
+
+  add_cmd ("shared", no_class, cuda_restore_shared_command,
+           _("Copy the contents of a file to shared memory.\n\
+Usage: cuda restore shared FILE START\n\
+Writes to the shared memory of the block in focus. FILE may be compressed\n\
+with zlib (as written by cuda dump -z)."), &cudarestorelist);
+
+  add_prefix_cmd ("find", no_class, cuda_find_command,
+                  _("Search CUDA device memory."),
+                  &cudafindlist, "cuda find ", 0, &cudalist);
+
+  add_cmd ("global", no_class, cuda_find_global_command,
+           _("Search global memory for a sequence of bytes or for NaN/Inf values.\n\
+Usage: cuda find global [/SIZE-CHAR] [/MAX-COUNT] START, END|+LENGTH, EXPR1 [, EXPR2 ...]\n\
+       cuda find global /f|/d [/MAX-COUNT] START, END|+LENGTH\n\
+The pattern and the options are the same as for the find command. With /f\n\
+or /d, aligned float or double elements holding NaN or Inf are reported\n\
+instead. The memory is read in large chunks straight from the device.\n\
+The number of matches is stored in $numfound and the last match in $_."),
+           &cudafindlist);
+
+  add_cmd ("shared", no_class, cuda_find_shared_command,
+           _("Search shared memory for a sequence of bytes or for NaN/Inf values.\n\
+Usage: cuda find shared [/SIZE-CHAR] [/MAX-COUNT] START, END|+LENGTH, EXPR1 [, EXPR2 ...]\n\
+       cuda find shared /f|/d [/MAX-COUNT] START, END|+LENGTH\n\
+Same as cuda find global, for the shared memory of the block in focus."),
+           &cudafindlist);
+
   cuda_build_info_cuda_help_message ();
   cmd = add_info ("cuda", info_cuda_command, cuda_info_cmd_help_str);
   set_cmd_completer (cmd, cuda_info_command_completer);
@@ -30,6 +30,8 @@ void info_cuda_kernels_command         (const char *arg);
 void info_cuda_contexts_command        (const char *arg);
 void info_cuda_blocks_command          (const char *arg);
 void info_cuda_threads_command         (const char *arg);
+void info_cuda_pcs_command             (const char *arg);
+void info_cuda_backtraces_command      (const char *arg);
 void info_cuda_launch_trace_command    (const char *arg);
 void info_cuda_launch_children_command (const char *arg);
 
@@ -135,12 +135,55 @@ context_remove_context_from_list (context_t context, list_elt_t *list_head)
  *
  *****************************************************************************/
 
+/* Entry of the host thread id to context stack index hash table */
+struct ctxtid_entry_st {
+  uint32_t tid;
+  uint32_t ctxtid;
+};
+
+static hashval_t
+context_id_hash (const void *p)
+{
+  const struct context_st *context = (const struct context_st *) p;
+
+  return iterative_hash_object (context->context_id, 0);
+}
+
+static int
+context_id_eq (const void *a, const void *b)
+{
+  const struct context_st *context_a = (const struct context_st *) a;
+  const struct context_st *context_b = (const struct context_st *) b;
+
+  return context_a->context_id == context_b->context_id;
+}
+
+static hashval_t
+ctxtid_entry_hash (const void *p)
+{
+  const struct ctxtid_entry_st *entry = (const struct ctxtid_entry_st *) p;
+
+  return entry->tid;
+}
+
+static int
+ctxtid_entry_eq (const void *a, const void *b)
+{
+  const struct ctxtid_entry_st *entry_a = (const struct ctxtid_entry_st *) a;
+  const struct ctxtid_entry_st *entry_b = (const struct ctxtid_entry_st *) b;
+
+  return entry_a->tid == entry_b->tid;
+}
+
 contexts_t
 contexts_new (void)
 {
   contexts_t contexts;
 
   contexts = (contexts_t) xcalloc (1, sizeof *contexts);
+  contexts->by_id = htab_create (16, context_id_hash, context_id_eq, NULL);
+  contexts->ctxtid_by_tid = htab_create (16, ctxtid_entry_hash, ctxtid_entry_eq,
+                                         xfree);
 
   return contexts;
 }
@@ -170,6 +213,8 @@ contexts_delete (contexts_t ctx)
 
   xfree (ctx->stacks);
   xfree (ctx->ctxtid_to_tid);
+  htab_delete (ctx->by_id);
+  htab_delete (ctx->ctxtid_by_tid);
 }
 
 void
@@ -204,23 +249,21 @@ contexts_add_context (contexts_t ctx, context_t context)
   /* Add the element at the head of the list */
   ctx->list = elt;
   ctx->list_size++;
+
+  /* The most recent context wins, as it would have been found first */
+  *htab_find_slot (ctx->by_id, context, INSERT) = context;
 }
 
 static list_elt_t * 
 contexts_find_stack_by_tid (contexts_t ctx, uint32_t tid)
 {
-  uint32_t ctxtid;
-  bool     found = false;
+  struct ctxtid_entry_st key, *entry;
 
-  for (ctxtid = 0; ctxtid < ctx->num_ctxtids; ++ctxtid)
-    if (tid == ctx->ctxtid_to_tid[ctxtid])
-      {
-        found = true;
-        break;
-      }
-  
-  if (found)
-    return &ctx->stacks[ctxtid];
+  key.tid = tid;
+  entry = (struct ctxtid_entry_st *) htab_find (ctx->ctxtid_by_tid, &key);
+
+  if (entry)
+    return &ctx->stacks[entry->ctxtid];
   else
     return NULL;
 }
@@ -230,6 +273,8 @@ contexts_remove_context (contexts_t ctx, context_t context)
 {
   uint32_t ctxtid;
   context_t removed_context = context;
+  list_elt_t elt;
+  void **slot;
 
   gdb_assert (ctx);
 
@@ -247,6 +292,19 @@ contexts_remove_context (contexts_t ctx, context_t context)
   context_remove_context_from_list (context, &ctx->list);
   ctx->list_size--;
 
+  slot = htab_find_slot (ctx->by_id, context, NO_INSERT);
+  if (slot && *slot == context)
+    {
+      htab_clear_slot (ctx->by_id, slot);
+      /* Index another context with the same id, if any */
+      for (elt = ctx->list; elt; elt = elt->next)
+        if (context_get_id (elt->context) == context_get_id (context))
+          {
+            *htab_find_slot (ctx->by_id, elt->context, INSERT) = elt->context;
+            break;
+          }
+    }
+
   return context;
 }
 
@@ -254,6 +312,7 @@ static void
 contexts_add_stack_for_tid (contexts_t ctx, uint32_t tid)
 {
   uint32_t ctxtid;
+  struct ctxtid_entry_st *entry;
 
   ctxtid = ctx->num_ctxtids++;
 
@@ -264,6 +323,11 @@ contexts_add_stack_for_tid (contexts_t ctx, uint32_t tid)
 
   ctx->stacks[ctxtid] = NULL; 
   ctx->ctxtid_to_tid[ctxtid] = tid;
+
+  entry = XNEW (struct ctxtid_entry_st);
+  entry->tid = tid;
+  entry->ctxtid = ctxtid;
+  *htab_find_slot (ctx->ctxtid_by_tid, entry, INSERT) = entry;
 }
 
 void
@@ -329,17 +393,13 @@ contexts_unstack_context (contexts_t ctx, uint32_t tid)
 context_t
 contexts_find_context_by_id  (contexts_t ctx, uint64_t context_id)
 {
-  list_elt_t elt;
+  struct context_st key;
 
   gdb_assert (ctx);
 
-  /* Look for the context in the context list */
-  for (elt = ctx->list; elt; elt = elt->next)
-    if (context_get_id (elt->context) == context_id)
-      return elt->context;
-
-  /* Return NULL if not found */
-  return NULL;
+  /* Look for the context in the context index */
+  key.context_id = context_id;
+  return (context_t) htab_find (ctx->by_id, &key);
 }
 
 context_t
@@ -358,8 +418,7 @@ contexts_get_active_context (contexts_t ctx, uint32_t tid)
   return (*stack)->context;
 }
 
-/* expensive: traverse all the objfiles to see if addr corresponds to
-   any of them. Return the context if found, 0 otherwise. */
+/* Return the context whose modules contain addr if found, 0 otherwise. */
 context_t
 contexts_find_context_by_address (contexts_t ctx, CORE_ADDR addr)
 {
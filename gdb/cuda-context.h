@@ -19,6 +19,7 @@
 #define _CUDA_CONTEXT_H 1
 
 #include "defs.h"
+#include "hashtab.h"
 #include "cuda-defs.h"
 
 
@@ -81,6 +82,8 @@ struct contexts_st {
   uint32_t    list_size;            /* size of the context list */
   list_elt_t  list;                 /* list of all contexts on the device */
   list_elt_t *stacks;               /* context stacks for each host thread */
+  htab_t      by_id;                /* contexts indexed by context id */
+  htab_t      ctxtid_by_tid;        /* stack indexes indexed by host thread id */
 };
 
 #endif
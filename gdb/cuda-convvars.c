@@ -33,6 +33,10 @@
 #include "cuda-utils.h"
 #include "cuda-convvars.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 
 /* To update the convenience variable error code for api_failures.
  * cuda_get_last_driver_api_error_code and cuda_get_last_driver_api_error_func_name
@@ -96,12 +100,86 @@ cuda_convenience_convert_to_kernel_id_array_value (uint64_t *kernels,
   return kernel_id_array_value;
 }
 
+/* Present kernels and their blocks, computed on first access after each
+   stop (see cuda_clock). */
+static struct {
+  bool valid;
+  cuda_clock_t clock;
+  std::vector<uint64_t> kernels;
+  std::vector<std::vector<CuDim3>> blocks;
+  uint32_t max_blocks;
+} cv_present;
+
+static bool
+cv_block_idx_less (const CuDim3 &a, const CuDim3 &b)
+{
+  if (a.x != b.x)
+    return a.x < b.x;
+  if (a.y != b.y)
+    return a.y < b.y;
+  return a.z < b.z;
+}
+
+static bool
+cv_block_idx_equal (const CuDim3 &a, const CuDim3 &b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+/* Collect the present blocks of every kernel in a single pass over the
+   valid warps, in the order of the KERNELS and BLOCKS iterators. */
+static void
+cv_present_update (void)
+{
+  std::map<uint64_t, std::vector<CuDim3>> per_kernel;
+  uint32_t dev_id, sm_id, wp_id;
+  kernel_t kernel;
+
+  if (cv_present.valid && cv_present.clock == cuda_clock ())
+    return;
+
+  for (dev_id = 0; dev_id < cuda_system_get_num_devices (); ++dev_id)
+    for (sm_id = 0; sm_id < device_get_num_sms (dev_id); ++sm_id)
+      for (wp_id = 0; wp_id < device_get_num_warps (dev_id); ++wp_id)
+        {
+          if (!warp_is_valid (dev_id, sm_id, wp_id))
+            continue;
+
+          kernel = warp_get_kernel (dev_id, sm_id, wp_id);
+          if (!kernel)
+            continue;
+
+          per_kernel[kernel_get_id (kernel)].push_back (warp_get_block_idx (dev_id, sm_id, wp_id));
+        }
+
+  cv_present.kernels.clear ();
+  cv_present.blocks.clear ();
+  cv_present.max_blocks = 0;
+
+  for (auto &entry : per_kernel)
+    {
+      std::vector<CuDim3> &blocks = entry.second;
+
+      std::sort (blocks.begin (), blocks.end (), cv_block_idx_less);
+      blocks.erase (std::unique (blocks.begin (), blocks.end (), cv_block_idx_equal),
+                    blocks.end ());
+
+      cv_present.max_blocks = std::max (cv_present.max_blocks, (uint32_t) blocks.size ());
+      cv_present.kernels.push_back (entry.first);
+      cv_present.blocks.push_back (std::move (blocks));
+    }
+
+  cv_present.clock = cuda_clock ();
+  cv_present.valid = true;
+}
+
 static struct value *
-cuda_convenience_convert_to_block_idx_array_value (CuDim3 **blocks,
-                                                   uint32_t num_kernels,
-                                                   uint32_t max_blocks)
+cuda_convenience_convert_to_block_idx_array_value (void)
 {
   struct type *type_uint32 = builtin_type (get_current_arch ())->builtin_uint32;
+  CuDim3 invalid_blockIdx = (CuDim3) { CUDA_INVALID, CUDA_INVALID, CUDA_INVALID };
+  uint32_t num_kernels = cv_present.kernels.size ();
+  uint32_t max_blocks = cv_present.max_blocks;
   struct value **kernel_block_idx_array_value;
   struct value *block_idx_array_value;
   struct value **block_idx_values;
@@ -115,9 +193,10 @@ cuda_convenience_convert_to_block_idx_array_value (CuDim3 **blocks,
     {
       block_idx_values = (struct value **) xmalloc (max_blocks * sizeof (*block_idx_values));
 
+      /* every kernel has max_blocks entries, padded with invalid ones */
       for (j = 0; j < max_blocks; j++)
       {
-        blockIdx = blocks[i][j];
+        blockIdx = j < cv_present.blocks[i].size () ? cv_present.blocks[i][j] : invalid_blockIdx;
         block_idx_value[0] = (struct value *) value_from_longest (type_uint32, (LONGEST) blockIdx.x);
         block_idx_value[1] = (struct value *) value_from_longest (type_uint32, (LONGEST) blockIdx.y);
         block_idx_value[2] = (struct value *) value_from_longest (type_uint32, (LONGEST) blockIdx.z);
@@ -134,100 +213,61 @@ cuda_convenience_convert_to_block_idx_array_value (CuDim3 **blocks,
   return block_idx_array_value;
 }
 
-/* This function creates array values of present blocks and kernel IDs and
-   returns a number of active kernels */
-static uint32_t
-cuda_convenience_get_present_blocks_kernels(struct value **kernel_id_array_value,
-                                            struct value **block_idx_array_value)
+static struct value *
+cv_make_empty_array_value (struct gdbarch *gdbarch)
 {
-  struct type *type_uint32 = builtin_type (get_current_arch ())->builtin_uint32;
-  struct type *type_array = lookup_array_range_type (type_uint32, 1, 0);
-  CuDim3 invalid_blockIdx = (CuDim3) { CUDA_INVALID, CUDA_INVALID, CUDA_INVALID };
-
-  cuda_coords_t c, filter;
-  cuda_iterator block_iter, kernel_iter;
-  uint32_t num_blocks, max_blocks, num_kernels;
-  uint64_t kernel_id, i, j;
+  struct type *type_uint32 = builtin_type (gdbarch)->builtin_uint32;
 
-  CuDim3 **blocks;
-  uint64_t *kernels;
-
-  gdb_assert (kernel_id_array_value);
-  gdb_assert (block_idx_array_value);
-
-  /* compute num kernels and max blocks across all the kernels */
-  max_blocks = 0;
-  filter = CUDA_WILDCARD_COORDS;
-  kernel_iter = cuda_iterator_create (CUDA_ITERATOR_TYPE_KERNELS, &filter, CUDA_SELECT_VALID);
-  num_kernels = cuda_iterator_get_size (kernel_iter);
-  for (cuda_iterator_start (kernel_iter); !cuda_iterator_end (kernel_iter); cuda_iterator_next (kernel_iter))
-    {
-      c  = cuda_iterator_get_current (kernel_iter);
-      kernel_id = c.kernelId;
-
-      filter = CUDA_WILDCARD_COORDS;
-      filter.kernelId = kernel_id;
-      block_iter = cuda_iterator_create (CUDA_ITERATOR_TYPE_BLOCKS, &filter, CUDA_SELECT_VALID);
-      num_blocks = cuda_iterator_get_size (block_iter);
-      max_blocks = num_blocks > max_blocks ? num_blocks : max_blocks;
-      cuda_iterator_destroy (block_iter);
-    }
-  cuda_iterator_destroy (kernel_iter);
-
-  /* if no block or kernel, then return empty arrays */
-  if (max_blocks == 0)
-    {
-      *kernel_id_array_value = allocate_value (type_array);
-      *block_idx_array_value = allocate_value (type_array);
-      return 0;
-    }
-
-  /* fill up kernels and blocks */
-  kernels = (uint64_t *) xmalloc (num_kernels * sizeof(*kernels));
-  blocks  = (CuDim3 **) xmalloc (num_kernels * sizeof(*blocks));
+  return allocate_value (lookup_array_range_type (type_uint32, 1, 0));
+}
 
-  i = 0;
-  filter = CUDA_WILDCARD_COORDS;
-  kernel_iter = cuda_iterator_create (CUDA_ITERATOR_TYPE_KERNELS, &filter, CUDA_SELECT_VALID);
-  for (cuda_iterator_start (kernel_iter); !cuda_iterator_end (kernel_iter); cuda_iterator_next (kernel_iter))
-    {
-      c  = cuda_iterator_get_current (kernel_iter);
-      kernel_id = c.kernelId;
-
-      kernels[i] = kernel_id;
-      blocks[i]  = (CuDim3 *) xmalloc (max_blocks * sizeof(**blocks)); // max_blocks, yes.
-      for (j = 0; j < max_blocks; ++j)
-        blocks[i][j] = invalid_blockIdx;
-
-      j = 0;
-      filter = CUDA_WILDCARD_COORDS;
-      filter.kernelId = kernel_id;
-      block_iter = cuda_iterator_create (CUDA_ITERATOR_TYPE_BLOCKS, &filter, CUDA_SELECT_VALID);
-      for (cuda_iterator_start (block_iter); !cuda_iterator_end (block_iter); cuda_iterator_next (block_iter))
-        {
-          c  = cuda_iterator_get_current (block_iter);
-          blocks[i][j] = c.blockIdx;
-          ++j;
-        }
-      cuda_iterator_destroy (block_iter);
+static struct value *
+cv_make_num_present_kernels_value (struct gdbarch *gdbarch, struct internalvar *var, void *ignore)
+{
+  cv_present_update ();
+  return value_from_longest (builtin_type (gdbarch)->builtin_uint32,
+                             (LONGEST) (cv_present.max_blocks ? cv_present.kernels.size () : 0));
+}
 
-      ++i;
-    }
-    cuda_iterator_destroy (kernel_iter);
+static struct value *
+cv_make_present_kernel_ids_value (struct gdbarch *gdbarch, struct internalvar *var, void *ignore)
+{
+  cv_present_update ();
+  if (cv_present.max_blocks == 0)
+    return cv_make_empty_array_value (gdbarch);
+  return cuda_convenience_convert_to_kernel_id_array_value (cv_present.kernels.data (),
+                                                            cv_present.kernels.size ());
+}
 
-  /* conversion */
-  *block_idx_array_value = cuda_convenience_convert_to_block_idx_array_value (blocks, num_kernels, max_blocks);
-  *kernel_id_array_value = cuda_convenience_convert_to_kernel_id_array_value (kernels, num_kernels);
+static struct value *
+cv_make_present_block_idxs_value (struct gdbarch *gdbarch, struct internalvar *var, void *ignore)
+{
+  cv_present_update ();
+  if (cv_present.max_blocks == 0)
+    return cv_make_empty_array_value (gdbarch);
+  return cuda_convenience_convert_to_block_idx_array_value ();
+}
 
-  /* cleanup */
-  for (i = 0; i < num_kernels; i++)
-    xfree (blocks[i]);
-  xfree (blocks);
-  xfree (kernels);
+static const struct internalvar_funcs cv_num_present_kernels_funcs =
+{
+  cv_make_num_present_kernels_value,
+  NULL,
+  NULL
+};
 
-  return num_kernels;
-}
+static const struct internalvar_funcs cv_present_kernel_ids_funcs =
+{
+  cv_make_present_kernel_ids_value,
+  NULL,
+  NULL
+};
 
+static const struct internalvar_funcs cv_present_block_idxs_funcs =
+{
+  cv_make_present_block_idxs_value,
+  NULL,
+  NULL
+};
 
 static inline void
 cv_set_uint32_var (const char *name, uint32_t val)
@@ -369,7 +409,7 @@ cv_update_lineno_var(void)
   if (valid)
     {
       pc      = lane_get_virtual_pc (cur.dev, cur.sm, cur.wp, cur.ln);
-      lineno  = find_pc_line (pc, 0).line;
+      lineno  = cuda_find_pc_line (pc).line;
     }
 
   cv_set_uint32_var ("cuda_thread_lineno", lineno);
@@ -423,19 +463,23 @@ cv_update_api_failures_vars(void)
                    value_from_pointer (type_data_ptr, func_name));
 }
 
+/* The present kernels variables are computed when they are read, at
+   most once per stop. */
 static void
 cv_update_present_kernels_vars(void)
 {
-  uint32_t num_kernels;
-  struct value *kernel_array, *blocks_array;
+  static bool created = false;
 
-  num_kernels = cuda_convenience_get_present_blocks_kernels (&kernel_array, &blocks_array);
+  if (created)
+    return;
 
-  cv_set_uint32_var ("cuda_num_present_kernels", num_kernels);
-  set_internalvar (lookup_internalvar ("cuda_present_kernel_ids"),
-                   kernel_array);
-  set_internalvar (lookup_internalvar ("cuda_present_block_idxs"),
-                   blocks_array);
+  create_internalvar_type_lazy ("cuda_num_present_kernels",
+                                &cv_num_present_kernels_funcs, NULL);
+  create_internalvar_type_lazy ("cuda_present_kernel_ids",
+                                &cv_present_kernel_ids_funcs, NULL);
+  create_internalvar_type_lazy ("cuda_present_block_idxs",
+                                &cv_present_block_idxs_funcs, NULL);
+  created = true;
 }
 
 static void cv_update_total_kernels_var(void)
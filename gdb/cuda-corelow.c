@@ -246,17 +246,31 @@ cuda_core_initialize_events_exceptions (void)
     error ("Failed to create session directory");
 
   /* Drain the event queue */
-  while (true) {
-    cuda_api_get_next_sync_event (&event);
+  unsigned long num_events = 0;
+  auto start = std::chrono::steady_clock::now ();
+  cuda_event_begin_batch ();
+  TRY
+    {
+      while (true) {
+        cuda_api_get_next_sync_event (&event);
 
-    if (event.kind == CUDBG_EVENT_INVALID)
-      break;
+        if (event.kind == CUDBG_EVENT_INVALID)
+          break;
 
-    if (event.kind == CUDBG_EVENT_CTX_CREATE)
-      cuda_core_register_tid (event.cases.contextCreate.tid);
+        if (event.kind == CUDBG_EVENT_CTX_CREATE)
+          cuda_core_register_tid (event.cases.contextCreate.tid);
 
-    cuda_process_event (&event);
-  }
+        cuda_process_event (&event);
+        ++num_events;
+      }
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      cuda_event_end_batch (num_events, start);
+      throw_exception (except);
+    }
+  END_CATCH
+  cuda_event_end_batch (num_events, start);
 
   /* Figure out, where exception happened */
   if (cuda_exception_hit_p (cuda_exception))
@@ -277,9 +291,6 @@ cuda_core_initialize_events_exceptions (void)
 
       cuda_exception_print_message (cuda_exception);
     }
-
-  /* Fetch latest information about coredump grids */
-  kernels_update_args ();
 }
 
 static void
@@ -20,6 +20,7 @@
 #include "defs.h"
 #include "breakpoint.h"
 #include "common/common-defs.h"
+#include "psymtab.h"
 #include "source.h"
 
 #include "cuda-context.h"
@@ -30,14 +31,27 @@
 #include "cuda-tdep.h"
 #include "cuda-utils.h"
 
+#include <algorithm>
+#include <vector>
+
 elf_image_t elf_image_chain = NULL;
 
+/* number of loaded ELF images whose symbols have not been read yet */
+static unsigned int elf_images_pending_symbols = 0;
+
+/* While a batch of events is processed, the breakpoint work done after
+   loading an ELF image is deferred to the end of the batch, so that
+   breakpoints are re-set once for all the images loaded together. */
+static unsigned int elf_images_batch_depth = 0;
+static std::vector<elf_image_t> elf_images_batch;
+
 struct elf_image_st {
   struct objfile    *objfile;     /* pointer to the ELF image as managed by GDB */
   char               objfile_path [CUDA_GDB_TMP_BUF_SIZE];
                                   /* file path of the ELF image in the tmp folder */
   uint64_t           size;        /* the size of the relocated ELF image */
   bool               loaded;      /* is the ELF image in memory? */
+  bool               symbols_read;/* are the debug info and line table read? */
   bool               uses_abi;    /* does the ELF image uses the ABI to call functions */
   bool               system;      /* is this the system ELF image? */
   module_t           module;      /* the parent module */
@@ -55,6 +69,7 @@ cuda_elf_image_new (void *image, uint64_t size, module_t module)
   elf_image = (elf_image_t) xmalloc (sizeof (*elf_image));
   elf_image->size     = size;
   elf_image->loaded   = false;
+  elf_image->symbols_read = false;
   elf_image->uses_abi = false;
   elf_image->system   = false;
   elf_image->module   = module;
@@ -129,6 +144,13 @@ cuda_elf_image_is_system (elf_image_t elf_image)
   return elf_image->system;
 }
 
+bool
+cuda_elf_image_symbols_read (elf_image_t elf_image)
+{
+  gdb_assert (elf_image);
+  return elf_image->symbols_read;
+}
+
 bool
 cuda_elf_image_contains_address (elf_image_t elf_image, CORE_ADDR addr)
 {
@@ -232,11 +254,16 @@ cuda_elf_image_load (elf_image_t elf_image, bool is_system)
   arch_info = bfd_lookup_arch (bfd_arch_m68k, 0);
   abfd->arch_info = arch_info;
 
-  /* Load in the device ELF object file, forcing a symbol read and while
-   * making sure that the breakpoints are not re-set automatically. */
+  /* Load in the device ELF object file while making sure that the
+   * breakpoints are not re-set automatically. In lazy mode, only the minimal
+   * symbols are read now, otherwise force a symbol read. */
+  symfile_add_flags add_flags = SYMFILE_DEFER_BP_RESET;
+  bool lazy = cuda_options_lazy_symbol_reading_enabled ();
+  if (lazy)
+    add_flags |= SYMFILE_NO_READ;
+
   objfile = symbol_file_add_from_bfd (abfd.get (), bfd_get_filename (abfd.get ()),
-				      SYMFILE_DEFER_BP_RESET, NULL, 0,
-				      NULL);
+				      add_flags, NULL, 0, NULL);
   if (!objfile)
     error (_("Error: Failed to add symbols from device ELF symbol file!\n"));
 
@@ -248,26 +275,110 @@ cuda_elf_image_load (elf_image_t elf_image, bool is_system)
 
   /* In case the CUDA ELF file defines device symbols that
      overlap/replace existing objfile symtabs in the search order. */
-  clear_symtab_users (0);
-
-  /* CUDA - line info */
-  if (!objfile->compunit_symtabs)
-    cuda_decode_line_table (objfile);
+  if (elf_images_batch_depth)
+    clear_symtab_users (SYMFILE_DEFER_BP_RESET);
+  else
+    clear_symtab_users (0);
 
   /* Initialize the elf_image object */
   elf_image->objfile  = objfile;
   elf_image->loaded   = true;
   elf_image->system   = is_system;
   elf_image->uses_abi = cuda_is_bfd_version_call_abi (objfile->obfd);
-  cuda_trace ("loaded ELF image (name=%s, module=%p, abi=%d, objfile=%p)",
+  cuda_trace ("loaded ELF image (name=%s, module=%p, abi=%d, objfile=%p, lazy=%d)",
               objfile->original_name, elf_image->module,
-              elf_image->uses_abi, objfile);
+              elf_image->uses_abi, objfile, lazy);
+
+  elf_images_pending_symbols++;
+  if (!lazy)
+    cuda_elf_image_read_symbols (elf_image);
+
+  if (elf_images_batch_depth)
+    elf_images_batch.push_back (elf_image);
+  else
+    {
+      cuda_resolve_breakpoints (0, elf_image);
+      if (cuda_options_auto_breakpoints_needed ())
+          cuda_auto_breakpoints_add_locations ();
+    }
+
+  cuda_set_current_elf_image (NULL);
+}
+
+void
+cuda_elf_image_begin_batch (void)
+{
+  elf_images_batch_depth++;
+}
+
+/* Do the breakpoint work deferred by cuda_elf_image_load for the images
+   loaded since the outermost cuda_elf_image_begin_batch. */
+void
+cuda_elf_image_end_batch (void)
+{
+  std::vector<elf_image_t> loaded;
+
+  gdb_assert (elf_images_batch_depth > 0);
+  if (--elf_images_batch_depth > 0)
+    return;
 
-  cuda_resolve_breakpoints (0, elf_image);
+  loaded.swap (elf_images_batch);
+  if (loaded.empty ())
+    return;
+
+  cuda_trace ("resolving breakpoints for %zu ELF images", loaded.size ());
+
+  breakpoint_re_set ();
+  for (elf_image_t elf_image : loaded)
+    cuda_resolve_breakpoints (0, elf_image);
   if (cuda_options_auto_breakpoints_needed ())
       cuda_auto_breakpoints_add_locations ();
+}
 
-  cuda_set_current_elf_image (NULL);
+/* Read the partial symbols and the line table of the ELF image if that was
+ * deferred at load time. Full symbols are then expanded on demand by GDB. */
+void
+cuda_elf_image_read_symbols (elf_image_t elf_image)
+{
+  struct objfile *objfile;
+
+  gdb_assert (elf_image);
+
+  if (!elf_image->loaded || elf_image->symbols_read)
+    return;
+
+  objfile = elf_image->objfile;
+  gdb_assert (objfile);
+
+  cuda_trace ("reading symbols of ELF image (name=%s, module=%p)",
+              objfile->original_name, elf_image->module);
+
+  /* Mark the symbols as read first to avoid re-entering this function from
+     the PC lookups triggered below. */
+  elf_image->symbols_read = true;
+  gdb_assert (elf_images_pending_symbols > 0);
+  elf_images_pending_symbols--;
+
+  require_partial_symbols (objfile, 0);
+
+  /* CUDA - line info */
+  if (!objfile->compunit_symtabs)
+    cuda_decode_line_table (objfile);
+}
+
+/* Read the symbols of the ELF image containing ADDR, if it was loaded in
+ * lazy mode and its symbols have not been read yet. */
+void
+cuda_elf_image_read_symbols_by_address (CORE_ADDR addr)
+{
+  elf_image_t elf_image;
+
+  if (elf_images_pending_symbols == 0)
+    return;
+
+  elf_image = cuda_find_elf_image_by_address (addr);
+  if (elf_image)
+    cuda_elf_image_read_symbols (elf_image);
 }
 
 void
@@ -291,12 +402,21 @@ cuda_elf_image_unload (elf_image_t elf_image)
   cuda_reset_invalid_breakpoint_location_section (objfile);
   delete objfile;
 
+  if (!elf_image->symbols_read)
+    elf_images_pending_symbols--;
+
   elf_image->objfile = NULL;
   elf_image->loaded = false;
+  elf_image->symbols_read = false;
   elf_image->uses_abi = false;
 
   cuda_auto_breakpoints_remove_locations (elf_image);
   cuda_unresolve_breakpoints (elf_image);
+
+  /* Loaded and unloaded within the same batch */
+  elf_images_batch.erase (std::remove (elf_images_batch.begin (),
+                                       elf_images_batch.end (), elf_image),
+                          elf_images_batch.end ());
 }
 
 elf_image_t
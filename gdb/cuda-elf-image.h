@@ -46,10 +46,15 @@ elf_image_t      cuda_elf_image_get_next         (elf_image_t elf_image);
 bool             cuda_elf_image_is_loaded        (elf_image_t elf_image);
 bool             cuda_elf_image_uses_abi         (elf_image_t elf_image);
 bool             cuda_elf_image_is_system        (elf_image_t elf_image);
+bool             cuda_elf_image_symbols_read     (elf_image_t elf_image);
 
 void             cuda_elf_image_save             (elf_image_t elf_image, void *image);
 void             cuda_elf_image_load             (elf_image_t elf_image, bool is_system);
 void             cuda_elf_image_unload           (elf_image_t elf_image);
+void             cuda_elf_image_begin_batch      (void);
+void             cuda_elf_image_end_batch        (void);
+void             cuda_elf_image_read_symbols     (elf_image_t elf_image);
+void             cuda_elf_image_read_symbols_by_address (CORE_ADDR addr);
 
 bool             cuda_elf_image_contains_address (elf_image_t elf_image, CORE_ADDR addr);
 void             cuda_elf_image_resolve_breakpoints (elf_image_t elf_image);
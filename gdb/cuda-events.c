@@ -41,6 +41,10 @@
 #include "cuda-elf-image.h"
 #include "cuda-options.h"
 
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
 #ifdef __APPLE__
 bool cuda_darwin_cuda_device_used_for_graphics (uint32_t dev_id);
 #endif
@@ -258,8 +262,38 @@ find_lwp_callback (struct lwp_info *lp, void *data)
 
   return cuda_gdb_get_tid (lp->ptid) == tid;
 }
+
+/* Host threads looked up by tid during the current batch of events.
+   The host is stopped, so the list of LWPs cannot change meanwhile. */
+static std::unordered_map<uint32_t, ptid_t> cuda_event_batch_lwps;
+
+static bool
+cuda_event_find_lwp (uint32_t tid, ptid_t *ptid)
+{
+  struct lwp_info *lp;
+
+  auto it = cuda_event_batch_lwps.find (tid);
+  if (it == cuda_event_batch_lwps.end ())
+    {
+      lp = iterate_over_lwps (inferior_ptid, find_lwp_callback, &tid);
+      it = cuda_event_batch_lwps.emplace (tid, lp ? lp->ptid : null_ptid).first;
+    }
+
+  *ptid = it->second;
+  return it->second != null_ptid;
+}
 #endif
 
+/* Event processing statistics (maintenance print cuda_event_stats) */
+static struct {
+  unsigned long events;       /* events processed */
+  unsigned long batches;      /* non-empty batches */
+  unsigned long max_events;   /* events in the largest batch */
+  double        total_time;   /* usec spent in all batches */
+  double        max_time;     /* usec spent in the slowest batch */
+  unsigned long filtered;     /* kernel launches skipped by launch_filter */
+} cuda_event_stats;
+
 static void
 cuda_event_kernel_ready (uint32_t dev_id, uint64_t context_id, uint64_t module_id,
                          uint64_t grid_id, uint32_t tid, uint64_t virt_code_base,
@@ -268,7 +302,8 @@ cuda_event_kernel_ready (uint32_t dev_id, uint64_t context_id, uint64_t module_i
 {
   ptid_t           previous_ptid = inferior_ptid;
 #if defined(__linux__) && defined(GDB_NM_FILE)
-  struct lwp_info *lp            = NULL;
+  ptid_t           lwp_ptid;
+  bool             lp            = false;
 #endif
 
   cuda_trace_event ("CUDBG_EVENT_KERNEL_READY dev_id=%u context=%llx"
@@ -281,14 +316,22 @@ cuda_event_kernel_ready (uint32_t dev_id, uint64_t context_id, uint64_t module_i
   if (tid == ~0U)
     error (_("A CUDA event reported an invalid thread id."));
 
+  /* Filtered launches are not tracked.  Should one of their warps be
+     examined later, the kernel record is created on demand. */
+  if (!kernels_launch_filter_match (virt_code_base, grid_dim))
+    {
+      cuda_event_stats.filtered++;
+      return;
+    }
+
 #if defined(__linux__) && defined(GDB_NM_FILE)
   //FIXME - CUDA MAC OS X
-  lp = iterate_over_lwps (inferior_ptid, find_lwp_callback, &tid);
+  lp = cuda_event_find_lwp (tid, &lwp_ptid);
 
   if (lp)
     {
       previous_ptid = inferior_ptid;
-      inferior_ptid = lp->ptid;
+      inferior_ptid = lwp_ptid;
     }
 #endif
 
@@ -349,22 +392,90 @@ cuda_event_post_process (bool reset_bpt)
   }
 }
 
+void
+cuda_event_begin_batch (void)
+{
+  cuda_elf_image_begin_batch ();
+#if defined(__linux__) && defined(GDB_NM_FILE)
+  cuda_event_batch_lwps.clear ();
+#endif
+}
+
+void
+cuda_event_end_batch (unsigned long num_events,
+                      std::chrono::steady_clock::time_point start)
+{
+  cuda_elf_image_end_batch ();
+
+  if (num_events == 0)
+    return;
+
+  std::chrono::duration<double, std::micro> elapsed =
+    std::chrono::steady_clock::now () - start;
+
+  cuda_event_stats.events    += num_events;
+  cuda_event_stats.batches   += 1;
+  cuda_event_stats.max_events = std::max (cuda_event_stats.max_events, num_events);
+  cuda_event_stats.total_time += elapsed.count ();
+  cuda_event_stats.max_time   = std::max (cuda_event_stats.max_time, elapsed.count ());
+
+  cuda_trace_event ("processed %lu events in %.0f usec", num_events, elapsed.count ());
+}
+
+void
+cuda_print_event_statistics (const char *args, int from_tty)
+{
+  double secs = cuda_event_stats.total_time * 1e-6;
+
+  printf_unfiltered (_("Events processed: %lu in %lu batches (largest %lu)\n"),
+                     cuda_event_stats.events, cuda_event_stats.batches,
+                     cuda_event_stats.max_events);
+  printf_unfiltered (_("Time spent processing events: %f sec (max %.0f usec per batch)\n"),
+                     secs, cuda_event_stats.max_time);
+  if (cuda_event_stats.batches)
+    printf_unfiltered (_("Average batch: %.1f events in %.0f usec\n"),
+                       (double) cuda_event_stats.events / cuda_event_stats.batches,
+                       cuda_event_stats.total_time / cuda_event_stats.batches);
+  if (secs > 0)
+    printf_unfiltered (_("Throughput: %.0f events/sec\n"),
+                       cuda_event_stats.events / secs);
+  if (cuda_event_stats.filtered)
+    printf_unfiltered (_("Kernel launches filtered: %lu\n"),
+                       cuda_event_stats.filtered);
+}
+
 void
 cuda_process_events (CUDBGEvent *event, cuda_event_kind_t kind)
 {
   bool reset_bpt = false;
+  unsigned long num_events = 0;
+  auto start = std::chrono::steady_clock::now ();
   gdb_assert (event);
 
   /* Step 1:  Consume all events (synchronous and asynchronous).
      We must consume every event prior to any generic operations
-     that will force a state collection across the device. */
-  for (; event->kind != CUDBG_EVENT_INVALID;
-       (kind == CUDA_EVENT_SYNC) ? cuda_api_get_next_sync_event (event) :
-                                   cuda_api_get_next_async_event (event)) {
-    cuda_process_event (event);
-    if (event->kind == CUDBG_EVENT_KERNEL_READY)
-        reset_bpt = true;
-  }
+     that will force a state collection across the device. The work
+     that only depends on the end result (breakpoint resolution for the
+     loaded ELF images, thread lookups) is done once for the batch. */
+  cuda_event_begin_batch ();
+  TRY
+    {
+      for (; event->kind != CUDBG_EVENT_INVALID;
+           (kind == CUDA_EVENT_SYNC) ? cuda_api_get_next_sync_event (event) :
+                                       cuda_api_get_next_async_event (event)) {
+        cuda_process_event (event);
+        ++num_events;
+        if (event->kind == CUDBG_EVENT_KERNEL_READY)
+            reset_bpt = true;
+      }
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      cuda_event_end_batch (num_events, start);
+      throw_exception (except);
+    }
+  END_CATCH
+  cuda_event_end_batch (num_events, start);
 
   /* Step 2:  Post-process events after they've all been consumed. */
   cuda_event_post_process (reset_bpt);
@@ -20,6 +20,8 @@
 
 #include "cudadebugger.h"
 
+#include <chrono>
+
 typedef enum {
     CUDA_EVENT_INVALID,
     CUDA_EVENT_SYNC,
@@ -31,4 +33,11 @@ void cuda_process_events (CUDBGEvent *event, cuda_event_kind_t kind);
 void cuda_process_event  (CUDBGEvent *event);
 void cuda_event_post_process (bool reset_bpt);
 
+/* Batches of events processed outside of cuda_process_events */
+void cuda_event_begin_batch (void);
+void cuda_event_end_batch (unsigned long num_events,
+                           std::chrono::steady_clock::time_point start);
+
+void cuda_print_event_statistics (const char *args, int from_tty);
+
 #endif
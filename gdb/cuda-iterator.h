@@ -44,4 +44,15 @@ bool          cuda_iterator_end     (cuda_iterator itr);
 cuda_coords_t cuda_iterator_get_current (cuda_iterator itr);
 uint32_t      cuda_iterator_get_size    (cuda_iterator itr);
 
+/* Destroys the iterator when it goes out of scope */
+struct cuda_iterator_deleter
+{
+  void operator() (cuda_iterator itr) const
+  {
+    cuda_iterator_destroy (itr);
+  }
+};
+
+typedef std::unique_ptr<struct cuda_iterator_t, cuda_iterator_deleter> cuda_iterator_up;
+
 #endif
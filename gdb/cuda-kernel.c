@@ -16,8 +16,12 @@
  */
 
 #include "defs.h"
+#include "block.h"
+#include "fnmatch.h"
 #include "frame.h"
 #include "common/common-defs.h"
+#include "hashtab.h"
+#include "symtab.h"
 #include "ui-out.h"
 
 #include "cuda-api.h"
@@ -29,6 +33,9 @@
 #include "cuda-state.h"
 #include "cuda-tdep.h"
 
+#include <regex>
+#include <unordered_map>
+
 /* counter for the CUDA kernel ids */
 static uint64_t next_kernel_id = 0;
 
@@ -59,6 +66,9 @@ struct kernel_st {
   kernel_t          siblings;        /* next sibling when traversing the list of children */
   char             *name;            /* name of the kernel if available */
   char             *args;            /* kernel arguments in string format */
+  gdb_byte         *param_buf;       /* cached copy of the kernel parameters */
+  CORE_ADDR         param_base;      /* param memory address of param_buf[0] */
+  uint32_t          param_size;      /* size of param_buf in bytes */
   uint64_t          virt_code_base;  /* virtual address of the kernel entry point */
   module_t          module;          /* CUmodule handle of the kernel */
   bool              launched;        /* Has the kernel been seen on the hw? */
@@ -68,7 +78,9 @@ struct kernel_st {
   CUDBGKernelType   type;            /* The kernel type: system or application. */
   CUDBGKernelOrigin origin;          /* The kernel origin: CPU or GPU */
   disasm_cache_t    disasm_cache;    /* the cached disassembled instructions */
-  kernel_t          next;            /* next kernel on the same device */
+  kernel_t          next;            /* next (older) kernel in the list */
+  kernel_t          prev;            /* previous (newer) kernel in the list */
+  kernel_t          shadowed;        /* older kernel with the same grid id */
   unsigned int      depth;           /* kernel nest level (0 - host launched kernel) */
 };
 
@@ -118,6 +130,10 @@ should_print_kernel_event (kernel_t kernel)
   if (depth_or_disabled && kernel->depth > depth_or_disabled - 1)
     return false;
 
+  /* Kernels created on demand for a filtered launch stay quiet. */
+  if (!kernels_launch_filter_match (kernel->virt_code_base, kernel->grid_dim))
+    return false;
+
   return (kernel->type == CUDBG_KNL_TYPE_SYSTEM && cuda_options_show_kernel_events_system ()) ||
          (kernel->type == CUDBG_KNL_TYPE_APPLICATION && cuda_options_show_kernel_events_application ());
 }
@@ -162,6 +178,9 @@ kernel_new (uint32_t dev_id, uint64_t grid_id, uint64_t virt_code_base,
   kernel->virt_code_base           = virt_code_base;
   kernel->name                     = name_copy;
   kernel->args                     = NULL;
+  kernel->param_buf                = NULL;
+  kernel->param_base               = 0;
+  kernel->param_size               = 0;
   kernel->module                   = module;
   kernel->grid_dim                 = grid_dim;
   kernel->block_dim                = block_dim;
@@ -169,6 +188,8 @@ kernel_new (uint32_t dev_id, uint64_t grid_id, uint64_t virt_code_base,
   kernel->origin                   = origin;
   kernel->disasm_cache             = disasm_cache_create ();
   kernel->next                     = NULL;
+  kernel->prev                     = NULL;
+  kernel->shadowed                 = NULL;
   kernel->depth                    = !parent_kernel ? 0 : parent_kernel->depth + 1;
 
   snprintf (kernel->dimensions, sizeof (kernel->dimensions), "<<<(%d,%d,%d),(%d,%d,%d)>>>",
@@ -201,6 +222,7 @@ kernel_delete (kernel_t kernel)
   disasm_cache_destroy (kernel->disasm_cache);
   xfree (kernel->name);
   xfree (kernel->args);
+  xfree (kernel->param_buf);
   xfree (kernel);
 }
 
@@ -226,8 +248,148 @@ kernel_get_name (kernel_t kernel)
   return kernel->name ? kernel->name : "??";
 }
 
+/* Returns true if a value of TYPE can be printed from its own bytes
+   alone, i.e. without following a string pointer or a reference into
+   memory that would have to be read with the kernel in focus. */
+static bool
+kernel_param_type_self_contained (struct type *type)
+{
+  int i;
+
+  type = check_typedef (type);
+  switch (TYPE_CODE (type))
+    {
+    case TYPE_CODE_REF:
+    case TYPE_CODE_RVALUE_REF:
+      return false;
+    case TYPE_CODE_PTR:
+      return TYPE_LENGTH (check_typedef (TYPE_TARGET_TYPE (type))) != 1;
+    case TYPE_CODE_ARRAY:
+      return kernel_param_type_self_contained (TYPE_TARGET_TYPE (type));
+    case TYPE_CODE_STRUCT:
+    case TYPE_CODE_UNION:
+      for (i = 0; i < TYPE_NFIELDS (type); ++i)
+        if (!field_is_static (&TYPE_FIELD (type, i)) &&
+            !kernel_param_type_self_contained (TYPE_FIELD_TYPE (type, i)))
+          return false;
+      return true;
+    default:
+      return true;
+    }
+}
+
+/* Compute the [*LO, *HI) range of parameter memory that holds all the
+   arguments of FUNC. Returns false if any argument lives elsewhere or
+   cannot be printed from a copy of that range alone. */
+static bool
+kernel_param_range (struct symbol *func, CORE_ADDR *lo, CORE_ADDR *hi)
+{
+  const struct block *b;
+  struct block_iterator iter;
+  struct symbol *sym;
+  struct type *type;
+  CORE_ADDR addr;
+
+  *lo = ~(CORE_ADDR)0;
+  *hi = 0;
+
+  b = SYMBOL_BLOCK_VALUE (func);
+  ALL_BLOCK_SYMBOLS (b, iter, sym)
+    {
+      if (!SYMBOL_IS_ARGUMENT (sym))
+        continue;
+
+      type = SYMBOL_TYPE (sym);
+      if (SYMBOL_CLASS (sym) != LOC_STATIC || !TYPE_CUDA_PARAM (type) ||
+          !kernel_param_type_self_contained (type))
+        return false;
+
+      addr = SYMBOL_VALUE_ADDRESS (sym);
+      *lo = std::min (*lo, addr);
+      *hi = std::max (*hi, addr + TYPE_LENGTH (type));
+    }
+
+  return true;
+}
+
+/* Copy the kernel parameters into KERNEL->param_buf with a single
+   read from any valid warp of the kernel. No focus switch is needed,
+   as parameter memory is addressed per warp. Returns false if the
+   kernel is not on the device or its arguments are not all in
+   parameter memory. */
+static bool
+kernel_read_params (kernel_t kernel, struct symbol *func)
+{
+  cuda_coords_t *coords, requested, candidates[CK_MAX];
+  CORE_ADDR lo, hi;
+  gdb_byte *buf;
+
+  if (!kernel_param_range (func, &lo, &hi))
+    return false;
+
+  /* No arguments */
+  if (lo >= hi)
+    {
+      kernel->param_buf  = (gdb_byte *) xmalloc (1);
+      kernel->param_base = 0;
+      kernel->param_size = 0;
+      return true;
+    }
+
+  /* Find an active warp for the kernel */
+  requested = CUDA_WILDCARD_COORDS;
+  requested.kernelId = kernel_get_id (kernel);
+  cuda_coords_find_valid (requested, candidates, CUDA_SELECT_VALID);
+  coords = &candidates[CK_EXACT_LOGICAL];
+  if (!coords->valid || !cuda_coords_equal (&requested, coords))
+    return false;
+
+  buf = (gdb_byte *) xmalloc (hi - lo);
+  TRY
+    {
+      cuda_api_read_param_memory (coords->dev, coords->sm, coords->wp,
+                                  lo, buf, hi - lo);
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      xfree (buf);
+      return false;
+    }
+  END_CATCH
+
+  kernel->param_buf  = buf;
+  kernel->param_base = lo;
+  kernel->param_size = hi - lo;
+  return true;
+}
+
+/* Build the argument string from the cached parameter bytes. */
 static void
-kernel_populate_args (kernel_t kernel)
+kernel_render_args (kernel_t kernel, struct symbol *func)
+{
+  string_file stream;
+
+  current_uiout->redirect (&stream);
+  ui_out_redirect_pop redirect_popper (current_uiout);
+
+  TRY
+    {
+      print_args_contents (func, kernel->param_buf,
+                           kernel->param_base, kernel->param_size);
+      kernel->args = xstrdup (stream.string ().c_str ());
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      kernel->args = NULL;
+    }
+  END_CATCH
+}
+
+/* Build the argument string by unwinding the kernel entry frame of one
+   of its lanes. Used when the arguments cannot be printed from the
+   parameter bytes alone. */
+static void
+kernel_populate_args_from_frame (kernel_t kernel)
 {
   cuda_coords_t *coords, requested, candidates[CK_MAX];
   struct frame_info *prev_frame, *frame;
@@ -275,10 +437,27 @@ kernel_populate_args (kernel_t kernel)
   cuda_focus_restore (&focus);
 }
 
+/* The arguments are only rendered when first asked for. The parameter
+   bytes are read once and kept, so that the string can be built (or
+   rebuilt after a failure) without touching the device again. */
 const char *
 kernel_get_args (kernel_t kernel)
 {
+  struct symbol *func;
+
   gdb_assert (kernel);
+
+  if (kernel->args)
+    return kernel->args;
+
+  func = find_pc_function (kernel->virt_code_base);
+
+  if (func && (kernel->param_buf ||
+               (kernel_is_present (kernel) && kernel_read_params (kernel, func))))
+    kernel_render_args (kernel, func);
+  else if (kernel_is_present (kernel))
+    kernel_populate_args_from_frame (kernel);
+
   return kernel->args;
 }
 
@@ -504,9 +683,117 @@ kernel_print (kernel_t kernel)
  *
  *****************************************************************************/
 
-/* head of the system list of kernels */
+/* head of the system list of kernels, most recently launched first */
 static kernel_t kernels = NULL;
 
+/* tail of the system list of kernels, first launched */
+static kernel_t kernels_tail = NULL;
+
+/* kernels indexed by (dev_id, grid_id) and by kernel id */
+static htab_t kernels_by_grid_id = NULL;
+static htab_t kernels_by_kernel_id = NULL;
+
+static hashval_t
+kernel_grid_id_hash (const void *p)
+{
+  const struct kernel_st *kernel = (const struct kernel_st *) p;
+
+  return iterative_hash_object (kernel->grid_id, kernel->dev_id);
+}
+
+static int
+kernel_grid_id_eq (const void *a, const void *b)
+{
+  const struct kernel_st *kernel_a = (const struct kernel_st *) a;
+  const struct kernel_st *kernel_b = (const struct kernel_st *) b;
+
+  return kernel_a->dev_id == kernel_b->dev_id &&
+         kernel_a->grid_id == kernel_b->grid_id;
+}
+
+static hashval_t
+kernel_id_hash (const void *p)
+{
+  const struct kernel_st *kernel = (const struct kernel_st *) p;
+
+  return iterative_hash_object (kernel->id, 0);
+}
+
+static int
+kernel_id_eq (const void *a, const void *b)
+{
+  const struct kernel_st *kernel_a = (const struct kernel_st *) a;
+  const struct kernel_st *kernel_b = (const struct kernel_st *) b;
+
+  return kernel_a->id == kernel_b->id;
+}
+
+/* Add KERNEL to the index HTAB. If another kernel has the same key, the
+   most recent one wins, as it would have been found first in the list.
+   Returns the kernel it replaced, if any. */
+static kernel_t
+kernels_index_add (htab_t *htab, htab_hash hash_f, htab_eq eq_f, kernel_t kernel)
+{
+  kernel_t replaced;
+  void **slot;
+
+  if (!*htab)
+    *htab = htab_create (64, hash_f, eq_f, NULL);
+
+  slot = htab_find_slot (*htab, kernel, INSERT);
+  replaced = (kernel_t) *slot;
+  *slot = kernel;
+
+  return replaced;
+}
+
+/* Remove KERNEL from the index HTAB, where its key is unique. */
+static void
+kernels_index_remove (htab_t htab, kernel_t kernel)
+{
+  void **slot;
+
+  if (!htab)
+    return;
+
+  slot = htab_find_slot (htab, kernel, NO_INSERT);
+  if (slot && *slot == kernel)
+    htab_clear_slot (htab, slot);
+}
+
+/* Remove KERNEL from the grid id index. Kernels sharing a grid id are
+   chained from the most recent one, the one indexed, through their
+   shadowed link, so the next one in the chain takes its place. */
+static void
+kernels_grid_id_index_remove (kernel_t kernel)
+{
+  kernel_t other;
+  void **slot;
+
+  if (!kernels_by_grid_id)
+    return;
+
+  slot = htab_find_slot (kernels_by_grid_id, kernel, NO_INSERT);
+  if (!slot)
+    return;
+
+  if (*slot == kernel)
+    {
+      if (kernel->shadowed)
+        *slot = kernel->shadowed;
+      else
+        htab_clear_slot (kernels_by_grid_id, slot);
+      return;
+    }
+
+  for (other = (kernel_t) *slot; other; other = other->shadowed)
+    if (other->shadowed == kernel)
+      {
+        other->shadowed = kernel->shadowed;
+        break;
+      }
+}
+
 void
 kernels_print (void)
 {
@@ -543,7 +830,16 @@ kernels_start_kernel (uint32_t dev_id, uint64_t grid_id,
 
 
   kernel->next = kernels;
+  if (kernels)
+    kernels->prev = kernel;
+  else
+    kernels_tail = kernel;
   kernels = kernel;
+
+  kernel->shadowed = kernels_index_add (&kernels_by_grid_id, kernel_grid_id_hash,
+                                        kernel_grid_id_eq, kernel);
+  kernels_index_add (&kernels_by_kernel_id, kernel_id_hash,
+                     kernel_id_eq, kernel);
 }
 
 static void
@@ -574,8 +870,6 @@ kernels_add_parent_kernel (uint32_t dev_id, uint64_t grid_id, uint64_t *parent_g
 void
 kernels_terminate_kernel (kernel_t kernel)
 {
-  kernel_t  prev, ker;
-
   if (!kernel)
     return;
 
@@ -583,16 +877,20 @@ kernels_terminate_kernel (kernel_t kernel)
   if (kernel->children)
     return;
 
-  for (ker = kernels, prev = NULL;
-       ker && ker != kernel;
-       prev = ker, ker = kernels_get_next_kernel (ker))
-    ;
-  gdb_assert (ker);
+  gdb_assert (kernel->prev || kernels == kernel);
+
+  if (kernel->prev)
+    kernel->prev->next = kernel->next;
+  else
+    kernels = kernel->next;
 
-  if (prev)
-    prev->next = kernels_get_next_kernel (kernel);
+  if (kernel->next)
+    kernel->next->prev = kernel->prev;
   else
-    kernels = kernels_get_next_kernel (kernel);
+    kernels_tail = kernel->prev;
+
+  kernels_grid_id_index_remove (kernel);
+  kernels_index_remove (kernels_by_kernel_id, kernel);
 
   kernel_delete (kernel);
 }
@@ -629,38 +927,45 @@ kernels_get_next_kernel (kernel_t kernel)
   return kernel->next;
 }
 
+/* Iterate over the kernels in launch order, oldest first */
 kernel_t
-kernels_find_kernel_by_grid_id (uint32_t dev_id, uint64_t grid_id)
+kernels_get_oldest_kernel (void)
 {
-  kernel_t kernel;
+  return kernels_tail;
+}
 
-  for (kernel = kernels; kernel; kernel = kernels_get_next_kernel (kernel))
-    if (kernel->dev_id == dev_id && kernel->grid_id == grid_id)
-      return kernel;
+kernel_t
+kernels_get_newer_kernel (kernel_t kernel)
+{
+  if (!kernel)
+    return NULL;
 
-  return NULL;
+  return kernel->prev;
 }
 
 kernel_t
-kernels_find_kernel_by_kernel_id (uint64_t kernel_id)
+kernels_find_kernel_by_grid_id (uint32_t dev_id, uint64_t grid_id)
 {
-  kernel_t kernel;
+  struct kernel_st key;
 
-  for (kernel = kernels; kernel; kernel = kernels_get_next_kernel (kernel))
-    if (kernel->id == kernel_id)
-      return kernel;
+  if (!kernels_by_grid_id)
+    return NULL;
 
-  return NULL;
+  key.dev_id  = dev_id;
+  key.grid_id = grid_id;
+  return (kernel_t) htab_find (kernels_by_grid_id, &key);
 }
 
-void
-kernels_update_args (void)
+kernel_t
+kernels_find_kernel_by_kernel_id (uint64_t kernel_id)
 {
-  kernel_t kernel;
+  struct kernel_st key;
 
-  for (kernel = kernels_get_first_kernel (); kernel; kernel = kernels_get_next_kernel (kernel))
-    if (!kernel->args && kernel_is_present (kernel))
-      kernel_populate_args (kernel);
+  if (!kernels_by_kernel_id)
+    return NULL;
+
+  key.id = kernel_id;
+  return (kernel_t) htab_find (kernels_by_kernel_id, &key);
 }
 
 void
@@ -687,3 +992,86 @@ kernels_update_terminated (void)
       kernel = next_kernel;
     }
 }
+
+/******************************************************************************
+ *
+ *                               Launch filters
+ *
+ *****************************************************************************/
+
+/* The name verdict only depends on the kernel entry point, so it is computed
+   once per virtual code base and kept until the filter or the loaded code
+   changes.  This keeps the check on every kernel ready event to a hash
+   lookup, even when the events arrive by the million. */
+static struct {
+  std::string  pattern;    /* glob, or regex when enclosed in slashes */
+  bool         regex_p;
+  std::regex   regex;
+  std::unordered_map<uint64_t, bool> verdicts;
+} launch_filter;
+
+void
+kernels_set_launch_filter (const char *pattern)
+{
+  std::string str = pattern ? pattern : "";
+  bool regex_p = str.size () >= 2 && str.front () == '/' && str.back () == '/';
+  std::regex regex;
+
+  if (regex_p)
+    {
+      try
+        {
+          regex.assign (str.substr (1, str.size () - 2),
+                        std::regex::nosubs | std::regex::optimize);
+        }
+      catch (const std::regex_error &e)
+        {
+          error (_("Invalid launch filter regular expression \"%s\": %s"),
+                 str.c_str (), e.what ());
+        }
+    }
+
+  launch_filter.pattern = std::move (str);
+  launch_filter.regex_p = regex_p;
+  launch_filter.regex   = std::move (regex);
+  launch_filter.verdicts.clear ();
+}
+
+void
+kernels_launch_filter_invalidate (void)
+{
+  launch_filter.verdicts.clear ();
+}
+
+bool
+kernels_launch_filter_match (uint64_t virt_code_base, CuDim3 grid_dim)
+{
+  uint64_t num_blocks = (uint64_t) grid_dim.x * grid_dim.y * grid_dim.z;
+  unsigned int max_blocks = cuda_options_launch_filter_max_blocks ();
+  const char *name;
+  bool match;
+
+  /* UINT_MAX stands for "unlimited", grids may have more blocks */
+  if (num_blocks < cuda_options_launch_filter_min_blocks () ||
+      (max_blocks != UINT_MAX && num_blocks > max_blocks))
+    return false;
+
+  if (launch_filter.pattern.empty ())
+    return true;
+
+  auto it = launch_filter.verdicts.find (virt_code_base);
+  if (it != launch_filter.verdicts.end ())
+    return it->second;
+
+  name = cuda_find_function_name_from_pc (virt_code_base, true);
+  if (!name)
+    name = "";
+
+  if (launch_filter.regex_p)
+    match = std::regex_search (name, launch_filter.regex);
+  else
+    match = fnmatch (launch_filter.pattern.c_str (), name, 0) == 0;
+
+  launch_filter.verdicts.emplace (virt_code_base, match);
+  return match;
+}
@@ -60,13 +60,19 @@ void      kernels_start_kernel     (uint32_t dev_id, uint64_t grid_id,
 void      kernels_terminate_kernel  (kernel_t kernel);
 void      kernels_terminate_module  (module_t module);
 void      kernels_update_terminated (void);
-void      kernels_update_args       (void);
 void      kernels_print             (void);
 kernel_t  kernels_get_first_kernel  (void);
 kernel_t  kernels_get_next_kernel   (kernel_t kernel);
+kernel_t  kernels_get_oldest_kernel (void);
+kernel_t  kernels_get_newer_kernel  (kernel_t kernel);
 kernel_t  kernels_find_kernel_by_grid_id   (uint32_t dev_id, uint64_t grid_id);
 kernel_t  kernels_find_kernel_by_kernel_id (uint64_t kernel_id);
 
+void      kernels_set_launch_filter        (const char *pattern);
+bool      kernels_launch_filter_match      (uint64_t virt_code_base,
+                                            CuDim3 grid_dim);
+void      kernels_launch_filter_invalidate (void);
+
 uint64_t  cuda_latest_launched_kernel_id (void);
 
 #endif
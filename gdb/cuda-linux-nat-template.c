@@ -354,6 +354,9 @@ cuda_nat_linux<BaseTarget>::resume (ptid_t ptid, int sstep, int host_sstep, enum
 {
   uint32_t dev;
 
+  /* Any device or the host may write device memory from now on */
+  cuda_memcache_invalidate ();
+
   cuda_sstep_reset (sstep);
 
   // Is focus on host?
@@ -799,7 +802,10 @@ cuda_nat_linux<BaseTarget>::wait (ptid_t ptid,
           cuda_set_signo (ws->value.sig);
         }
     }
-  cuda_managed_memory_clean_regions();
+
+  /* Managed allocations can only change while the host runs */
+  if (!cuda_sstep_is_active ())
+    cuda_managed_memory_clean_regions ();
 
   /* Switch focus and update related data */
   cuda_update_convenience_variables ();
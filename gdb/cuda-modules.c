@@ -18,9 +18,11 @@
 #include "defs.h"
 #include "breakpoint.h"
 #include "common/common-defs.h"
+#include "hashtab.h"
 #include "objfiles.h"
 #include "source.h"
 
+#include "cuda-context.h"
 #include "cuda-defs.h"
 #include "cuda-elf-image.h"
 #include "cuda-options.h"
@@ -38,6 +40,7 @@ struct module_st {
   context_t   context;              /* the parent context state */
   elf_image_t elf_image;            /* the ELF image object for the module */
   module_t    next;                 /* next module in the list */
+  module_t    shadowed;             /* older module with the same id */
 };
 
 module_t
@@ -50,6 +53,7 @@ module_new (context_t context, uint64_t module_id, void *elf_image, uint64_t elf
   module->module_id  = module_id;
   module->elf_image  = cuda_elf_image_new (elf_image, elf_image_size, module);
   module->next       = NULL;
+  module->shadowed   = NULL;
 
   return module;
 }
@@ -108,8 +112,26 @@ module_get_elf_image (module_t module)
 
 struct modules_st {
   module_t    head;                 /* single-linked list of modules */
+  htab_t      by_id;                /* modules indexed by module id */
 };
 
+static hashval_t
+module_id_hash (const void *p)
+{
+  const struct module_st *module = (const struct module_st *) p;
+
+  return iterative_hash_object (module->module_id, 0);
+}
+
+static int
+module_id_eq (const void *a, const void *b)
+{
+  const struct module_st *module_a = (const struct module_st *) a;
+  const struct module_st *module_b = (const struct module_st *) b;
+
+  return module_a->module_id == module_b->module_id;
+}
+
 modules_t
 modules_new (void)
 {
@@ -117,6 +139,7 @@ modules_new (void)
 
   modules = (modules_t) xmalloc (sizeof *modules);
   modules->head = NULL;
+  modules->by_id = htab_create (16, module_id_hash, module_id_eq, NULL);
 
   return modules;
 }
@@ -137,17 +160,27 @@ modules_delete (modules_t modules)
       module_delete (module);
       module = next_module;
     }
+  htab_delete (modules->by_id);
   xfree (modules);
 }
 
 void
 modules_add (modules_t modules, module_t module)
 {
+  void **slot;
+
   gdb_assert (modules);
   gdb_assert (module);
 
   module->next  = modules->head;
   modules->head = module;
+
+  /* The most recent module wins, as it would have been found first. It
+     hides the older modules with the same id, chained through their
+     shadowed link. */
+  slot = htab_find_slot (modules->by_id, module, INSERT);
+  module->shadowed = (module_t) *slot;
+  *slot = module;
 }
 
 void
@@ -164,10 +197,33 @@ modules_remove (modules_t modules, module_t target_module)
   for (;pmodule && (*pmodule); pmodule = &((*pmodule)->next)) {
     if ((*pmodule) == target_module)
       {
+        void **slot = htab_find_slot (modules->by_id, target_module, NO_INSERT);
+
         next_module = (*pmodule)->next;
-        kernels_terminate_module (*pmodule);
-        module_delete (*pmodule);
         *pmodule = next_module;
+
+        if (slot && *slot == target_module)
+          {
+            /* The next module with the same id takes its place */
+            if (target_module->shadowed)
+              *slot = target_module->shadowed;
+            else
+              htab_clear_slot (modules->by_id, slot);
+          }
+        else if (slot)
+          {
+            module_t module;
+
+            for (module = (module_t) *slot; module; module = module->shadowed)
+              if (module->shadowed == target_module)
+                {
+                  module->shadowed = target_module->shadowed;
+                  break;
+                }
+          }
+
+        kernels_terminate_module (target_module);
+        module_delete (target_module);
         break;
       }
   }
@@ -187,13 +243,12 @@ modules_print (modules_t modules)
 module_t
 modules_find_module_by_id (modules_t modules, uint64_t module_id)
 {
-  module_t module;
+  struct module_st key;
 
-  for (module = modules->head; module; module = module->next)
-    if (module->module_id == module_id)
-      return module;
+  gdb_assert (modules);
 
-  return NULL;
+  key.module_id = module_id;
+  return (module_t) htab_find (modules->by_id, &key);
 }
 
 module_t
@@ -204,12 +259,14 @@ modules_find_module_by_address (modules_t modules, CORE_ADDR addr)
 
   gdb_assert (modules);
 
-  for (module = modules->head; module; module = module->next)
-  {
-    elf_image = module_get_elf_image (module);
-    if (cuda_elf_image_contains_address (elf_image, addr))
-      return module;
-  }
+  elf_image = cuda_find_elf_image_by_address (addr);
+  if (!elf_image)
+    return NULL;
 
-  return NULL;
+  /* Make sure the module belongs to this list */
+  module = cuda_elf_image_get_module (elf_image);
+  if (context_get_modules (module_get_context (module)) != modules)
+    return NULL;
+
+  return module;
 }
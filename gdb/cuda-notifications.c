@@ -100,9 +100,6 @@ extern uint32_t inferior_pid;
 ATTRIBUTE_PRINTF(1, 2) void
 cuda_notification_trace (const char *fmt, ...)
 {
-#ifdef GDBSERVER
-  struct cuda_trace_msg *msg;
-#endif
   va_list ap;
 
   if (!cuda_options_debug_notifications())
@@ -110,15 +107,7 @@ cuda_notification_trace (const char *fmt, ...)
 
   va_start (ap, fmt);
 #ifdef GDBSERVER
-  msg = (struct cuda_trace_msg *) xmalloc (sizeof (*msg));
-  if (!cuda_first_trace_msg)
-    cuda_first_trace_msg = msg;
-  else
-    cuda_last_trace_msg->next = msg;
-  sprintf (msg->buf, "[CUDAGDB] notifications -- ");
-  vsnprintf (msg->buf + strlen (msg->buf), sizeof (msg->buf), fmt, ap);
-  msg->next = NULL;
-  cuda_last_trace_msg = msg;
+  cuda_trace_msg_vappend ("[CUDAGDB] notifications -- ", fmt, ap);
 #else
   fprintf (stderr, "[CUDAGDB] notifications -- ");
   vfprintf (stderr, fmt, ap);
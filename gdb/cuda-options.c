@@ -24,6 +24,7 @@
 #include "gdbcmd.h"
 #include "remote.h"
 
+#include "cuda-events.h"
 #include "cuda-options.h"
 #include "cuda-state.h"
 #include "cuda-convvars.h"
@@ -892,6 +893,109 @@ cuda_options_auto_breakpoints_needed (void)
             cuda_break_on_launch != cuda_break_on_launch_none;
 }
 
+/*
+ * set cuda launch_filter
+ * set cuda launch_filter_min_blocks
+ * set cuda launch_filter_max_blocks
+ */
+static char *cuda_launch_filter = NULL;
+static std::string cuda_launch_filter_active;
+static unsigned int cuda_launch_filter_min_blocks = 0;
+static unsigned int cuda_launch_filter_max_blocks = UINT_MAX;
+
+static void
+cuda_show_launch_filter (struct ui_file *file, int from_tty,
+                         struct cmd_list_element *c, const char *value)
+{
+  if (value && *value)
+    fprintf_filtered (file, _("CUDA kernel launches are filtered by name with '%s'.\n"), value);
+  else
+    fprintf_filtered (file, _("CUDA kernel launches are not filtered by name.\n"));
+}
+
+static void
+cuda_set_launch_filter (const char *args, int from_tty, struct cmd_list_element *c)
+{
+  TRY
+    {
+      kernels_set_launch_filter (cuda_launch_filter);
+    }
+  CATCH (ex, RETURN_MASK_ERROR)
+    {
+      xfree (cuda_launch_filter);
+      cuda_launch_filter = xstrdup (cuda_launch_filter_active.c_str ());
+      throw_exception (ex);
+    }
+  END_CATCH
+
+  cuda_launch_filter_active = cuda_launch_filter ? cuda_launch_filter : "";
+}
+
+static void
+cuda_show_launch_filter_min_blocks (struct ui_file *file, int from_tty,
+                                    struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("CUDA kernel launches with fewer than %s blocks are filtered.\n"), value);
+}
+
+static void
+cuda_show_launch_filter_max_blocks (struct ui_file *file, int from_tty,
+                                    struct cmd_list_element *c, const char *value)
+{
+  if (cuda_launch_filter_max_blocks == UINT_MAX)
+    fprintf_filtered (file, _("CUDA kernel launches are not filtered by grid size maximum.\n"));
+  else
+    fprintf_filtered (file, _("CUDA kernel launches with more than %s blocks are filtered.\n"), value);
+}
+
+static void
+cuda_options_initialize_launch_filter (void)
+{
+  add_setshow_string_cmd ("launch_filter", class_cuda, &cuda_launch_filter,
+                          _("Set the kernel name filter for launch notifications."),
+                          _("Show the kernel name filter for launch notifications."),
+                          _("Only the launches of the kernels whose demangled name matches the\n"
+                            "filter are tracked by the debugger. The filter is a glob pattern\n"
+                            "(e.g. \"*gemm*\"), or a regular expression when enclosed in slashes\n"
+                            "(e.g. \"/^reduce<.*float/\"). The name includes the parameter list.\n"
+                            "Launches that do not match are resumed without building a kernel\n"
+                            "record, do not print kernel events and do not stop on break_on_launch.\n"
+                            "An empty filter matches every kernel (default)."),
+                          cuda_set_launch_filter, cuda_show_launch_filter,
+                          &setcudalist, &showcudalist);
+
+  add_setshow_zuinteger_cmd ("launch_filter_min_blocks", class_cuda,
+                             &cuda_launch_filter_min_blocks,
+                             _("Set the minimum grid size of the kernel launches to track."),
+                             _("Show the minimum grid size of the kernel launches to track."),
+                             _("Launches of grids with fewer blocks are filtered like launches\n"
+                               "not matching launch_filter. Zero means no minimum (default)."),
+                             NULL, cuda_show_launch_filter_min_blocks,
+                             &setcudalist, &showcudalist);
+
+  add_setshow_uinteger_cmd ("launch_filter_max_blocks", class_cuda,
+                            &cuda_launch_filter_max_blocks,
+                            _("Set the maximum grid size of the kernel launches to track."),
+                            _("Show the maximum grid size of the kernel launches to track."),
+                            _("Launches of grids with more blocks are filtered like launches\n"
+                              "not matching launch_filter. A value of \"unlimited\" or zero\n"
+                              "means no maximum (default)."),
+                            NULL, cuda_show_launch_filter_max_blocks,
+                            &setcudalist, &showcudalist);
+}
+
+unsigned int
+cuda_options_launch_filter_min_blocks (void)
+{
+  return cuda_launch_filter_min_blocks;
+}
+
+unsigned int
+cuda_options_launch_filter_max_blocks (void)
+{
+  return cuda_launch_filter_max_blocks;
+}
+
 /*
  * set cuda show_context_events
  */
@@ -1202,7 +1306,13 @@ cuda_options_initialize_variable_value_cache_enabled (void)
   add_setshow_auto_boolean_cmd ("ptx_cache", class_cuda, &cuda_variable_value_cache_enabled,
                                 _("Turn on/off GPU variable value cache"),
                                 _("Show if GPU variable value cache is is turned on/off."),
-                                _("When enabled, cuda-gdb will cache the last known values of PTX registers mapped to local variables for a current lane."),
+                                _("When enabled, cuda-gdb will cache the last known values of PTX registers mapped to local variables for a current lane.\n"
+                                  "  on   : the values of all the local variables of the current frame are also\n"
+                                  "         cached before each step (default)\n"
+                                  "  auto : only the values that were read are cached, which makes stepping\n"
+                                  "         cheaper; a local that was not printed before its register dies\n"
+                                  "         then shows as <optimized out>\n"
+                                  "  off  : no value is cached"),
                                 NULL, cuda_show_cuda_variable_value_cache_enabled,
                                 &setcudalist, &showcudalist);
 }
@@ -1214,6 +1324,12 @@ cuda_options_variable_value_cache_enabled (void)
          cuda_variable_value_cache_enabled == AUTO_BOOLEAN_AUTO;
 }
 
+bool
+cuda_options_variable_value_cache_prefetch (void)
+{
+  return cuda_variable_value_cache_enabled == AUTO_BOOLEAN_TRUE;
+}
+
 static void
 cuda_print_statistics (const char *args, int from_tty)
 {
@@ -1294,6 +1410,10 @@ cuda_options_initialize_stats (void)
            _("Print statistics about CUDA Debugger API."),
            &maintenanceprintlist);
 
+  add_cmd ("cuda_event_stats", class_maintenance, cuda_print_event_statistics,
+           _("Print statistics about CUDA event processing."),
+           &maintenanceprintlist);
+
   add_setshow_boolean_cmd ("collect_stats", class_cuda, &cuda_gpu_collect_stats,
                            _("Turn on/off CUDA Debugger API statistics collection"),
                            _("Show if CUDA Debugger API statistics collection is enabled."),
@@ -1383,6 +1503,221 @@ cuda_options_initialize_single_stepping_optimization (void)
 
 }
 
+/*
+ * set cuda lazy_symbol_reading
+ */
+int cuda_lazy_symbol_reading = 0;
+
+static void
+cuda_show_lazy_symbol_reading (struct ui_file *file, int from_tty,
+                               struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("CUDA lazy symbol reading is %s.\n"), value);
+}
+
+bool
+cuda_options_lazy_symbol_reading_enabled (void)
+{
+  return cuda_lazy_symbol_reading != 0;
+}
+
+static void
+cuda_options_initialize_lazy_symbol_reading (void)
+{
+  add_setshow_boolean_cmd ("lazy_symbol_reading", class_cuda, &cuda_lazy_symbol_reading,
+                           _("Turn on/off lazy symbol reading for device ELF images"),
+                           _("Show if lazy symbol reading for device ELF images is enabled."),
+                           _("When enabled, cuda-gdb only reads the minimal symbols of a device"
+                             " ELF image when it is loaded. The debug information and line tables"
+                             " are read the first time a PC, breakpoint or symbol lookup lands in"
+                             " that image. Only affects ELF images loaded after the change."),
+                           NULL, cuda_show_lazy_symbol_reading,
+                           &setcudalist, &showcudalist);
+}
+
+/*
+ * set cuda max_rows
+ */
+static unsigned int cuda_max_rows = UINT_MAX;
+
+static void
+cuda_show_max_rows (struct ui_file *file, int from_tty,
+                    struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The maximum number of rows in CUDA info listings is %s.\n"), value);
+}
+
+unsigned int
+cuda_options_max_rows (void)
+{
+  return cuda_max_rows;
+}
+
+static void
+cuda_options_initialize_max_rows (void)
+{
+  add_setshow_uinteger_cmd ("max_rows", class_cuda, &cuda_max_rows,
+                            _("Set the maximum number of rows printed by the info cuda commands."),
+                            _("Show the maximum number of rows printed by the info cuda commands."),
+                            _("Applies to info cuda warps, lanes, blocks and threads. Once the limit\n"
+                              "is reached, the remaining threads are not queried from the device.\n"
+                              "A value of \"unlimited\" or zero means no limit (default)."),
+                            NULL, cuda_show_max_rows,
+                            &setcudalist, &showcudalist);
+}
+
+/*
+ * set cuda memory_cache_lines
+ * set cuda memory_cache_line_size
+ */
+static unsigned int cuda_memory_cache_lines = 64;
+static unsigned int cuda_memory_cache_line_size = 256;
+
+static void
+cuda_show_memory_cache_lines (struct ui_file *file, int from_tty,
+                              struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The number of lines in the CUDA device memory cache is %s.\n"), value);
+}
+
+static void
+cuda_show_memory_cache_line_size (struct ui_file *file, int from_tty,
+                                  struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The CUDA device memory cache line size is %s.\n"), value);
+}
+
+static void
+cuda_set_memory_cache_lines (const char *args, int from_tty,
+                             struct cmd_list_element *c)
+{
+  cuda_memcache_invalidate ();
+}
+
+static void
+cuda_set_memory_cache_line_size (const char *args, int from_tty,
+                                 struct cmd_list_element *c)
+{
+  static unsigned int previous_line_size = 256;
+
+  if (cuda_memory_cache_line_size < 4 || cuda_memory_cache_line_size > 65536 ||
+      (cuda_memory_cache_line_size & (cuda_memory_cache_line_size - 1)) != 0)
+    {
+      cuda_memory_cache_line_size = previous_line_size;
+      error (_("Line size must be a power of 2 between 4 and 65536."));
+    }
+
+  previous_line_size = cuda_memory_cache_line_size;
+  cuda_memcache_invalidate ();
+}
+
+unsigned int
+cuda_options_memory_cache_lines (void)
+{
+  return cuda_memory_cache_lines;
+}
+
+unsigned int
+cuda_options_memory_cache_line_size (void)
+{
+  return cuda_memory_cache_line_size;
+}
+
+static void
+cuda_options_initialize_memory_cache (void)
+{
+  add_setshow_zuinteger_cmd ("memory_cache_lines", class_cuda, &cuda_memory_cache_lines,
+                             _("Set the number of lines in the CUDA device memory cache."),
+                             _("Show the number of lines in the CUDA device memory cache."),
+                             _("Device memory reads are served in whole lines that are kept until\n"
+                               "the device is resumed or the memory is written to.\n"
+                               "A value of zero disables the cache."),
+                             cuda_set_memory_cache_lines, cuda_show_memory_cache_lines,
+                             &setcudalist, &showcudalist);
+
+  add_setshow_zuinteger_cmd ("memory_cache_line_size", class_cuda, &cuda_memory_cache_line_size,
+                             _("Set the line size of the CUDA device memory cache."),
+                             _("Show the line size of the CUDA device memory cache."),
+                             _("Must be a power of 2 between 4 and 65536 bytes (default 256)."),
+                             cuda_set_memory_cache_line_size, cuda_show_memory_cache_line_size,
+                             &setcudalist, &showcudalist);
+}
+
+/*
+ * set cuda remote_compression
+ */
+static int cuda_remote_compression = 1;
+
+static void
+cuda_show_remote_compression (struct ui_file *file, int from_tty,
+                              struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Compression of large CUDA replies from the remote target is %s.\n"), value);
+}
+
+static void
+cuda_set_remote_compression (const char *args, int from_tty, struct cmd_list_element *c)
+{
+  remote_target *remote = get_current_remote_target ();
+
+  if (cuda_remote && remote)
+    cuda_remote_set_reply_compression (remote);
+}
+
+bool
+cuda_options_remote_compression (void)
+{
+  return cuda_remote_compression != 0;
+}
+
+static void
+cuda_options_initialize_remote_compression (void)
+{
+  add_setshow_boolean_cmd ("remote_compression", class_cuda, &cuda_remote_compression,
+                           _("Turn on/off the compression of large CUDA replies from the remote target"),
+                           _("Show if large CUDA replies from the remote target are compressed."),
+                           _("When enabled and supported by cuda-gdbserver, the replies of the debugger"
+                             " API calls larger than 4 KB, such as ELF images and memory reads, are"
+                             " compressed with zlib before being sent to cuda-gdb."),
+                           cuda_set_remote_compression, cuda_show_remote_compression,
+                           &setcudalist, &showcudalist);
+}
+
+/*
+ * set cuda elf_cache_dir
+ */
+static char *cuda_elf_cache_dir = NULL;
+
+static void
+cuda_show_elf_cache_dir (struct ui_file *file, int from_tty,
+                         struct cmd_list_element *c, const char *value)
+{
+  if (value && *value)
+    fprintf_filtered (file, _("Device ELF images fetched from the remote target are cached in \"%s\".\n"), value);
+  else
+    fprintf_filtered (file, _("Device ELF images fetched from the remote target are not cached.\n"));
+}
+
+const char *
+cuda_options_elf_cache_dir (void)
+{
+  return cuda_elf_cache_dir && *cuda_elf_cache_dir ? cuda_elf_cache_dir : NULL;
+}
+
+static void
+cuda_options_initialize_elf_cache_dir (void)
+{
+  add_setshow_optional_filename_cmd ("elf_cache_dir", class_cuda, &cuda_elf_cache_dir,
+                                     _("Set the directory caching the device ELF images of remote targets."),
+                                     _("Show the directory caching the device ELF images of remote targets."),
+                                     _("When remote debugging, the server first sends the SHA1 of each device\n"
+                                       "ELF image. Images already present in this directory are read from it\n"
+                                       "and only the missing ones are transferred, then added to the directory.\n"
+                                       "An empty value disables the cache (default)."),
+                                     NULL, cuda_show_elf_cache_dir,
+                                     &setcudalist, &showcudalist);
+}
+
 static unsigned cuda_stop_signal = GDB_SIGNAL_URG;
 static const char *cuda_stop_signal_string = NULL;
 static const char *cuda_stop_signal_enum[] = {
@@ -1477,6 +1812,7 @@ cuda_options_initialize (void)
   cuda_options_initialize_disassemble_per ();
   cuda_options_initialize_hide_internal_frames ();
   cuda_options_initialize_show_kernel_events ();
+  cuda_options_initialize_launch_filter ();
   cuda_options_initialize_show_context_events ();
   cuda_options_initialize_launch_blocking ();
   cuda_options_initialize_thread_selection ();
@@ -1488,6 +1824,11 @@ cuda_options_initialize (void)
   cuda_options_initialize_stats ();
   cuda_options_initialize_value_extrapolation ();
   cuda_options_initialize_single_stepping_optimization ();
+  cuda_options_initialize_lazy_symbol_reading ();
+  cuda_options_initialize_max_rows ();
+  cuda_options_initialize_memory_cache ();
+  cuda_options_initialize_remote_compression ();
+  cuda_options_initialize_elf_cache_dir ();
   cuda_options_initialize_stop_signal ();
   cuda_options_initialize_device_resume_on_cpu_dynamic_function_call ();
 }
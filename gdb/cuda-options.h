@@ -41,6 +41,8 @@ void cuda_options_force_set_launch_notification_update (void);
 unsigned int cuda_options_show_kernel_events_depth (void);
 bool cuda_options_show_kernel_events_application (void);
 bool cuda_options_show_kernel_events_system (void);
+unsigned int cuda_options_launch_filter_min_blocks (void);
+unsigned int cuda_options_launch_filter_max_blocks (void);
 bool cuda_options_show_context_events (void);
 bool cuda_options_launch_blocking (void);
 bool cuda_options_thread_selection_logical (void);
@@ -55,10 +57,17 @@ bool cuda_options_notify_random (void);
 bool cuda_options_software_preemption (void);
 bool cuda_options_gpu_busy_check (void);
 bool cuda_options_variable_value_cache_enabled (void);
+bool cuda_options_variable_value_cache_prefetch (void);
 bool cuda_options_statistics_collection_enabled (void);
 bool cuda_options_value_extrapolation_enabled (void);
 bool cuda_options_trace_domain_enabled (cuda_trace_domain_t);
 bool cuda_options_single_stepping_optimizations_enabled (void);
+bool cuda_options_lazy_symbol_reading_enabled (void);
+unsigned int cuda_options_max_rows (void);
+unsigned int cuda_options_memory_cache_lines (void);
+unsigned int cuda_options_memory_cache_line_size (void);
+bool cuda_options_remote_compression (void);
+const char *cuda_options_elf_cache_dir (void);
 /* Return GDB_SIGNAL_TRAP or GDB_SIGNAL_URG */
 unsigned cuda_options_stop_signal (void);
 bool cuda_options_device_resume_on_cpu_dynamic_function_call (void);
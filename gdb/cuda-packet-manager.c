@@ -24,6 +24,7 @@
 #include "gdbthread.h"
 #include "inferior.h"
 #include "remote.h"
+#include "common/byte-vector.h"
 #ifdef __QNXTARGET__
 # include "remote-nto.h"
 # define getpkt qnx_getpkt
@@ -33,6 +34,7 @@
 #endif
 #include "remote-cuda.h"
 #include "cuda-packet-manager.h"
+#include "libcudbgipc.h"
 #include "cuda-context.h"
 #include "cuda-events.h"
 #include "cuda-state.h"
@@ -499,6 +501,44 @@ cuda_remote_query_device_spec (remote_target *ops,
   *sm_type  = extract_string (NULL);
 }
 
+/* Ask the server for the SHA1 of an ELF image.  Returns false if the
+   server could not provide it, including servers predating the packet, in
+   which case the image has to be transferred as usual. */
+bool
+cuda_remote_query_elf_image_hash (remote_target *ops, uint32_t dev, uint64_t handle,
+                                  CUDBGElfImageType type, uint64_t size, gdb_byte *hash)
+{
+  static bool unsupported = false;
+  char *p;
+  CUDBGResult res;
+  cuda_packet_type_t packet_type = QUERY_ELF_IMAGE_HASH;
+
+  if (unsupported)
+    return false;
+
+  p = append_string ("qnv.", pktbuf.data (), false);
+  p = append_bin ((gdb_byte *) &packet_type, p, sizeof (packet_type), true);
+  p = append_bin ((gdb_byte *) &dev,         p, sizeof (dev), true);
+  p = append_bin ((gdb_byte *) &handle,      p, sizeof (handle), true);
+  p = append_bin ((gdb_byte *) &type,        p, sizeof (type), true);
+  p = append_bin ((gdb_byte *) &size,        p, sizeof (size), false);
+
+  putpkt (ops, pktbuf.data ());
+  getpkt (ops, &pktbuf, 1);
+
+  if (pktbuf[0] == '\0' || (pktbuf[0] == 'E' && strlen (pktbuf.data ()) == 3))
+    {
+      unsupported = true;
+      return false;
+    }
+
+  extract_bin (pktbuf.data (), (gdb_byte *) &res, sizeof (res));
+  if (res != CUDBG_SUCCESS)
+    return false;
+  extract_bin (NULL, hash, CUDA_ELF_IMAGE_HASH_SIZE);
+  return true;
+}
+
 bool
 #ifdef __QNXTARGET__
 cuda_remote_check_pending_sigint (remote_target *ops, ptid_t ptid)
@@ -566,16 +606,37 @@ cuda_remote_set_option (remote_target *ops)
   getpkt (ops, &pktbuf, 1);
 }
 
+/* Negotiate the compression of the vCUDA replies (set cuda
+   remote_compression).  Servers predating the packet keep sending
+   uncompressed replies. */
 void
-cuda_remote_query_trace_message (remote_target *ops)
+cuda_remote_set_reply_compression (remote_target *ops)
 {
   char *p;
-  cuda_packet_type_t packet_type = QUERY_TRACE_MESSAGE;
+  bool requested = cuda_options_remote_compression ();
+  bool enabled = false;
+  cuda_packet_type_t packet_type = SET_REPLY_COMPRESSION;
 
-  if (!cuda_options_debug_general () &&
-      !cuda_options_debug_libcudbg () &&
-      !cuda_options_debug_notifications ())
-    return;
+  p = append_string ("qnv.", pktbuf.data (), false);
+  p = append_bin ((gdb_byte *) &packet_type, p, sizeof (packet_type), true);
+  p = append_bin ((gdb_byte *) &requested,   p, sizeof (requested), false);
+
+  putpkt (ops, pktbuf.data ());
+  getpkt (ops, &pktbuf, 1);
+
+  if (pktbuf[0] != '\0' && !(pktbuf[0] == 'E' && strlen (pktbuf.data ()) == 3))
+    extract_bin (pktbuf.data (), (gdb_byte *) &enabled, sizeof (enabled));
+
+  cudbgipcSetRemoteCompression (enabled);
+}
+
+/* Fetch the trace messages one round trip at a time, from servers
+   predating QUERY_TRACE_MESSAGES */
+static void
+cuda_remote_query_trace_message_single (remote_target *ops)
+{
+  char *p;
+  cuda_packet_type_t packet_type = QUERY_TRACE_MESSAGE;
 
   p = append_string ("qnv.", pktbuf.data (), false);
   p = append_bin ((gdb_byte *) &packet_type, p, sizeof (packet_type), false);
@@ -596,6 +657,77 @@ cuda_remote_query_trace_message (remote_target *ops)
   fflush (stderr);
 }
 
+void
+cuda_remote_query_trace_message (remote_target *ops)
+{
+  static bool unsupported = false;
+  char *p;
+  cuda_packet_type_t packet_type = QUERY_TRACE_MESSAGES;
+  gdb::byte_vector msgs;
+  uint64_t dropped;
+  uint64_t timestamp;
+  uint32_t count;
+  uint32_t size;
+  uint32_t offset;
+
+  if (!cuda_options_debug_general () &&
+      !cuda_options_debug_libcudbg () &&
+      !cuda_options_debug_notifications ())
+    return;
+
+  if (unsupported)
+    {
+      cuda_remote_query_trace_message_single (ops);
+      return;
+    }
+
+  /* Each reply carries as many messages as fit in a packet */
+  do
+    {
+      p = append_string ("qnv.", pktbuf.data (), false);
+      p = append_bin ((gdb_byte *) &packet_type, p, sizeof (packet_type), false);
+      putpkt (ops, pktbuf.data ());
+      getpkt (ops, &pktbuf, 1);
+
+      if (pktbuf[0] == '\0' || (pktbuf[0] == 'E' && strlen (pktbuf.data ()) == 3))
+        {
+          unsupported = true;
+          cuda_remote_query_trace_message_single (ops);
+          return;
+        }
+
+      extract_bin (pktbuf.data (), (gdb_byte *) &dropped, sizeof (dropped));
+      extract_bin (NULL, (gdb_byte *) &count, sizeof (count));
+      extract_bin (NULL, (gdb_byte *) &size, sizeof (size));
+
+      if (dropped > 0)
+        fprintf (stderr, "[CUDAGDB] %llu trace messages dropped by cuda-gdbserver\n",
+                 (unsigned long long) dropped);
+
+      if (size == 0)
+        break;
+
+      msgs.resize (size);
+      extract_bin (NULL, msgs.data (), size);
+
+      for (offset = 0; offset + sizeof (timestamp) < size; )
+        {
+          const char *msg = (const char *) msgs.data () + offset + sizeof (timestamp);
+          size_t length = strnlen (msg, size - offset - sizeof (timestamp));
+
+          memcpy (&timestamp, msgs.data () + offset, sizeof (timestamp));
+          fprintf (stderr, "[%llu.%06llu] %.*s\n",
+                   (unsigned long long) (timestamp / 1000000),
+                   (unsigned long long) (timestamp % 1000000),
+                   (int) length, msg);
+          offset += sizeof (timestamp) + length + 1;
+        }
+    }
+  while (count > 0);
+
+  fflush (stderr);
+}
+
 #ifdef __QNXTARGET__
 /* On QNX targets version is queried explicitly */
 void
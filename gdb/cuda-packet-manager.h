@@ -103,8 +103,17 @@ typedef enum {
     SET_SYMBOLS,
     VERSION_HANDSHAKE,
 #endif /* defined(__QNXTARGET__) || defined(__QNXHOST__) */
+
+    /* New packet types go last so that the numbering of the existing
+       ones, QNX-only ones included, does not change */
+    QUERY_ELF_IMAGE_HASH,
+    SET_REPLY_COMPRESSION,
+    QUERY_TRACE_MESSAGES,
 } cuda_packet_type_t;
 
+/* ELF images are identified by their SHA1 in the client-side cache */
+#define CUDA_ELF_IMAGE_HASH_SIZE 20
+
 class remote_target;
 
 extern int hex2bin (const char *hex, gdb_byte *bin, int count);
@@ -135,6 +144,8 @@ bool cuda_remote_query_async_events (void);
 void cuda_remote_update_grid_id_in_sm (remote_target *ops, uint32_t dev, uint32_t sm);
 void cuda_remote_update_block_idx_in_sm (remote_target *ops, uint32_t dev, uint32_t sm);
 void cuda_remote_update_thread_idx_in_warp (remote_target *ops, uint32_t dev, uint32_t sm, uint32_t wp);
+bool cuda_remote_query_elf_image_hash (remote_target *ops, uint32_t dev, uint64_t handle,
+                                       CUDBGElfImageType type, uint64_t size, gdb_byte *hash);
 #ifdef __QNXTARGET__
 void cuda_remote_set_symbols (remote_target *ops, bool *symbols_are_set);
 #endif /* __QNXTARGET__ */
@@ -150,6 +161,7 @@ bool cuda_remote_check_pending_sigint (remote_target *ops);
 #endif /* __QNXTARGET__ */
 
 void cuda_remote_set_option (remote_target *ops);
+void cuda_remote_set_reply_compression (remote_target *ops);
 void cuda_remote_query_trace_message (remote_target *ops);
 
 #ifdef __QNXTARGET__
@@ -19,6 +19,7 @@
 #include "cuda-regmap.h"
 #include "common/common-defs.h"
 #include "obstack.h"
+#include "hashtab.h"
 #include "cuda-coords.h"
 #include "cuda-state.h"
 #include "cuda-options.h"
@@ -48,6 +49,12 @@
    The 8 high bits of a sass_reg are the register class (see cudadebugger.h).
    The low 24 bits are either the register index, or the offset in local
    memory, or the stack pointer register index and the offset.
+
+   Once loaded, the functions are indexed by name in a hash table. The
+   mappings of each function are grouped per PTX register, the register
+   name being packed into a 64-bit key, and each group is sorted by start
+   address. Searching for a register at a given address is then a binary
+   search over the keys followed by a binary search over the live ranges.
  */
 
 /* Raw value decoding */
@@ -99,7 +106,20 @@ typedef struct {
 } regmap_map_t;
 
 typedef struct {
+  uint64_t key;               /* PTX register name packed into 64 bits */
+  uint32_t max_idx;           /* max location index across all the ranges */
+  uint32_t ranges_no;
+  regmap_map_t **range;       /* mappings for this register sorted by start */
+  uint32_t *max_end;          /* max end of range[0..i] */
+  uint32_t *max_extended_end; /* max extended end of range[0..i] */
+} regmap_reg_t;
+
+typedef struct regmap_func {
   char *name;
+  hashval_t hash;             /* hash of the function name */
+  struct regmap_func *next;   /* next function with the same name */
+  uint32_t regs_no;
+  regmap_reg_t *reg;          /* PTX registers sorted by key */
   uint32_t maps_no;
   regmap_map_t map[0];
 } regmap_func_t;
@@ -107,10 +127,18 @@ typedef struct {
 typedef struct cuda_regmap_table {
   struct objfile *owner;
   struct obstack *obstack;
+  htab_t func_hash;           /* function name -> regmap_func_t */
   uint32_t num_funcs;
   regmap_func_t *func[0];
 } regmap_table_t;
 
+/* Key used to look up a function in the function hash table. The name is
+   not null-terminated when it includes the function parameters. */
+typedef struct {
+  const char *name;
+  size_t len;
+} regmap_func_key_t;
+
 /* Results query routines */
 regmap_t
 regmap_get_search_result (void)
@@ -477,28 +505,75 @@ regmap_read_elf_section (struct objfile *objfile, char **buffer, uint32_t *buffe
   *buffer_size  = size;
 }
 
-/* Extend live range of mapping until the register is used for something else */
+/* Pack a PTX register name, without the leading %, into a 64-bit key.
+   Return false if the name is too long to have been stored in the table. */
+static inline bool
+regmap_pack_reg_name (const char *name, uint64_t *key)
+{
+  char buf[sizeof (uint64_t)];
+  size_t len;
+
+  len = strlen (name);
+  if (len >= sizeof (buf))
+    return false;
+
+  memset (buf, 0, sizeof (buf));
+  memcpy (buf, name, len);
+  memcpy (key, buf, sizeof (buf));
+  return true;
+}
+
+/* Order mappings by register key, then by position in the function */
+static int
+regmap_map_cmp_key (const void *a, const void *b)
+{
+  const regmap_map_t *map_a = *(const regmap_map_t * const *) a;
+  const regmap_map_t *map_b = *(const regmap_map_t * const *) b;
+  uint64_t key_a, key_b;
+
+  memcpy (&key_a, map_a->rname, sizeof (key_a));
+  memcpy (&key_b, map_b->rname, sizeof (key_b));
+
+  if (key_a != key_b)
+    return key_a < key_b ? -1 : 1;
+  if (map_a != map_b)
+    return map_a < map_b ? -1 : 1;
+  return 0;
+}
+
+/* Order mappings by start address, then by position in the function */
+static int
+regmap_map_cmp_start (const void *a, const void *b)
+{
+  const regmap_map_t *map_a = *(const regmap_map_t * const *) a;
+  const regmap_map_t *map_b = *(const regmap_map_t * const *) b;
+
+  if (map_a->start != map_b->start)
+    return map_a->start < map_b->start ? -1 : 1;
+  if (map_a != map_b)
+    return map_a < map_b ? -1 : 1;
+  return 0;
+}
+
+/* Extend live range of mapping until the register is used for something
+   else. The ranges of REG are in the order they appear in the function. */
 static void
-regmap_extend_liverange (regmap_func_t *func)
+regmap_extend_liverange (regmap_reg_t *reg, uint32_t end_max)
 {
   regmap_map_t *map, *map1;
-  regmap_map_t *map_end = &func->map[func->maps_no];
-  uint32_t end_max = 0;
+  uint32_t i, j;
 
-  /* Find the max end for this function */
-  /* PERF: replace me with a lookup of the function's PC range instead */
-  for (map = &func->map[0]; map < map_end; map++)
-    if (end_max < map->end) end_max = map->end;
-
-  for (map = &func->map[0]; map < map_end; map++)
+  for (i = 0; i < reg->ranges_no; i++)
     {
+      map = reg->range[i];
       /* Initialize the extended end to be the end of the function */
       map->extended_end = end_max;
       /* Now look for a range interval that will cover *after* this interval and
          reset the extended interval */
-      for (map1 = &func->map[0]; map1 < map_end; map1++)
+      for (j = 0; j < reg->ranges_no; j++)
         {
-           if (map == map1 || strncmp(map->rname, map1->rname, sizeof(map->rname)) != 0)
+           map1 = reg->range[j];
+           if (map == map1)
                continue;
            if (map1->start >= map->end)
              {
@@ -514,6 +589,114 @@ regmap_extend_liverange (regmap_func_t *func)
     }
 }
 
+/* Group the mappings of a function per PTX register, compute their extended
+   live ranges and build the per-register interval index. */
+static void
+regmap_index_func (regmap_func_t *func, struct obstack *obstack)
+{
+  regmap_map_t **sorted, **range;
+  regmap_reg_t *reg;
+  uint32_t end_max = 0;
+  uint32_t i, j, first;
+
+  func->regs_no = 0;
+  func->reg = NULL;
+  if (func->maps_no == 0)
+    return;
+
+  /* Find the max end for this function */
+  /* PERF: replace me with a lookup of the function's PC range instead */
+  for (i = 0; i < func->maps_no; i++)
+    if (end_max < func->map[i].end)
+      end_max = func->map[i].end;
+
+  /* Group the mappings per register, keeping them in function order */
+  sorted = XOBNEWVEC (obstack, regmap_map_t *, func->maps_no);
+  for (i = 0; i < func->maps_no; i++)
+    sorted[i] = &func->map[i];
+  qsort (sorted, func->maps_no, sizeof (*sorted), regmap_map_cmp_key);
+
+  for (i = 0; i < func->maps_no; i++)
+    if (i == 0 || memcmp (sorted[i - 1]->rname, sorted[i]->rname, sizeof (sorted[i]->rname)) != 0)
+      func->regs_no++;
+  func->reg = XOBNEWVEC (obstack, regmap_reg_t, func->regs_no);
+
+  reg = func->reg;
+  for (first = 0; first < func->maps_no; first = i)
+    {
+      for (i = first + 1; i < func->maps_no; i++)
+        if (memcmp (sorted[first]->rname, sorted[i]->rname, sizeof (sorted[i]->rname)) != 0)
+          break;
+
+      range = &sorted[first];
+      memcpy (&reg->key, range[0]->rname, sizeof (reg->key));
+      reg->ranges_no = i - first;
+      reg->range = range;
+      reg->max_idx = 0;
+      for (j = 0; j < reg->ranges_no; j++)
+        if (range[j]->idx > reg->max_idx)
+          reg->max_idx = range[j]->idx;
+
+      regmap_extend_liverange (reg, end_max);
+
+      /* Sort the ranges by start address and keep the running max of the
+         end addresses, so that all the ranges covering an address can be
+         found by walking back from the last range starting before it. */
+      qsort (range, reg->ranges_no, sizeof (*range), regmap_map_cmp_start);
+      reg->max_end = XOBNEWVEC (obstack, uint32_t, reg->ranges_no);
+      reg->max_extended_end = XOBNEWVEC (obstack, uint32_t, reg->ranges_no);
+      for (j = 0; j < reg->ranges_no; j++)
+        {
+          reg->max_end[j] = range[j]->end;
+          reg->max_extended_end[j] = range[j]->extended_end;
+          if (j > 0 && reg->max_end[j - 1] > reg->max_end[j])
+            reg->max_end[j] = reg->max_end[j - 1];
+          if (j > 0 && reg->max_extended_end[j - 1] > reg->max_extended_end[j])
+            reg->max_extended_end[j] = reg->max_extended_end[j - 1];
+        }
+
+      reg++;
+    }
+}
+
+/* Find the register group for KEY in FUNC or NULL if there is none */
+static regmap_reg_t *
+regmap_func_find_reg (regmap_func_t *func, uint64_t key)
+{
+  uint32_t lo = 0, hi = func->regs_no, mid;
+
+  while (lo < hi)
+    {
+      mid = lo + (hi - lo) / 2;
+      if (func->reg[mid].key == key)
+        return &func->reg[mid];
+      if (func->reg[mid].key < key)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  return NULL;
+}
+
+static hashval_t
+regmap_func_hash (const void *p)
+{
+  const regmap_func_t *func = (const regmap_func_t *) p;
+
+  return func->hash;
+}
+
+static int
+regmap_func_eq (const void *p, const void *k)
+{
+  const regmap_func_t *func = (const regmap_func_t *) p;
+  const regmap_func_key_t *key = (const regmap_func_key_t *) k;
+
+  return strncmp (func->name, key->name, key->len) == 0
+      && func->name[key->len] == 0;
+}
+
 /* Load regmap function record into cacheable in-memory representation */
 static int
 regmap_load_func (regmap_iterator_t *itr, regmap_table_t *table)
@@ -566,7 +749,7 @@ regmap_load_func (regmap_iterator_t *itr, regmap_table_t *table)
       func->maps_no++;
     }
 
-  regmap_extend_liverange (func);
+  regmap_index_func (func, table->obstack);
 
   table->func[table->num_funcs++] = func;
   return 0;
@@ -621,6 +804,25 @@ regmap_load_table (struct objfile *objfile)
 
   xfree (buffer);
 
+  /* Index the functions by name. Functions with the same name are chained
+     in table order. */
+  table->func_hash = htab_create_alloc_ex (table->num_funcs,
+                                           regmap_func_hash, regmap_func_eq,
+                                           NULL, obstack,
+                                           hashtab_obstack_allocate,
+                                           dummy_obstack_deallocate);
+  for (cnt = table->num_funcs; cnt > 0; cnt--)
+    {
+      regmap_func_t *func = table->func[cnt - 1];
+      regmap_func_key_t key = { func->name, strlen (func->name) };
+      void **slot;
+
+      func->hash = iterative_hash (key.name, key.len, 0);
+      slot = htab_find_slot_with_hash (table->func_hash, &key, func->hash, INSERT);
+      func->next = (regmap_func_t *) *slot;
+      *slot = func;
+    }
+
   return table;
 
 err:
@@ -693,22 +895,29 @@ regmap_t
 regmap_table_search (struct objfile *objfile, const char *func_name,
                      const char *reg_name, uint64_t addr)
 {
+  static regmap_map_t **found = NULL;
+  static uint32_t found_allocated = 0;
   const char *tmp;
-  uint32_t func_name_len;
-  uint32_t cnt;
+  regmap_func_key_t key;
+  uint64_t reg_key;
+  uint32_t found_no, lo, hi, mid, i, j;
+  const uint32_t *max_end;
+  bool extrapolation;
   regmap_table_t *table;
   regmap_func_t *func;
-  regmap_map_t  *map, *map_end;
+  regmap_reg_t *reg;
+  regmap_map_t *map;
 
   gdb_assert (objfile);
   gdb_assert (func_name);
   gdb_assert (reg_name && reg_name[0] == '%');
 
   /* Copy the function name to filter out the parameters, if any */
-  func_name_len = strlen (func_name);
+  key.name = func_name;
+  key.len = strlen (func_name);
   tmp = strchr (func_name, '(');
   if (tmp)
-    func_name_len = (unsigned long) tmp - (unsigned long)func_name;
+    key.len = (unsigned long) tmp - (unsigned long)func_name;
 
   /* Initialize the search */
   cuda_regmap->input.func_name           = func_name;
@@ -737,37 +946,69 @@ regmap_table_search (struct objfile *objfile, const char *func_name,
   if (!table || table->num_funcs == 0)
     return cuda_regmap;
 
-  for ( func = table->func[cnt = 0]; cnt < table->num_funcs; func = table->func[++cnt])
+  if (!regmap_pack_reg_name (reg_name + 1, &reg_key))
+    return cuda_regmap;
+
+  extrapolation = cuda_options_value_extrapolation_enabled ();
+
+  func = (regmap_func_t *) htab_find_with_hash (table->func_hash, &key,
+                                                iterative_hash (key.name, key.len, 0));
+  for (; func; func = func->next)
   {
-     if (strncmp (func->name, func_name, func_name_len) != 0
-         || func->name[func_name_len] != 0)
+     reg = regmap_func_find_reg (func, reg_key);
+     if (!reg)
        continue;
-     for (map = &func->map[0], map_end = &func->map[func->maps_no]; map < map_end; map++)
+
+     /* Save the maximum location index encountered for this register name */
+     if (cuda_regmap->output.max_location_index == ~0U ||
+         reg->max_idx > cuda_regmap->output.max_location_index)
+       cuda_regmap->output.max_location_index = reg->max_idx;
+
+     /* Find the ranges starting at or before the address */
+     lo = 0;
+     hi = reg->ranges_no;
+     while (lo < hi)
        {
-         /* Discard this register reg if the register name does not match */
-         if (strcmp (map->rname, reg_name+1) != 0)
+         mid = lo + (hi - lo) / 2;
+         if (reg->range[mid]->start <= addr)
+           lo = mid + 1;
+         else
+           hi = mid;
+       }
+
+     /* Walk back while a range may still cover the address/extended range */
+     max_end = extrapolation ? reg->max_extended_end : reg->max_end;
+     found_no = 0;
+     for (i = lo; i > 0 && addr <= max_end[i - 1]; i--)
+       {
+         map = reg->range[i - 1];
+         if (addr > (extrapolation ? map->extended_end : map->end))
            continue;
 
-         /* Save the maximum location index encountered for this register name */
-         if (cuda_regmap->output.max_location_index == ~0U ||
-             map->idx > cuda_regmap->output.max_location_index)
-           cuda_regmap->output.max_location_index = map->idx;
+         /* Keep the found elements in function order */
+         if (found_no >= found_allocated)
+           {
+             found_allocated += REGMAP_ENTRIES_ALLOC;
+             found = XRESIZEVEC (regmap_map_t *, found, found_allocated);
+           }
+         for (j = found_no++; j > 0 && found[j - 1] > map; j--)
+           found[j] = found[j - 1];
+         found[j] = map;
+       }
 
-         /* Discard this register reg if the address if out of range/extended range */
-         if (addr < map->start ||
-             addr > (cuda_options_value_extrapolation_enabled () ?
-                    map->extended_end : map->end) )
-             continue;
+     for (i = 0; i < found_no; i++)
+       {
+         map = found[i];
 
          /* Ignore upper 64-bit of 128-bit PTX registers */
          if (map->idx > 1)
              continue;
 
-        /* Save the found element in the regmap object */
-        regmap_append (cuda_regmap, map->idx, map->target);
+         /* Save the found element in the regmap object */
+         regmap_append (cuda_regmap, map->idx, map->target);
 
          /* Mark output as extrapolated */
-         if (cuda_options_value_extrapolation_enabled () && addr > map->end)
+         if (extrapolation && addr > map->end)
            cuda_regmap->output.extrapolated = true;
        }
   }
@@ -32,6 +32,7 @@
 #include "cuda-packet-manager.h"
 #include "cuda-options.h"
 #include "cuda-elf-image.h"
+#include "cuda-tdep.h"
 
 #ifdef __ANDROID__
 #undef CUDBG_MAX_DEVICES
@@ -44,11 +45,17 @@ typedef struct {
   bool exception_p;
   bool virtual_pc_p;
   bool timestamp_p;
+  bool call_depth_p;
+  bool syscall_call_depth_p;
+  bool virtual_return_addresses_p;
   CuDim3           thread_idx;
   uint64_t         pc;
   CUDBGException_t exception;
   uint64_t         virtual_pc;
   cuda_clock_t     timestamp;
+  int32_t          call_depth;
+  int32_t          syscall_call_depth;
+  uint64_t        *virtual_return_addresses; /* call_depth entries */
 } lane_state_t;
 
 typedef struct {
@@ -183,6 +190,24 @@ static void lane_set_exception_none       (uint32_t dev_id, uint32_t sm_id, uint
 
 static cuda_system_t cuda_system_info;
 
+/* Release the lane call stacks still cached in DEV before its state is
+   wiped. */
+static void
+device_free_call_stacks (device_state_t *dev)
+{
+  uint32_t sm_id, wp_id, ln_id;
+
+  for (sm_id = 0; sm_id < CUDBG_MAX_SMS; ++sm_id)
+    for (wp_id = 0; wp_id < CUDBG_MAX_WARPS; ++wp_id)
+      for (ln_id = 0; ln_id < CUDBG_MAX_LANES; ++ln_id)
+        {
+          lane_state_t *ln = &dev->sm[sm_id].wp[wp_id].ln[ln_id];
+
+          xfree (ln->virtual_return_addresses);
+          ln->virtual_return_addresses = NULL;
+        }
+}
+
 static void cuda_system_cleanup (void)
 {
   uint32_t dev_id;
@@ -192,7 +217,10 @@ static void cuda_system_cleanup (void)
   cuda_system_info.suspended_devices_mask = 0;
   for (dev_id = 0; dev_id < CUDBG_MAX_DEVICES; ++dev_id)
     if (cuda_system_info.dev[dev_id])
-      memset (cuda_system_info.dev[dev_id], 0, sizeof(device_state_t));
+      {
+        device_free_call_stacks (cuda_system_info.dev[dev_id]);
+        memset (cuda_system_info.dev[dev_id], 0, sizeof(device_state_t));
+      }
 }
 
 void
@@ -412,6 +440,8 @@ device_invalidate (uint32_t dev_id)
     sm_invalidate (dev_id, sm_id, RECURSIVE);
 
   device_invalidate_kernels(dev_id);
+  cuda_pc_cache_invalidate ();
+  cuda_memcache_invalidate_device (dev_id);
 
   dev->valid_p   = false;
 }
@@ -1587,6 +1617,12 @@ lane_invalidate (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id, uint32_t ln_id
   ln->thread_idx_p = false;
   ln->exception_p  = false;
   ln->timestamp_p  = false;
+  ln->call_depth_p = false;
+  ln->syscall_call_depth_p = false;
+  ln->virtual_return_addresses_p = false;
+
+  xfree (ln->virtual_return_addresses);
+  ln->virtual_return_addresses = NULL;
 
   cuda_reg_cache_remove_element (dev_id, sm_id, wp_id, ln_id);
 }
@@ -1870,41 +1906,151 @@ lane_set_cc_register (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id, uint32_t
 int32_t
 lane_get_call_depth (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id, uint32_t ln_id)
 {
+  lane_state_t *ln = lane_get (dev_id, sm_id, wp_id, ln_id);
   int32_t call_depth;
 
   gdb_assert (lane_is_valid (dev_id, sm_id, wp_id, ln_id));
 
+  if (ln->call_depth_p)
+    return ln->call_depth;
+
   cuda_api_read_call_depth (dev_id, sm_id, wp_id, ln_id, &call_depth);
 
+  ln->call_depth   = call_depth;
+  ln->call_depth_p = CACHED;
+
   return call_depth;
 }
 
 int32_t
 lane_get_syscall_call_depth (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id, uint32_t ln_id)
 {
+  lane_state_t *ln = lane_get (dev_id, sm_id, wp_id, ln_id);
   int32_t syscall_call_depth;
 
   gdb_assert (lane_is_valid (dev_id, sm_id, wp_id, ln_id));
 
+  if (ln->syscall_call_depth_p)
+    return ln->syscall_call_depth;
+
   cuda_api_read_syscall_call_depth (dev_id, sm_id, wp_id, ln_id, &syscall_call_depth);
 
+  ln->syscall_call_depth   = syscall_call_depth;
+  ln->syscall_call_depth_p = CACHED;
+
   return syscall_call_depth;
 }
 
+/* Read all the return addresses of the lane call stack at once. Unwinding
+   asks for them one level at a time, several times per level. */
+static void
+lane_update_virtual_return_addresses (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id,
+                                      uint32_t ln_id)
+{
+  lane_state_t *ln = lane_get (dev_id, sm_id, wp_id, ln_id);
+  int32_t call_depth, level;
+
+  if (ln->virtual_return_addresses_p)
+    return;
+
+  call_depth = lane_get_call_depth (dev_id, sm_id, wp_id, ln_id);
+
+  xfree (ln->virtual_return_addresses);
+  ln->virtual_return_addresses = call_depth > 0 ? XNEWVEC (uint64_t, call_depth) : NULL;
+  for (level = 0; level < call_depth; ++level)
+    cuda_api_read_virtual_return_address (dev_id, sm_id, wp_id, ln_id, level,
+                                          &ln->virtual_return_addresses[level]);
+
+  ln->virtual_return_addresses_p = CACHED;
+}
+
 uint64_t
 lane_get_virtual_return_address (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id,
                                  uint32_t ln_id, int32_t level)
 {
+  lane_state_t *ln = lane_get (dev_id, sm_id, wp_id, ln_id);
   uint64_t virtual_return_address;
 
   gdb_assert (lane_is_valid (dev_id, sm_id, wp_id, ln_id));
 
+  if (level >= 0 && level < lane_get_call_depth (dev_id, sm_id, wp_id, ln_id))
+    {
+      lane_update_virtual_return_addresses (dev_id, sm_id, wp_id, ln_id);
+      return ln->virtual_return_addresses[level];
+    }
+
   cuda_api_read_virtual_return_address (dev_id, sm_id, wp_id, ln_id, level,
                                              &virtual_return_address);
 
   return virtual_return_address;
 }
 
+/* Fetch the call stack (call depths and return addresses) of every valid
+   lane of the warp, so that unwinding any of them is served from the
+   cache. */
+void
+warp_update_call_stacks (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id)
+{
+  uint64_t valid_lanes_mask;
+  uint32_t ln_id;
+
+  valid_lanes_mask = warp_get_valid_lanes_mask (dev_id, sm_id, wp_id);
+
+  for (ln_id = 0; ln_id < device_get_num_lanes (dev_id); ++ln_id)
+    {
+      if (!((valid_lanes_mask >> ln_id) & 1))
+        continue;
+
+      lane_get_syscall_call_depth (dev_id, sm_id, wp_id, ln_id);
+      lane_update_virtual_return_addresses (dev_id, sm_id, wp_id, ln_id);
+    }
+}
+
+/* Read into the register cache of every valid lane of the warp the
+   registers cached for lane MODEL_LN, with a single backend call per lane.
+   The lanes of a warp run the same code, so they are likely to need the
+   same registers. */
+void
+warp_prefetch_registers (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id, uint32_t model_ln)
+{
+  cuda_reg_cache_element_t *elem;
+  uint64_t valid_lanes_mask;
+  uint32_t ln_id, chunk, first, last;
+  bool cached;
+
+  /* the 32-register chunks read for the model lane */
+  elem = cuda_reg_cache_find_element (dev_id, sm_id, wp_id, model_ln);
+  for (chunk = 0, first = ~0U, last = 0; chunk < CUDBG_CACHED_REGISTERS_COUNT >> 5; ++chunk)
+    if (elem->register_valid_mask[chunk] == 0xffffffff)
+      {
+        if (first == ~0U)
+          first = chunk;
+        last = chunk;
+      }
+
+  if (first == ~0U)
+    return;
+
+  valid_lanes_mask = warp_get_valid_lanes_mask (dev_id, sm_id, wp_id);
+
+  for (ln_id = 0; ln_id < device_get_num_lanes (dev_id); ++ln_id)
+    {
+      if (ln_id == model_ln || !((valid_lanes_mask >> ln_id) & 1))
+        continue;
+
+      elem = cuda_reg_cache_find_element (dev_id, sm_id, wp_id, ln_id);
+      for (chunk = first, cached = true; chunk <= last && cached; ++chunk)
+        cached = elem->register_valid_mask[chunk] == 0xffffffff;
+      if (cached)
+        continue;
+
+      cuda_api_read_register_range (dev_id, sm_id, wp_id, ln_id, first << 5,
+                                    (last - first + 1) << 5, &elem->registers[first << 5]);
+      for (chunk = first; chunk <= last; ++chunk)
+        elem->register_valid_mask[chunk] = 0xffffffff;
+    }
+}
+
 cuda_clock_t
 lane_get_timestamp (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id,uint32_t ln_id)
 {
@@ -103,6 +103,8 @@ bool     warp_get_upredicate           (uint32_t dev_id, uint32_t sm_id, uint32_
 void     warp_set_uregister            (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id, uint32_t regno, uint32_t value);
 void    warp_set_upredicate            (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id, uint32_t predicate, bool value);
 
+void     warp_update_call_stacks       (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id);
+void     warp_prefetch_registers       (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id, uint32_t model_ln);
 bool     warp_single_step              (uint32_t dev_id, uint32_t sm_id, uint32_t wp_id, uint32_t nsteps, cuda_api_warpmask *single_stepped_warp_mask);
 bool     warps_resume_until            (uint32_t dev_id, uint32_t sm_id, cuda_api_warpmask* wp_mask, uint64_t pc);
 
@@ -67,8 +67,11 @@
 #include "exceptions.h"
 #include "breakpoint.h"
 #include "reggroups.h"
+#include "observable.h"
+#include "progspace.h"
 
 #include "common/common-defs.h"
+#include "common/byte-vector.h"
 
 #include "elf-bfd.h"
 
@@ -92,6 +95,11 @@
 #include "mach-o.h"
 #include "cuda-regmap.h"
 #include "self-bt.h"
+
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <vector>
 #ifdef __QNXTARGET__
 # include "remote-cuda.h"
 #endif /* __QNXTARDET__ */
@@ -337,8 +345,44 @@ cuda_inferior_word_size (void)
   return -1;
 }
 
-const char *
-cuda_find_function_name_from_pc (CORE_ADDR pc, bool demangle)
+/* PC lookups cache. Bulk listings (info cuda threads, kernel launches)
+   query the same handful of device PCs for every thread. The answers only
+   depend on the loaded objfiles, but the cache is dropped on every stop and
+   whenever the objfiles change so that it stays small and never refers to
+   freed symtabs. */
+
+struct cuda_pc_function_name
+{
+  bool found;
+  std::string name;
+};
+
+static std::unordered_map<CORE_ADDR, symtab_and_line> cuda_pc_line_cache;
+static std::unordered_map<CORE_ADDR, cuda_pc_function_name> cuda_pc_name_cache[2];
+
+void
+cuda_pc_cache_invalidate (void)
+{
+  cuda_pc_line_cache.clear ();
+  cuda_pc_name_cache[0].clear ();
+  cuda_pc_name_cache[1].clear ();
+}
+
+struct symtab_and_line
+cuda_find_pc_line (CORE_ADDR pc)
+{
+  auto it = cuda_pc_line_cache.find (pc);
+  if (it != cuda_pc_line_cache.end ())
+    return it->second;
+
+  struct symtab_and_line sal = find_pc_line (pc, 0);
+  cuda_pc_line_cache.emplace (pc, sal);
+  return sal;
+}
+
+static bool
+cuda_find_function_name_from_pc_1 (CORE_ADDR pc, bool demangle,
+                                   std::string *result)
 {
   char *demangled = NULL;
   const char *name = NULL;
@@ -368,19 +412,41 @@ cuda_find_function_name_from_pc (CORE_ADDR pc, bool demangle)
 
   /* Return early, if name is not found */
   if (!name)
-    return name;
+    return false;
 
   /* process the mangled name */
-  else if (demangle)
+  if (demangle)
+    demangled = language_demangle (language_def (lang), name, DMGL_ANSI);
+
+  if (demangled)
     {
-      demangled = language_demangle (language_def (lang), name, DMGL_ANSI);
-      if (demangled)
-        return demangled;
-      else
-        return name;
+      *result = demangled;
+      xfree (demangled);
     }
   else
-    return name;
+    *result = name;
+
+  return true;
+}
+
+/* The returned name is owned by the PC cache and remains valid until the
+   next stop or objfile change. */
+const char *
+cuda_find_function_name_from_pc (CORE_ADDR pc, bool demangle)
+{
+  auto &cache = cuda_pc_name_cache[demangle ? 1 : 0];
+  auto it = cache.find (pc);
+
+  if (it == cache.end ())
+    {
+      cuda_pc_function_name entry;
+
+      entry.found = cuda_find_function_name_from_pc_1 (pc, demangle,
+                                                       &entry.name);
+      it = cache.emplace (pc, std::move (entry)).first;
+    }
+
+  return it->second.found ? it->second.name.c_str () : NULL;
 }
 
 ATTRIBUTE_PRINTF(2, 0) void
@@ -1076,46 +1142,226 @@ cuda_print_insn (bfd_vma pc, disassemble_info *info)
   return inst_size;
 }
 
-bool
-cuda_is_device_code_address (CORE_ADDR addr)
+/* Code address map
+
+   Sorted intervals of the device code sections and of the host sections of
+   the objfiles of a program space, so that an address can be classified
+   without walking every section of every objfile. The map is rebuilt
+   lazily after objfiles are added, removed or relocated. Answers from the
+   backend for addresses outside of any objfile are cached until then too,
+   since device code only appears or disappears with device ELF images.
+   That cache is bounded and simply dropped once full, so that long
+   single-stepping sessions outside of known code do not grow it forever. */
+
+#define CUDA_CODE_MAP_BACKEND_MAX 4096
+
+struct cuda_code_range
+{
+  CORE_ADDR start;
+  CORE_ADDR end;
+  struct objfile *objfile;  /* the device objfile, NULL for host ranges */
+  elf_image_t elf_image;    /* the ELF image of the device objfile, if known */
+};
+
+struct cuda_code_map
+{
+  bool dirty = true;
+
+  /* device code sections sorted by start address, with the max end address
+     of device[0..i] to handle overlapping sections */
+  std::vector<cuda_code_range> device;
+  std::vector<CORE_ADDR> device_max_end;
+
+  /* merged host section ranges sorted by start address */
+  std::vector<cuda_code_range> host;
+
+  /* cached backend answers for addresses in neither */
+  std::unordered_map<CORE_ADDR, bool> backend;
+};
+
+static const struct program_space_data *cuda_code_map_data;
+
+static void
+cuda_code_map_cleanup (struct program_space *pspace, void *arg)
+{
+  delete (struct cuda_code_map *) arg;
+}
+
+static struct cuda_code_map *
+cuda_code_map_get (struct program_space *pspace)
+{
+  struct cuda_code_map *map;
+
+  map = (struct cuda_code_map *) program_space_data (pspace, cuda_code_map_data);
+  if (map == NULL)
+    {
+      map = new struct cuda_code_map;
+      set_program_space_data (pspace, cuda_code_map_data, map);
+    }
+
+  return map;
+}
+
+void
+cuda_code_map_invalidate (struct program_space *pspace)
+{
+  struct cuda_code_map *map;
+
+  cuda_pc_cache_invalidate ();
+  kernels_launch_filter_invalidate ();
+
+  map = (struct cuda_code_map *) program_space_data (pspace, cuda_code_map_data);
+  if (map != NULL && !map->dirty)
+    {
+      map->dirty = true;
+      map->backend.clear ();
+    }
+}
+
+static void
+cuda_code_map_new_objfile (struct objfile *objfile)
+{
+  cuda_code_map_invalidate (objfile ? objfile->pspace : current_program_space);
+}
+
+static void
+cuda_code_map_free_objfile (struct objfile *objfile)
+{
+  cuda_code_map_invalidate (objfile->pspace);
+}
+
+static bool
+cuda_code_range_less (const cuda_code_range &a, const cuda_code_range &b)
+{
+  return a.start < b.start;
+}
+
+static void
+cuda_code_map_build (struct program_space *pspace, struct cuda_code_map *map)
 {
   struct obj_section *osect = NULL;
   asection           *section = NULL;
-  bool found_in_cpu_symtab = false;
-  bool is_cuda_addr = false;
+  std::vector<cuda_code_range> host;
+  CORE_ADDR max_end = 0;
 
-  /* Zero and (CORE_ADDR)-1 are CPU addresses */
-  if (addr == 0 || addr == (CORE_ADDR)-1LL)
-    return false;
+  map->device.clear ();
+  map->device_max_end.clear ();
+  map->host.clear ();
+  map->backend.clear ();
 
-  /*Iterate over all ELF sections */
-  for (objfile *objfile : current_program_space->objfiles ())
-    ALL_OBJFILE_OSECTIONS(objfile, osect)
+  for (objfile *objfile : pspace->objfiles ())
+    ALL_OBJFILE_OSECTIONS (objfile, osect)
       {
         section = osect->the_bfd_section;
         if (!section) continue;
-        /* Check if addr belongs to CUDA ELF */
         if (objfile->cuda_objfile)
           {
             /* Skip sections that do not have code */
-            if (!(section->flags & SEC_CODE))
+            if (!(section->flags & SEC_CODE) || section->size == 0)
               continue;
-            if (section->vma > addr || section->vma + section->size <= addr)
-              continue;
-            return true;
+            map->device.push_back ({ section->vma, section->vma + section->size,
+                                     objfile, NULL });
           }
-
-        /* Check if address belongs to one of the host ELFs */
-        if (obj_section_addr(osect) <= addr && obj_section_endaddr(osect) > addr)
-          found_in_cpu_symtab = true;
+        else if (obj_section_addr (osect) < obj_section_endaddr (osect))
+          host.push_back ({ obj_section_addr (osect), obj_section_endaddr (osect),
+                            NULL, NULL });
       }
 
+  std::stable_sort (map->device.begin (), map->device.end (), cuda_code_range_less);
+  for (const cuda_code_range &range : map->device)
+    {
+      max_end = std::max (max_end, range.end);
+      map->device_max_end.push_back (max_end);
+    }
+
+  /* Host ranges only tell whether an address is known, merge them */
+  std::sort (host.begin (), host.end (), cuda_code_range_less);
+  for (const cuda_code_range &range : host)
+    if (!map->host.empty () && range.start <= map->host.back ().end)
+      map->host.back ().end = std::max (map->host.back ().end, range.end);
+    else
+      map->host.push_back (range);
+
+  map->dirty = false;
+}
+
+/* Return the device code range of the current program space containing
+   ADDR, or NULL if there is none. */
+static struct cuda_code_range *
+cuda_code_map_find_device_range (CORE_ADDR addr)
+{
+  struct cuda_code_map *map = cuda_code_map_get (current_program_space);
+  cuda_code_range key = { addr, addr, NULL, NULL };
+  size_t idx;
+
+  if (map->dirty)
+    cuda_code_map_build (current_program_space, map);
+
+  /* Walk back from the last range starting at or before ADDR */
+  idx = std::upper_bound (map->device.begin (), map->device.end (), key,
+                          cuda_code_range_less) - map->device.begin ();
+  for (; idx > 0 && addr < map->device_max_end[idx - 1]; idx--)
+    if (addr < map->device[idx - 1].end)
+      return &map->device[idx - 1];
+
+  return NULL;
+}
+
+static bool
+cuda_code_map_is_host_address (CORE_ADDR addr)
+{
+  struct cuda_code_map *map = cuda_code_map_get (current_program_space);
+  cuda_code_range key = { addr, addr, NULL, NULL };
+  auto it = std::upper_bound (map->host.begin (), map->host.end (), key,
+                              cuda_code_range_less);
+
+  return it != map->host.begin () && addr < (it - 1)->end;
+}
+
+/* Return the loaded ELF image whose code contains ADDR, or NULL */
+elf_image_t
+cuda_find_elf_image_by_address (CORE_ADDR addr)
+{
+  struct cuda_code_range *range = cuda_code_map_find_device_range (addr);
+
+  if (!range)
+    return NULL;
+
+  /* The objfile is created before the ELF image is marked as loaded */
+  if (!range->elf_image)
+    range->elf_image = cuda_get_elf_image_by_objfile (range->objfile);
+
+  return range->elf_image;
+}
+
+bool
+cuda_is_device_code_address (CORE_ADDR addr)
+{
+  struct cuda_code_map *map;
+  bool is_cuda_addr = false;
+
+  /* Zero and (CORE_ADDR)-1 are CPU addresses */
+  if (addr == 0 || addr == (CORE_ADDR)-1LL)
+    return false;
+
+  /* Check if addr belongs to CUDA ELF */
+  if (cuda_code_map_find_device_range (addr))
+    return true;
+
   /* If address was found on CPU and wasn't found on any of the CUDA ELFs - return false */
-  if (found_in_cpu_symtab)
+  if (cuda_code_map_is_host_address (addr))
     return false;
 
   /* Fallback to backend API call */
+  map = cuda_code_map_get (current_program_space);
+  auto it = map->backend.find (addr);
+  if (it != map->backend.end ())
+    return it->second;
+
   cuda_api_is_device_code_address ((uint64_t)addr, &is_cuda_addr);
+  if (map->backend.size () >= CUDA_CODE_MAP_BACKEND_MAX)
+    map->backend.clear ();
+  map->backend[addr] = is_cuda_addr;
   return is_cuda_addr;
 }
 
@@ -1371,6 +1617,8 @@ cuda_cleanup (void)
   cuda_cleanup_cudart_symbols ();
   cuda_cleanup_tex_maps ();
   cuda_coords_reset_current ();
+  cuda_pc_cache_invalidate ();
+  cuda_memcache_invalidate ();
   cuda_system_cleanup_contexts ();
   if (cuda_initialized)
     cuda_system_finalize ();
@@ -1831,6 +2079,286 @@ read_cudart_variable (uint64_t address, void * buffer, unsigned amount)
 }
 
 
+/* Device memory read cache. Value printing reads aggregates one field
+   or element at a time, and each read is a round trip to the backend.
+   Reads of device memory are therefore served in whole lines, kept per
+   memory space and per coordinates the space depends on. Lines are
+   dropped when the device is resumed or invalidated and on any write,
+   and evicted in LRU order beyond the configured number of lines. */
+
+enum cuda_memcache_space
+{
+  CUDA_MEMCACHE_CODE,
+  CUDA_MEMCACHE_CONST,
+  CUDA_MEMCACHE_GENERIC,
+  CUDA_MEMCACHE_PARAM,
+  CUDA_MEMCACHE_SHARED,
+  CUDA_MEMCACHE_LOCAL,
+};
+
+struct cuda_memcache_key
+{
+  enum cuda_memcache_space space;
+  uint32_t dev, sm, wp, ln;
+  CORE_ADDR line;
+
+  bool operator== (const cuda_memcache_key &other) const
+  {
+    return space == other.space && dev == other.dev && sm == other.sm
+           && wp == other.wp && ln == other.ln && line == other.line;
+  }
+};
+
+struct cuda_memcache_key_hash
+{
+  size_t operator() (const cuda_memcache_key &key) const
+  {
+    size_t h = std::hash<CORE_ADDR> () (key.line);
+    h = h * 31 + key.space;
+    h = h * 31 + key.dev;
+    h = h * 31 + key.sm;
+    h = h * 31 + key.wp;
+    h = h * 31 + key.ln;
+    return h;
+  }
+};
+
+struct cuda_memcache_line
+{
+  cuda_memcache_key key;
+  gdb::byte_vector data;
+};
+
+/* Most recently used line first */
+static std::list<cuda_memcache_line> cuda_memcache_lru;
+static std::unordered_map<cuda_memcache_key,
+                          std::list<cuda_memcache_line>::iterator,
+                          cuda_memcache_key_hash> cuda_memcache_lines;
+
+void
+cuda_memcache_invalidate (void)
+{
+  cuda_memcache_lines.clear ();
+  cuda_memcache_lru.clear ();
+}
+
+void
+cuda_memcache_invalidate_device (uint32_t dev)
+{
+  auto it = cuda_memcache_lru.begin ();
+  while (it != cuda_memcache_lru.end ())
+    if (it->key.dev == dev)
+      {
+        cuda_memcache_lines.erase (it->key);
+        it = cuda_memcache_lru.erase (it);
+      }
+    else
+      ++it;
+}
+
+/* Read LEN bytes at ADDRESS of the memory space designated by KEY
+   straight from the backend. */
+static void
+cuda_memcache_fetch (const cuda_memcache_key &key, CORE_ADDR address,
+                     gdb_byte *buf, uint32_t len)
+{
+  switch (key.space)
+    {
+    case CUDA_MEMCACHE_CODE:
+      cuda_api_read_code_memory (key.dev, address, buf, len);
+      break;
+    case CUDA_MEMCACHE_CONST:
+      cuda_api_read_const_memory (key.dev, address, buf, len);
+      break;
+    case CUDA_MEMCACHE_GENERIC:
+      cuda_api_read_generic_memory (key.dev, key.sm, key.wp, key.ln, address, buf, len);
+      break;
+    case CUDA_MEMCACHE_PARAM:
+      cuda_api_read_param_memory (key.dev, key.sm, key.wp, address, buf, len);
+      break;
+    case CUDA_MEMCACHE_SHARED:
+      cuda_api_read_shared_memory (key.dev, key.sm, key.wp, address, buf, len);
+      break;
+    case CUDA_MEMCACHE_LOCAL:
+      cuda_api_read_local_memory (key.dev, key.sm, key.wp, key.ln, address, buf, len);
+      break;
+    default:
+      gdb_assert_not_reached ("unknown memory cache space");
+    }
+}
+
+static void
+cuda_memcache_insert (const cuda_memcache_key &key, const gdb_byte *data,
+                      uint32_t line_size, unsigned int max_lines)
+{
+  while (cuda_memcache_lines.size () >= max_lines)
+    {
+      cuda_memcache_lines.erase (cuda_memcache_lru.back ().key);
+      cuda_memcache_lru.pop_back ();
+    }
+
+  cuda_memcache_lru.push_front ({key, gdb::byte_vector (data, data + line_size)});
+  cuda_memcache_lines.emplace (key, cuda_memcache_lru.begin ());
+}
+
+/* Read LEN bytes at ADDRESS of the memory space designated by KEY,
+   through the cache. Consecutive missing lines are fetched with a
+   single backend call. If the whole lines cannot be read, e.g. at the
+   end of a memory segment, fall back to an exact read of the requested
+   bytes. */
+static void
+cuda_memcache_read (cuda_memcache_key key, CORE_ADDR address, gdb_byte *buf, int len)
+{
+  unsigned int max_lines = cuda_options_memory_cache_lines ();
+  uint32_t line_size = cuda_options_memory_cache_line_size ();
+  CORE_ADDR first, last, line, run_end, lo, hi;
+
+  if (len <= 0)
+    return;
+
+  first = address & ~(CORE_ADDR)(line_size - 1);
+  last  = (address + len - 1) & ~(CORE_ADDR)(line_size - 1);
+
+  /* Too large to be worth caching */
+  if (max_lines == 0 || last < first || (last - first) / line_size >= max_lines)
+    {
+      cuda_memcache_fetch (key, address, buf, len);
+      return;
+    }
+
+  for (line = first; ; line = run_end + line_size)
+    {
+      key.line = line;
+      auto it = cuda_memcache_lines.find (key);
+      if (it != cuda_memcache_lines.end ())
+        {
+          /* Hit: move to the front of the LRU list */
+          cuda_memcache_lru.splice (cuda_memcache_lru.begin (), cuda_memcache_lru, it->second);
+          lo = std::max (address, line);
+          hi = std::min (address + len, line + line_size);
+          memcpy (buf + (lo - address), it->second->data.data () + (lo - line), hi - lo);
+          run_end = line;
+        }
+      else
+        {
+          /* Miss: extend the run over the following missing lines */
+          for (run_end = line; run_end != last; run_end += line_size)
+            {
+              key.line = run_end + line_size;
+              if (cuda_memcache_lines.count (key))
+                break;
+            }
+
+          lo = std::max (address, line);
+          hi = std::min (address + len, run_end + line_size);
+
+          gdb::byte_vector data (run_end - line + line_size);
+          bool fetched = false;
+          TRY
+            {
+              cuda_memcache_fetch (key, line, data.data (), data.size ());
+              fetched = true;
+            }
+          CATCH (except, RETURN_MASK_ERROR)
+            {
+            }
+          END_CATCH
+
+          if (!fetched)
+            cuda_memcache_fetch (key, lo, buf + (lo - address), hi - lo);
+          else
+            {
+              memcpy (buf + (lo - address), data.data () + (lo - line), hi - lo);
+              for (CORE_ADDR l = line; l <= run_end; l += line_size)
+                {
+                  key.line = l;
+                  cuda_memcache_insert (key, data.data () + (l - line),
+                                        line_size, max_lines);
+                }
+            }
+        }
+
+      if (run_end == last)
+        break;
+    }
+}
+
+/* Read the generic and local memory lines cached for lane MODEL_LN into
+   the cache of every other valid lane of the warp, with a single backend
+   call per lane and memory space. The lanes of a warp run the same code,
+   so their locals are likely at the same addresses. Nothing is read if
+   the lines of the whole warp would not fit in the cache. */
+void
+cuda_memcache_prefetch_warp (uint32_t dev, uint32_t sm, uint32_t wp, uint32_t model_ln)
+{
+  unsigned int max_lines = cuda_options_memory_cache_lines ();
+  uint32_t line_size = cuda_options_memory_cache_line_size ();
+  uint64_t valid_lanes_mask;
+  uint32_t ln, num_lanes;
+  CORE_ADDR first, last, line;
+  bool fetched;
+
+  valid_lanes_mask = warp_get_valid_lanes_mask (dev, sm, wp);
+  num_lanes = __builtin_popcountll (valid_lanes_mask);
+
+  for (auto space : { CUDA_MEMCACHE_GENERIC, CUDA_MEMCACHE_LOCAL })
+    {
+      /* the lines read for the model lane */
+      first = ~(CORE_ADDR) 0;
+      last = 0;
+      for (const auto &cached : cuda_memcache_lru)
+        if (cached.key.space == space && cached.key.dev == dev && cached.key.sm == sm &&
+            cached.key.wp == wp && cached.key.ln == model_ln)
+          {
+            first = std::min (first, cached.key.line);
+            last = std::max (last, cached.key.line);
+          }
+
+      if (first > last || ((last - first) / line_size + 1) * num_lanes > max_lines)
+        continue;
+
+      gdb::byte_vector data (last - first + line_size);
+      for (ln = 0; ln < device_get_num_lanes (dev); ++ln)
+        {
+          cuda_memcache_key key = { space, dev, sm, wp, ln, first };
+
+          if (ln == model_ln || !((valid_lanes_mask >> ln) & 1) ||
+              cuda_memcache_lines.count (key))
+            continue;
+
+          fetched = false;
+          TRY
+            {
+              cuda_memcache_fetch (key, first, data.data (), data.size ());
+              fetched = true;
+            }
+          CATCH (except, RETURN_MASK_ERROR)
+            {
+            }
+          END_CATCH
+
+          if (!fetched)
+            continue;
+
+          for (line = first; line <= last; line += line_size)
+            {
+              key.line = line;
+              if (!cuda_memcache_lines.count (key))
+                cuda_memcache_insert (key, data.data () + (line - first),
+                                      line_size, max_lines);
+            }
+        }
+    }
+}
+
+/* Host memory writes may land in pinned or managed memory */
+static void
+cuda_memcache_memory_changed (struct inferior *inferior, CORE_ADDR addr,
+                              ssize_t len, const bfd_byte *data)
+{
+  cuda_memcache_invalidate ();
+}
+
 static int cuda_read_memory_nonfocused(CORE_ADDR address, gdb_byte *buf, int len, struct type *type)
 {
   if (TYPE_CUDA_GLOBAL(type))
@@ -1887,17 +2415,17 @@ cuda_read_memory_partial (CORE_ADDR address, gdb_byte *buf, int len, struct type
         return 1;
 
       if (TYPE_CUDA_CODE(type))
-        cuda_api_read_code_memory (dev, address, buf, len);
+        cuda_memcache_read ({CUDA_MEMCACHE_CODE, dev, 0, 0, 0, 0}, address, buf, len);
       else if (TYPE_CUDA_CONST(type))
-        cuda_api_read_const_memory (dev, address, buf, len);
+        cuda_memcache_read ({CUDA_MEMCACHE_CONST, dev, 0, 0, 0, 0}, address, buf, len);
       else if (TYPE_CUDA_GENERIC(type))
-        cuda_api_read_generic_memory (dev, sm, wp, ln, address, buf, len);
+        cuda_memcache_read ({CUDA_MEMCACHE_GENERIC, dev, sm, wp, ln, 0}, address, buf, len);
       else if (TYPE_CUDA_GLOBAL(type))
-        cuda_api_read_generic_memory (dev, sm, wp, ln, address, buf, len);
+        cuda_memcache_read ({CUDA_MEMCACHE_GENERIC, dev, sm, wp, ln, 0}, address, buf, len);
       else if (TYPE_CUDA_PARAM(type))
-        cuda_api_read_param_memory (dev, sm, wp, address, buf, len);
+        cuda_memcache_read ({CUDA_MEMCACHE_PARAM, dev, sm, wp, 0, 0}, address, buf, len);
       else if (TYPE_CUDA_SHARED(type))
-        cuda_api_read_shared_memory (dev, sm, wp, address, buf, len);
+        cuda_memcache_read ({CUDA_MEMCACHE_SHARED, dev, sm, wp, 0, 0}, address, buf, len);
       else if (TYPE_CUDA_TEX(type))
         {
           cuda_texture_dereference_tex_contents (address, &tex_id, &dim, &coords, &is_bindless);
@@ -1907,7 +2435,7 @@ cuda_read_memory_partial (CORE_ADDR address, gdb_byte *buf, int len, struct type
             cuda_api_read_texture_memory (dev, sm, wp, tex_id, dim, coords, buf, len);
         }
       else if (TYPE_CUDA_LOCAL(type))
-        cuda_api_read_local_memory (dev, sm, wp, ln, address, buf, len);
+        cuda_memcache_read ({CUDA_MEMCACHE_LOCAL, dev, sm, wp, ln, 0}, address, buf, len);
       else
         error (_("Unknown storage specifier."));
       return 0;
@@ -3171,6 +3699,12 @@ void
 _initialize_cuda_tdep (void)
 {
   register_gdbarch_init (bfd_arch_m68k, cuda_gdbarch_init);
+
+  cuda_code_map_data
+    = register_program_space_data_with_cleanup (NULL, cuda_code_map_cleanup);
+  gdb::observers::new_objfile.attach (cuda_code_map_new_objfile);
+  gdb::observers::free_objfile.attach (cuda_code_map_free_objfile);
+  gdb::observers::memory_changed.attach (cuda_memcache_memory_changed);
 }
 
 bool
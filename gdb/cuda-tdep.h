@@ -132,6 +132,11 @@ void cuda_initialize_driver_api_error_report (void);
 void cuda_update_report_driver_api_error_flags (void);
 
 const char *cuda_find_function_name_from_pc (CORE_ADDR pc, bool demangle);
+struct symtab_and_line cuda_find_pc_line (CORE_ADDR pc);
+void     cuda_pc_cache_invalidate (void);
+void     cuda_memcache_invalidate (void);
+void     cuda_memcache_invalidate_device (uint32_t dev);
+void     cuda_memcache_prefetch_warp (uint32_t dev, uint32_t sm, uint32_t wp, uint32_t model_ln);
 bool     cuda_breakpoint_hit_p (cuda_clock_t clock);
 
 uint64_t cuda_get_last_driver_api_error_code (void);
@@ -202,6 +207,8 @@ CORE_ADDR       cuda_dwarf2_func_baseaddr (struct objfile *objfile, char *func_n
 bool            cuda_find_pc_from_address_string (struct objfile *objfile, char *func_name, CORE_ADDR *func_addr);
 bool            cuda_find_func_text_vma_from_objfile (struct objfile *objfile, char *func_name, CORE_ADDR *vma);
 bool            cuda_is_device_code_address (CORE_ADDR addr);
+elf_image_t     cuda_find_elf_image_by_address (CORE_ADDR addr);
+void            cuda_code_map_invalidate (struct program_space *pspace);
 int             cuda_abi_sp_regnum (struct gdbarch *);
 int             cuda_special_regnum (struct gdbarch *);
 int             cuda_pc_regnum (struct gdbarch *);
@@ -549,37 +549,79 @@ cuda_gdb_bypass_signals (void)
   return make_cleanup (cuda_nat_bypass_signals_cleanup, sigs);
 }
 
-/* CUDA PTX registers cache */
+/* CUDA PTX registers cache. The cache only holds values for one lane
+   (cuda_ptx_cache_coords) and is indexed by (frame id, dwarf regnum). */
 struct cuda_ptx_cache_element {
   struct frame_id frame_id;
-  cuda_coords_t coords;
   int dwarf_regnum;
   char data[16];
   int len;
 };
 typedef struct cuda_ptx_cache_element cuda_ptx_cache_element_t;
-DEF_VEC_O(cuda_ptx_cache_element_t);
 
-static VEC(cuda_ptx_cache_element_t) *cuda_ptx_register_cache = NULL;
+static htab_t cuda_ptx_register_cache = NULL;
+static cuda_coords_t cuda_ptx_cache_coords;
 
-/* Searches for cache entry containing given dwarf register for a given frame */
-static cuda_ptx_cache_element_t *
-cuda_ptx_cache_find_element (struct frame_id frame_id, int dwarf_regnum)
+/* Only the stack address is hashed: frame_id_eq treats a missing code
+   address as a wildcard. */
+static hashval_t
+cuda_ptx_cache_hash (const void *p)
 {
-  int idx;
-  struct cuda_ptx_cache_element *elem;
+  const cuda_ptx_cache_element_t *elem = (const cuda_ptx_cache_element_t *) p;
+  hashval_t hash;
+
+  hash = iterative_hash_object (elem->frame_id.stack_addr, 0);
+  return iterative_hash_object (elem->dwarf_regnum, hash);
+}
+
+static int
+cuda_ptx_cache_eq (const void *p1, const void *p2)
+{
+  const cuda_ptx_cache_element_t *e1 = (const cuda_ptx_cache_element_t *) p1;
+  const cuda_ptx_cache_element_t *e2 = (const cuda_ptx_cache_element_t *) p2;
+
+  return e1->dwarf_regnum == e2->dwarf_regnum &&
+         frame_id_eq (e1->frame_id, e2->frame_id);
+}
+
+static void
+cuda_ptx_cache_clear (void)
+{
+  if (cuda_ptx_register_cache)
+    htab_empty (cuda_ptx_register_cache);
+}
+
+/* Searches for the slot of the given dwarf register for a given frame of
+   the lane in focus. Returns NULL if the focus is not on a device. */
+static void **
+cuda_ptx_cache_find_slot (struct frame_id frame_id, int dwarf_regnum, enum insert_option insert)
+{
+  cuda_ptx_cache_element_t key;
   cuda_coords_t coords;
 
-  if (cuda_coords_get_current (&coords)) return NULL;
+  if (cuda_coords_get_current (&coords))
+    return NULL;
 
-  for (idx =0;
-       VEC_iterate (cuda_ptx_cache_element_t, cuda_ptx_register_cache, idx, elem);
-       idx++)
-    if (cuda_coords_equal (&coords, &elem->coords) &&
-        frame_id_eq (frame_id, elem->frame_id) &&
-        elem->dwarf_regnum == dwarf_regnum) return elem;
+  if (!cuda_ptx_register_cache)
+    {
+      if (insert == NO_INSERT)
+        return NULL;
+      cuda_ptx_register_cache = htab_create_alloc (64, cuda_ptx_cache_hash, cuda_ptx_cache_eq,
+                                                   xfree, xcalloc, xfree);
+    }
 
-  return NULL;
+  /* The cached values belong to another lane */
+  if (!cuda_coords_equal (&coords, &cuda_ptx_cache_coords))
+    {
+      if (insert == NO_INSERT)
+        return NULL;
+      cuda_ptx_cache_clear ();
+      cuda_ptx_cache_coords = coords;
+    }
+
+  key.frame_id = frame_id;
+  key.dwarf_regnum = dwarf_regnum;
+  return htab_find_slot (cuda_ptx_register_cache, &key, insert);
 }
 
 
@@ -590,32 +632,34 @@ cuda_ptx_cache_find_element (struct frame_id frame_id, int dwarf_regnum)
 void
 cuda_ptx_cache_store_register (struct frame_info *frame, int dwarf_regnum, struct value *value)
 {
-  struct cuda_ptx_cache_element new_elem;
   struct cuda_ptx_cache_element *elem;
+  struct frame_id frame_id;
+  void **slot;
+  int len;
 
-  /* If focus is not on device - return */
-  if (cuda_coords_get_current (&new_elem.coords))
+  /* If element can not be cached - return */
+  len = TYPE_LENGTH(value_type(value));
+  if (len > sizeof(elem->data))
     return;
 
-  /* Store information about cached register in temporary cache element*/
-  new_elem.frame_id = get_frame_id (frame);
-  new_elem.dwarf_regnum = dwarf_regnum;
-  new_elem.len = TYPE_LENGTH(value_type(value));
-  /* If element can not be cached - return */
-  if (new_elem.len > sizeof(new_elem.data))
+  /* If focus is not on device - return */
+  frame_id = get_frame_id (frame);
+  slot = cuda_ptx_cache_find_slot (frame_id, dwarf_regnum, INSERT);
+  if (!slot)
     return;
-  memcpy (new_elem.data, value_contents_raw(value), new_elem.len);
 
-  elem = cuda_ptx_cache_find_element (new_elem.frame_id, dwarf_regnum);
-  if (elem)
+  elem = (struct cuda_ptx_cache_element *) *slot;
+  if (!elem)
     {
-      elem->len = new_elem.len;
-      memcpy (elem->data, new_elem.data, elem->len);
-      return;
+      /* Add new element to the cache */
+      elem = XNEW (struct cuda_ptx_cache_element);
+      elem->frame_id = frame_id;
+      elem->dwarf_regnum = dwarf_regnum;
+      *slot = elem;
     }
 
-  /* Add new element to the cache */
-  VEC_safe_push (cuda_ptx_cache_element_t, cuda_ptx_register_cache, &new_elem);
+  elem->len = len;
+  memcpy (elem->data, value_contents_raw(value), len);
 }
 
 /**
@@ -627,12 +671,15 @@ cuda_ptx_cache_store_register (struct frame_info *frame, int dwarf_regnum, struc
 struct value *
 cuda_ptx_cache_get_register (struct frame_info *frame, int dwarf_regnum, struct type *type)
 {
-  struct cuda_ptx_cache_element *elem;
+  struct cuda_ptx_cache_element *elem = NULL;
   struct value *retval;
+  void **slot;
 
   retval = allocate_value (type);
 
-  elem = cuda_ptx_cache_find_element (get_frame_id (frame), dwarf_regnum);
+  slot = cuda_ptx_cache_find_slot (get_frame_id (frame), dwarf_regnum, NO_INSERT);
+  if (slot)
+    elem = (struct cuda_ptx_cache_element *) *slot;
   if (!elem || elem->len != TYPE_LENGTH(type) ||
       !cuda_options_variable_value_cache_enabled ())
     {
@@ -669,28 +716,23 @@ cuda_ptx_cache_update_local_vars (void)
 /**
  * Refresh cuda ptx register cache
  * If cache is not empty but the focus was changed - clean up the cache
- * Then cache try to cache all local variables mapped to PTX/GPU registers.
+ * The cache is filled as registers are read. When prefetching is enabled
+ * (the default), all local variables mapped to PTX/GPU registers are cached
+ * too; their registers come from the per-lane register cache, which reads
+ * them by ranges of 32.
  */
 void
 cuda_ptx_cache_refresh (void)
 {
   cuda_coords_t coords;
-  struct cuda_ptx_cache_element *elem;
 
-  if (!VEC_empty(cuda_ptx_cache_element_t, cuda_ptx_register_cache))
-    {
-      elem = VEC_index (cuda_ptx_cache_element_t, cuda_ptx_register_cache, 0);
-     /* If focus is still on the same lane - keep the cache intact */
-     if ( (!cuda_coords_get_current (&coords) &&
-          !cuda_coords_equal (&coords, &elem->coords)) ||
-          !cuda_options_variable_value_cache_enabled ())
-       {
-         VEC_free(cuda_ptx_cache_element_t, cuda_ptx_register_cache);
-         cuda_ptx_register_cache = 0;
-       }
-    }
+  /* If focus is still on the same lane - keep the cache intact */
+  if ((!cuda_coords_get_current (&coords) &&
+       !cuda_coords_equal (&coords, &cuda_ptx_cache_coords)) ||
+      !cuda_options_variable_value_cache_enabled ())
+    cuda_ptx_cache_clear ();
 
-  if (!cuda_options_variable_value_cache_enabled()) return;
+  if (!cuda_options_variable_value_cache_prefetch ()) return;
   cuda_ptx_cache_update_local_vars ();
 }
 
@@ -713,7 +755,7 @@ cuda_managed_msymbol_p (struct bound_minimal_symbol bmsym)
 }
 
 
-/* CUDA managed memory region list */
+/* CUDA managed memory region list, sorted by start address */
 typedef struct {
   CORE_ADDR begin;
   CORE_ADDR end;
@@ -722,7 +764,12 @@ DEF_VEC_O(memory_region_t);
 static VEC(memory_region_t) *cuda_managed_memory_regions = NULL;
 bool cuda_managed_memory_regions_populated = false;
 
-/* Must be called right after inferior was suspended */
+/* Number of regions fetched per backend request */
+#define MANAGED_MEMORY_REGIONS_BATCH 256
+
+/* Must be called whenever the host application may have changed the
+   set of managed allocations, i.e. after it has been resumed. The
+   regions are fetched again on the next query. */
 void
 cuda_managed_memory_clean_regions (void)
 {
@@ -734,18 +781,33 @@ cuda_managed_memory_clean_regions (void)
   VEC_free(memory_region_t, cuda_managed_memory_regions);
 }
 
+static int
+cuda_managed_memory_region_lt (const memory_region_t *lhs, const memory_region_t *rhs)
+{
+  return lhs->begin < rhs->begin;
+}
+
 void
 cuda_managed_memory_add_region (CORE_ADDR begin, CORE_ADDR end)
 {
   memory_region_t new_reg = {begin, end};
+  unsigned idx;
+
+  /* The backend reports regions in ascending order, so this is
+     normally an append. */
+  idx = VEC_length (memory_region_t, cuda_managed_memory_regions);
+  if (idx > 0 &&
+      VEC_last (memory_region_t, cuda_managed_memory_regions)->begin > begin)
+    idx = VEC_lower_bound (memory_region_t, cuda_managed_memory_regions,
+                           &new_reg, cuda_managed_memory_region_lt);
 
-  VEC_safe_push (memory_region_t, cuda_managed_memory_regions, &new_reg);
+  VEC_safe_insert (memory_region_t, cuda_managed_memory_regions, idx, &new_reg);
 }
 
 static void
 cuda_managed_memory_populate_regions (void)
 {
-  CUDBGMemoryInfo regions[16];
+  CUDBGMemoryInfo regions[MANAGED_MEMORY_REGIONS_BATCH];
   uint32_t regions_returned;
   uint64_t end;
   uint32_t cnt;
@@ -773,17 +835,29 @@ cuda_managed_memory_populate_regions (void)
 bool
 cuda_managed_address_p (CORE_ADDR addr)
 {
-  int idx;
+  memory_region_t key = {addr, addr};
   memory_region_t *elem;
+  unsigned len, idx;
 
   cuda_managed_memory_populate_regions ();
 
-  for (idx =0;
-       VEC_iterate (memory_region_t, cuda_managed_memory_regions, idx, elem);
-       idx++)
-    if (elem->begin <= addr && elem->end > addr)
-       return true;
-  return false;
+  len = VEC_length (memory_region_t, cuda_managed_memory_regions);
+  if (len == 0)
+    return false;
+
+  /* Find the last region starting at or below ADDR */
+  idx = VEC_lower_bound (memory_region_t, cuda_managed_memory_regions,
+                         &key, cuda_managed_memory_region_lt);
+  if (idx == len ||
+      VEC_index (memory_region_t, cuda_managed_memory_regions, idx)->begin != addr)
+    {
+      if (idx == 0)
+        return false;
+      idx--;
+    }
+
+  elem = VEC_index (memory_region_t, cuda_managed_memory_regions, idx);
+  return elem->begin <= addr && elem->end > addr;
 }
 
 bool
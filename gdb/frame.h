@@ -780,6 +780,10 @@ extern void print_frame_info (struct frame_info *, int print_level,
 /* CUDA - print_args_frame */
 extern void print_args_frame (struct frame_info *frame);
 
+/* CUDA - print_args_contents */
+extern void print_args_contents (struct symbol *func, const gdb_byte *contents,
+				 CORE_ADDR base, ULONGEST size);
+
 extern struct frame_info *block_innermost_frame (const struct block *);
 
 extern int deprecated_frame_register_read (struct frame_info *frame, int regnum,
@@ -34,6 +34,9 @@ m4_include(../ax_cxx_compile_stdcxx.m4)
 dnl For GDB_AC_SELFTEST.
 m4_include(../selftest.m4)
 
+dnl For AM_ZLIB.
+sinclude(../../config/zlib.m4)
+
 dnl Check for existence of a type $1 in libthread_db.h
 dnl Based on BFD_HAVE_SYS_PROCFS_TYPE in bfd/bfd.m4.
 
@@ -29,6 +29,7 @@
 # include "remote-nto.h"
 #endif /* __QNXHOST__ */
 #include "common/rsp-low.h"
+#include "sha1.h"
 
 #define TEXTURE_DIM_MAX 4
 
@@ -464,6 +465,9 @@ cuda_process_initialize_target_packet (char *buf)
   extract_bin (NULL, (unsigned char *) &cuda_memcheck, sizeof (cuda_memcheck));
   extract_bin (NULL, (unsigned char *) &cuda_launch_blocking, sizeof (cuda_launch_blocking));
 
+  /* A new client has to negotiate the vCUDA reply compression again */
+  cudbgipcSetRemoteCompression (false);
+
   driver_is_compatible = cuda_initialize_target ();
 
   p = append_bin ((unsigned char *) &get_debugger_api_res, buf, sizeof (get_debugger_api_res), true);
@@ -522,6 +526,46 @@ cuda_process_query_device_spec_packet (char *buf)
   p = append_string (sm_type, p, false);
 }
 
+/* Reply with the SHA1 of an ELF image so that the client can look it up
+   in its on-disk cache before asking for the image itself. */
+void
+cuda_process_query_elf_image_hash_packet (char *buf)
+{
+  CUDBGResult res;
+  char *p;
+  uint32_t dev;
+  uint64_t handle;
+  CUDBGElfImageType type;
+  uint64_t size;
+  void *image;
+  unsigned char hash[CUDA_ELF_IMAGE_HASH_SIZE] = {0};
+
+  extract_bin (NULL, (unsigned char *) &dev,    sizeof (dev));
+  extract_bin (NULL, (unsigned char *) &handle, sizeof (handle));
+  extract_bin (NULL, (unsigned char *) &type,   sizeof (type));
+  extract_bin (NULL, (unsigned char *) &size,   sizeof (size));
+
+  image = xmalloc (size);
+  res = cudbgAPI->getElfImageByHandle (dev, handle, type, image, size);
+  if (res == CUDBG_SUCCESS)
+    sha1_buffer ((const char *) image, size, hash);
+  xfree (image);
+
+  p = append_bin ((unsigned char *) &res, buf, sizeof (res), true);
+  p = append_bin (hash, p, sizeof (hash), false);
+}
+
+void
+cuda_process_set_reply_compression_packet (char *buf)
+{
+  bool enabled;
+
+  extract_bin (NULL, (unsigned char *) &enabled, sizeof (enabled));
+
+  cudbgipcSetRemoteCompression (enabled);
+  append_bin ((unsigned char *) &enabled, buf, sizeof (enabled), false);
+}
+
 void
 cuda_process_is_device_code_address_packet (char *buf)
 {
@@ -1323,23 +1367,40 @@ cuda_process_api_read_device_exception_state (char *buf)
   xfree (value);
 }
 
+/* Reply with the text of the oldest trace message, for clients predating
+   QUERY_TRACE_MESSAGES. */
 void
 cuda_process_query_trace_message (char *buf)
 {
-  struct cuda_trace_msg *msg;
+  struct cuda_trace_msg msg;
 
-  if (!cuda_first_trace_msg)
+  if (!cuda_trace_msg_pop (&msg))
     {
       append_string ("NO_TRACE_MESSAGE", buf, false);
       return;
     }
 
-  append_string (cuda_first_trace_msg->buf, buf, false);
-  msg = cuda_first_trace_msg->next;
-  xfree (cuda_first_trace_msg);
-  cuda_first_trace_msg = msg;
-  if (!cuda_first_trace_msg)
-    cuda_last_trace_msg = NULL;
+  append_string (msg.buf, buf, false);
+}
+
+/* Drain the trace ring in bulk: as many messages as fit in one reply,
+   see cuda_trace_msg_drain for their layout. */
+void
+cuda_process_query_trace_messages (char *buf)
+{
+  char *p;
+  unsigned char msgs[(PBUFSIZ - 64) / 2];
+  uint64_t dropped;
+  uint32_t count;
+  uint32_t size;
+
+  size = cuda_trace_msg_drain (msgs, sizeof (msgs), &count, &dropped);
+
+  p = append_bin ((unsigned char *) &dropped, buf, sizeof (dropped), true);
+  p = append_bin ((unsigned char *) &count, p, sizeof (count), true);
+  p = append_bin ((unsigned char *) &size, p, sizeof (size), size > 0);
+  if (size > 0)
+    p = append_bin (msgs, p, size, false);
 }
 
 #ifdef __QNXHOST__
@@ -1535,6 +1596,15 @@ handle_cuda_packet (char *buf)
     case QUERY_TRACE_MESSAGE:
       cuda_process_query_trace_message (buf);
       break;
+    case QUERY_ELF_IMAGE_HASH:
+      cuda_process_query_elf_image_hash_packet (buf);
+      break;
+    case SET_REPLY_COMPRESSION:
+      cuda_process_set_reply_compression_packet (buf);
+      break;
+    case QUERY_TRACE_MESSAGES:
+      cuda_process_query_trace_messages (buf);
+      break;
     case CHECK_PENDING_SIGINT:
       cuda_process_check_pending_sigint_packet (buf);
       break;
@@ -1640,6 +1710,13 @@ int handle_vCuda (char *buf, int packet_len, int *new_packet_len)
       return 1;
   }
 
+  res = cudbgipcEncodeReply (data, size, &data, &size);
+  if (res != CUDBG_SUCCESS) {
+      sprintf (buf, "E%02d", res);
+      *new_packet_len = 3;
+      return 1;
+  }
+
   memcpy (buf, "OK;", strlen("OK;"));
   lbuf = (gdb_byte *)buf + strlen("OK;");
   *new_packet_len  = strlen ("OK;");
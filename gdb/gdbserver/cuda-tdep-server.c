@@ -31,6 +31,8 @@
 #endif /* __QNXHOST__ */
 #include "../cuda-notifications.h"
 #include <unistd.h>
+#include <chrono>
+#include <mutex>
 
 #ifdef __QNXHOST__
 # include "cuda-nto-protocol.h"
@@ -76,8 +78,14 @@ bool cuda_debug_libcudbg;
 bool cuda_debug_notifications;
 bool cuda_notify_youngest;
 unsigned cuda_stop_signal = GDB_SIGNAL_URG;
-struct cuda_trace_msg *cuda_first_trace_msg = NULL;
-struct cuda_trace_msg *cuda_last_trace_msg = NULL;
+
+static struct cuda_trace_msg cuda_trace_ring[CUDA_TRACE_RING_SIZE];
+static uint64_t cuda_trace_ring_head = 0;  /* next message to drain */
+static uint64_t cuda_trace_ring_tail = 0;  /* next message to fill */
+static uint64_t cuda_trace_dropped = 0;    /* dropped since the last drain */
+static std::mutex cuda_trace_lock;         /* libcudbgipc traces from its callback thread */
+static const std::chrono::steady_clock::time_point cuda_trace_epoch =
+  std::chrono::steady_clock::now ();
 
 
 /* For Mac OS X */
@@ -232,46 +240,98 @@ cuda_check_pending_sigint (ptid_t ptid)
 
 /*---------------------------------------- Routines ---------------------------------------*/
 
-ATTRIBUTE_PRINTF(1, 2) void
-cuda_trace (const char *fmt, ...)
+void
+cuda_trace_msg_vappend (const char *prefix, const char *fmt, va_list ap)
 {
+  std::lock_guard<std::mutex> guard (cuda_trace_lock);
   struct cuda_trace_msg *msg;
-  va_list ap;
   int prefixLength;
   size_t maxLength;
 
-  if (!cuda_options_debug_general())
-    return;
+  if (cuda_trace_ring_tail - cuda_trace_ring_head == CUDA_TRACE_RING_SIZE)
+    {
+      cuda_trace_ring_head++;
+      cuda_trace_dropped++;
+    }
 
-  va_start (ap, fmt);
-  msg = (struct cuda_trace_msg *) xmalloc (sizeof (*msg));
-  if (!cuda_first_trace_msg)
-    cuda_first_trace_msg = msg;
-  else
-    cuda_last_trace_msg->next = msg;
+  msg = &cuda_trace_ring[cuda_trace_ring_tail++ % CUDA_TRACE_RING_SIZE];
+  msg->timestamp = std::chrono::duration_cast<std::chrono::microseconds>
+    (std::chrono::steady_clock::now () - cuda_trace_epoch).count ();
 
-  prefixLength = sprintf (msg->buf, "[CUDAGDB] ");
+  prefixLength = snprintf (msg->buf, sizeof (msg->buf), "%s", prefix);
   maxLength = sizeof (msg->buf) - prefixLength;
   if (vsnprintf (msg->buf + prefixLength, maxLength, fmt, ap) >= (int) maxLength)
     sprintf (msg->buf + sizeof (msg->buf) - 12, "[truncated]");
+}
+
+/* Copy as many queued messages as fit in the SIZE bytes of BUF, each one
+   as its 64-bit timestamp followed by the NUL-terminated text.  Returns the
+   number of bytes used; COUNT and DROPPED are set to the number of
+   messages copied and dropped since the previous drain. */
+size_t
+cuda_trace_msg_drain (unsigned char *buf, size_t size,
+                      uint32_t *count, uint64_t *dropped)
+{
+  std::lock_guard<std::mutex> guard (cuda_trace_lock);
+  size_t used = 0;
+
+  *count = 0;
+  *dropped = cuda_trace_dropped;
+  cuda_trace_dropped = 0;
+
+  while (cuda_trace_ring_head != cuda_trace_ring_tail)
+    {
+      struct cuda_trace_msg *msg = &cuda_trace_ring[cuda_trace_ring_head % CUDA_TRACE_RING_SIZE];
+      size_t length = strlen (msg->buf) + 1;
+
+      if (used + sizeof (msg->timestamp) + length > size)
+        break;
+
+      memcpy (buf + used, &msg->timestamp, sizeof (msg->timestamp));
+      memcpy (buf + used + sizeof (msg->timestamp), msg->buf, length);
+      used += sizeof (msg->timestamp) + length;
+
+      cuda_trace_ring_head++;
+      (*count)++;
+    }
+
+  return used;
+}
+
+/* Remove the oldest queued message and copy its text to MSG.  Returns
+   false if there is none. */
+bool
+cuda_trace_msg_pop (struct cuda_trace_msg *msg)
+{
+  std::lock_guard<std::mutex> guard (cuda_trace_lock);
+
+  if (cuda_trace_ring_head == cuda_trace_ring_tail)
+    return false;
+
+  *msg = cuda_trace_ring[cuda_trace_ring_head++ % CUDA_TRACE_RING_SIZE];
+  return true;
+}
+
+ATTRIBUTE_PRINTF(1, 2) void
+cuda_trace (const char *fmt, ...)
+{
+  va_list ap;
+
+  if (!cuda_options_debug_general())
+    return;
 
-  msg->next = NULL;
-  cuda_last_trace_msg = msg;
+  va_start (ap, fmt);
+  cuda_trace_msg_vappend ("[CUDAGDB] ", fmt, ap);
+  va_end (ap);
 }
 
 void
 cuda_cleanup_trace_messages (void)
 {
-  struct cuda_trace_msg *msg;
-  if (!cuda_first_trace_msg)
-    return;
+  std::lock_guard<std::mutex> guard (cuda_trace_lock);
 
-  while (cuda_first_trace_msg)
-    {
-       msg = cuda_first_trace_msg;
-       cuda_first_trace_msg = cuda_first_trace_msg->next;
-       xfree (msg);
-    }
+  cuda_trace_ring_head = cuda_trace_ring_tail;
+  cuda_trace_dropped = 0;
 }
 
 bool
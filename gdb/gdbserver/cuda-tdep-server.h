@@ -51,16 +51,17 @@ extern bool cuda_debug_notifications;
 extern bool cuda_notify_youngest;
 extern unsigned cuda_stop_signal;
 
+/* Trace messages are kept in a fixed-size ring until cuda-gdb drains them
+   with QUERY_TRACE_MESSAGES, or one at a time with QUERY_TRACE_MESSAGE.
+   When the ring is full, the oldest message is dropped and counted. */
+#define CUDA_TRACE_RING_SIZE 1024
+
 struct cuda_trace_msg
 {
+  uint64_t timestamp;  /* usec since gdbserver started */
   char buf [1024];
-  struct cuda_trace_msg *next;
 };
 
-extern struct cuda_trace_msg *cuda_first_trace_msg;
-
-extern struct cuda_trace_msg *cuda_last_trace_msg;
-
 struct cuda_sym
 {
   const char *name;
@@ -80,6 +81,11 @@ int  cuda_get_symbol_cache_size (void);
 
 void cuda_trace (char *fmt, ...);
 
+void cuda_trace_msg_vappend (const char *prefix, const char *fmt, va_list ap);
+size_t cuda_trace_msg_drain (unsigned char *buf, size_t size,
+                             uint32_t *count, uint64_t *dropped);
+bool cuda_trace_msg_pop (struct cuda_trace_msg *msg);
+
 bool cuda_options_memcheck (void);
 
 bool cuda_options_launch_blocking (void);
@@ -8204,7 +8204,6 @@ normal_stop (void)
       previous_inferior_ptid = inferior_ptid;
 
       cuda_coords_get_current (&previous_cuda_coords);
-      kernels_update_args ();
     }
 
   if (last.kind == TARGET_WAITKIND_NO_RESUMED)
@@ -2369,9 +2369,6 @@ cudbgGetAPI(uint32_t major, uint32_t minor, uint32_t rev, CUDBGAPI *api)
 ATTRIBUTE_PRINTF(1, 2) static void
 cudbg_trace(const char *fmt, ...)
 {
-#ifdef GDBSERVER
-  struct cuda_trace_msg *msg;
-#endif
   va_list ap;
 
   if (!cuda_options_debug_libcudbg())
@@ -2379,15 +2376,7 @@ cudbg_trace(const char *fmt, ...)
 
   va_start (ap, fmt);
 #ifdef GDBSERVER
-  msg = (struct cuda_trace_msg *)xmalloc (sizeof (*msg));
-  if (!cuda_first_trace_msg)
-    cuda_first_trace_msg = msg;
-  else
-    cuda_last_trace_msg->next = msg;
-  sprintf (msg->buf, "[CUDAGDB] libcudbg ");
-  vsnprintf (msg->buf + strlen (msg->buf), sizeof (msg->buf), fmt, ap);
-  msg->next = NULL;
-  cuda_last_trace_msg = msg;
+  cuda_trace_msg_vappend ("[CUDAGDB] libcudbg ", fmt, ap);
 #else
   fprintf (stderr, "[CUDAGDB] libcudbg ");
   vfprintf (stderr, fmt, ap);
@@ -45,6 +45,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <pthread.h>
+#include <zlib.h>
 #include "common/rsp-low.h"
 
 #include <cuda-utils.h>
@@ -282,6 +283,116 @@ cudbgipcInitializeCommCB(void)
     return CUDBG_SUCCESS;
 }
 
+/*
+ * vCUDA reply compression
+ * Once negotiated with cudbgipcSetRemoteCompression on both ends, every vCUDA
+ * reply payload starts with a codec byte. Replies of at least
+ * CUDBGIPC_COMPRESS_MIN_SIZE bytes are deflated when that makes them smaller,
+ * the codec byte is then followed by the 64-bit inflated size.
+ */
+#define CUDBGIPC_CODEC_NONE 0
+#define CUDBGIPC_CODEC_ZLIB 1
+#define CUDBGIPC_CODEC_HEADER_SIZE (1 + sizeof (uint64_t))
+#define CUDBGIPC_COMPRESS_MIN_SIZE 4096
+
+static bool cudbgipcCompression = false;
+static char *codecBuffer = NULL;
+static size_t codecBufferSize = 0;
+
+void
+cudbgipcSetRemoteCompression(bool enabled)
+{
+    cudbgipcCompression = enabled;
+}
+
+static char *
+cudbgipcGetCodecBuffer(size_t size)
+{
+    if (codecBufferSize < size) {
+        codecBuffer = (char *) xrealloc (codecBuffer, size);
+        codecBufferSize = size;
+    }
+    return codecBuffer;
+}
+
+CUDBGResult
+cudbgipcEncodeReply(void *d, size_t size, void **out, size_t *outSize)
+{
+    uLongf zSize;
+    uint64_t rawSize = size;
+    char *buf;
+
+    if (!cudbgipcCompression) {
+        *out = d;
+        *outSize = size;
+        return CUDBG_SUCCESS;
+    }
+
+    if (size >= CUDBGIPC_COMPRESS_MIN_SIZE) {
+        zSize = compressBound (size);
+        buf = cudbgipcGetCodecBuffer (CUDBGIPC_CODEC_HEADER_SIZE + zSize);
+        if (compress2 ((Bytef *) buf + CUDBGIPC_CODEC_HEADER_SIZE, &zSize,
+                       (const Bytef *) d, size, Z_BEST_SPEED) == Z_OK &&
+            CUDBGIPC_CODEC_HEADER_SIZE + zSize < size) {
+            buf[0] = CUDBGIPC_CODEC_ZLIB;
+            memcpy (buf + 1, &rawSize, sizeof (rawSize));
+            *out = buf;
+            *outSize = CUDBGIPC_CODEC_HEADER_SIZE + zSize;
+            cudbgipc_trace ("compressed reply from %zu to %zu bytes", size, *outSize);
+            return CUDBG_SUCCESS;
+        }
+    }
+
+    buf = cudbgipcGetCodecBuffer (size + 1);
+    buf[0] = CUDBGIPC_CODEC_NONE;
+    memcpy (buf + 1, d, size);
+    *out = buf;
+    *outSize = size + 1;
+    return CUDBG_SUCCESS;
+}
+
+CUDBGResult
+cudbgipcDecodeReply(void *d, size_t size, void **out, size_t *outSize)
+{
+    const char *buf = (const char *) d;
+    uint64_t rawSize;
+    uLongf zSize;
+    char *raw;
+
+    if (!cudbgipcCompression) {
+        *out = d;
+        *outSize = size;
+        return CUDBG_SUCCESS;
+    }
+
+    if (size >= 1 && buf[0] == CUDBGIPC_CODEC_NONE) {
+        *out = (void *) (buf + 1);
+        *outSize = size - 1;
+        return CUDBG_SUCCESS;
+    }
+
+    if (size < CUDBGIPC_CODEC_HEADER_SIZE || buf[0] != CUDBGIPC_CODEC_ZLIB) {
+        cudbgipc_trace ("malformed reply (size = %zu)", size);
+        return CUDBG_ERROR_COMMUNICATION_FAILURE;
+    }
+
+    memcpy (&rawSize, buf + 1, sizeof (rawSize));
+    zSize = rawSize;
+    raw = cudbgipcGetCodecBuffer (rawSize ? rawSize : 1);
+    if (uncompress ((Bytef *) raw, &zSize,
+                    (const Bytef *) buf + CUDBGIPC_CODEC_HEADER_SIZE,
+                    size - CUDBGIPC_CODEC_HEADER_SIZE) != Z_OK ||
+        zSize != rawSize) {
+        cudbgipc_trace ("failed to inflate reply (size = %zu)", size);
+        return CUDBG_ERROR_COMMUNICATION_FAILURE;
+    }
+
+    cudbgipc_trace ("inflated reply from %zu to %zu bytes", size, (size_t) rawSize);
+    *out = raw;
+    *outSize = rawSize;
+    return CUDBG_SUCCESS;
+}
+
 #ifndef GDBSERVER
 /*
  * CUDADBG API call RSP wrapper protocol
@@ -305,6 +416,9 @@ cudbgipcInitializeRemote (void)
   inBuffer = (char *) xmalloc (inBufferSize = 65535);
 
   outBufferUsed = snprintf (outBuffer, outBufferSize, "vCUDA;");
+
+  /* Replies are sent uncompressed until negotiated again for this target */
+  cudbgipcSetRemoteCompression (false);
   return CUDBG_SUCCESS;
 }
 
@@ -349,6 +463,7 @@ cudbgipcRequestRemote(void **d, size_t *size)
     static gdb::char_vector rcvbuf(get_remote_packet_size ());
     size_t totalRecvSize = 0;
     int recvBytes;
+    CUDBGResult res;
 
     PUTPKT_BINARY (outBuffer, outBufferUsed);
 
@@ -403,7 +518,10 @@ cudbgipcRequestRemote(void **d, size_t *size)
     } while ( memcmp (rcvbuf.data (), "OK;", strlen ("OK;")) != 0);
 
     outBufferUsed = snprintf (outBuffer, outBufferSize, "vCUDA;");
-    *d = inBuffer;
+
+    res = cudbgipcDecodeReply (inBuffer, totalRecvSize, d, &totalRecvSize);
+    if (res != CUDBG_SUCCESS)
+        return res;
     if (size)
         *size = totalRecvSize;
 
@@ -750,9 +868,6 @@ const CUDBGIPCStat_t *cudbgipcGetProfileStat(uint32_t id)
 
 ATTRIBUTE_PRINTF(1, 2) void cudbgipc_trace(const char *fmt, ...)
 {
-#ifdef GDBSERVER
-  struct cuda_trace_msg *msg;
-#endif
   va_list ap;
 
   if (!cuda_options_debug_libcudbg())
@@ -760,15 +875,7 @@ ATTRIBUTE_PRINTF(1, 2) void cudbgipc_trace(const char *fmt, ...)
 
   va_start (ap, fmt);
 #ifdef GDBSERVER
-  msg = (struct cuda_trace_msg *) xmalloc (sizeof (*msg));
-  if (!cuda_first_trace_msg)
-    cuda_first_trace_msg = msg;
-  else
-    cuda_last_trace_msg->next = msg;
-  sprintf (msg->buf, "[CUDAGDB] libcudbg ipc ");
-  vsnprintf (msg->buf + strlen (msg->buf), sizeof (msg->buf), fmt, ap);
-  msg->next = NULL;
-  cuda_last_trace_msg = msg;
+  cuda_trace_msg_vappend ("[CUDAGDB] libcudbg ipc ", fmt, ap);
 #else
   fprintf (stderr, "[CUDAGDB] libcudbg ipc ");
   vfprintf (stderr, fmt, ap);
@@ -103,6 +103,11 @@ CUDBGResult cudbgipcCBWaitForData(void *data, size_t size);
 CUDBGResult cudbgipcInitialize(void);
 CUDBGResult cudbgipcFinalize(void);
 
+/* vCUDA reply compression */
+void cudbgipcSetRemoteCompression(bool enabled);
+CUDBGResult cudbgipcEncodeReply(void *d, size_t size, void **out, size_t *outSize);
+CUDBGResult cudbgipcDecodeReply(void *d, size_t size, void **out, size_t *outSize);
+
 /* Debugger API profiling collection typedefs/macros */
 #define CUDBGIPC_API_STAT_MAX 256
 typedef struct {
@@ -2807,6 +2807,42 @@ linespec_lex_to_end (const char **stringp)
 
 /* See linespec.h.  */
 
+bool
+linespec_is_function_only (const char *spec)
+{
+  linespec_token token;
+
+  if (spec == NULL)
+    return false;
+
+  linespec_parser parser (0, current_language, NULL, NULL, 0, NULL);
+  if (!is_ada_operator (spec)
+      && strchr (linespec_quote_characters, *spec) != NULL)
+    {
+      const char *end = skip_quote_char (spec + 1, *spec);
+
+      if (end != NULL && is_closing_quote_enclosed (end))
+	{
+	  ++spec;
+	  parser.is_quote_enclosed = 1;
+	}
+    }
+
+  parser.lexer.saved_arg = spec;
+  PARSER_STREAM (&parser) = spec;
+
+  /* A single function name, which is not a convenience variable that
+     may hold a line number.  */
+  token = linespec_lexer_consume_token (&parser);
+  if (token.type != LSTOKEN_STRING || *LS_TOKEN_STOKEN (token).ptr == '$')
+    return false;
+
+  token = linespec_lexer_consume_token (&parser);
+  return token.type == LSTOKEN_EOI || token.type == LSTOKEN_KEYWORD;
+}
+
+/* See linespec.h.  */
+
 void
 linespec_complete_function (completion_tracker &tracker,
 			    const char *function,
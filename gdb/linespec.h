@@ -174,6 +174,12 @@ extern const char *find_toplevel_char (const char *s, char c);
 
 extern void linespec_lex_to_end (const char **stringp);
 
+/* Return true if the linespec SPEC only names a function, without a
+   source file, line offset or label.  SPEC is only lexed, no symbols
+   are looked up.  */
+
+extern bool linespec_is_function_only (const char *spec);
+
 extern const char * const linespec_keywords[];
 
 /* Complete a linespec.  */
@@ -100,6 +100,8 @@ static struct mi_cmd mi_cmds[] =
   DEF_MI_CMD_MI ("cuda-info-kernels", mi_cmd_cuda_info_kernels),
   DEF_MI_CMD_MI ("cuda-info-blocks", mi_cmd_cuda_info_blocks),
   DEF_MI_CMD_MI ("cuda-info-threads", mi_cmd_cuda_info_threads),
+  DEF_MI_CMD_MI ("cuda-info-pcs", mi_cmd_cuda_info_pcs),
+  DEF_MI_CMD_MI ("cuda-info-backtraces", mi_cmd_cuda_info_backtraces),
   DEF_MI_CMD_MI ("cuda-info-launch-trace", mi_cmd_cuda_info_launch_trace),
   DEF_MI_CMD_MI ("cuda-info-contexts",  mi_cmd_cuda_info_contexts),
   DEF_MI_CMD_MI ("cuda-focus-query", mi_cmd_cuda_focus_query),
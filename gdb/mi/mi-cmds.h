@@ -64,6 +64,8 @@ extern mi_cmd_argv_ftype mi_cmd_cuda_info_lanes;
 extern mi_cmd_argv_ftype mi_cmd_cuda_info_kernels;
 extern mi_cmd_argv_ftype mi_cmd_cuda_info_blocks;
 extern mi_cmd_argv_ftype mi_cmd_cuda_info_threads;
+extern mi_cmd_argv_ftype mi_cmd_cuda_info_pcs;
+extern mi_cmd_argv_ftype mi_cmd_cuda_info_backtraces;
 extern mi_cmd_argv_ftype mi_cmd_cuda_info_launch_trace;
 extern mi_cmd_argv_ftype mi_cmd_cuda_info_launch_children;
 extern mi_cmd_argv_ftype mi_cmd_cuda_info_contexts;
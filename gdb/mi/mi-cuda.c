@@ -137,6 +137,26 @@ mi_cmd_cuda_info_threads (const char *command, char **argv, int argc)
   xfree (filter);
 }
 
+void
+mi_cmd_cuda_info_pcs (const char *command, char **argv, int argc)
+{
+  char *filter = concatenate_string (argv, argc);
+
+  run_info_cuda_command (info_cuda_pcs_command, filter);
+
+  xfree (filter);
+}
+
+void
+mi_cmd_cuda_info_backtraces (const char *command, char **argv, int argc)
+{
+  char *filter = concatenate_string (argv, argc);
+
+  run_info_cuda_command (info_cuda_backtraces_command, filter);
+
+  xfree (filter);
+}
+
 void
 mi_cmd_cuda_info_launch_trace (const char *command, char **argv, int argc)
 {
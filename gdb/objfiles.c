@@ -899,6 +899,8 @@ objfile_relocate1 (struct objfile *objfile,
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->section_map_dirty = 1;
+  /* CUDA - code address map */
+  cuda_code_map_invalidate (objfile->pspace);
 
   /* Update the table in exec_ops, used to read memory.  */
   struct obj_section *s;
@@ -1479,6 +1481,8 @@ objfiles_changed (void)
 {
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (current_program_space)->section_map_dirty = 1;
+  /* CUDA - code address map */
+  cuda_code_map_invalidate (current_program_space);
 }
 
 /* See comments in objfiles.h.  */
@@ -114,7 +114,9 @@ require_partial_symbols (struct objfile *objfile, int verbose)
 
       if (objfile->sf->sym_read_psymbols)
 	{
-	  if (verbose)
+	  /* CUDA - lazy symbol reading */
+	  /* Device ELF images are temporary files, do not report them. */
+	  if (verbose && !objfile->cuda_objfile)
 	    printf_filtered (_("Reading symbols from %s...\n"),
 			     objfile_name (objfile));
 	  (*objfile->sf->sym_read_psymbols) (objfile);
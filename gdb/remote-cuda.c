@@ -124,6 +124,9 @@ cuda_remote_target<parent>::cuda_do_resume (ptid_t ptid, int sstep, int host_sst
 {
   uint32_t dev;
 
+  /* Any device or the host may write device memory from now on */
+  cuda_memcache_invalidate ();
+
   cuda_sstep_reset (sstep);
 
   // Is focus on host?
@@ -251,6 +254,7 @@ cuda_initialize_remote_target (struct target_ops *ops)
                                    num_registers, dev_type, sm_type);
     }
   cuda_remote_set_option (remote);
+  cuda_remote_set_reply_compression (remote);
   cuda_gdb_session_create ();
   cuda_update_report_driver_api_error_flags ();
   cuda_initialize_driver_api_error_report ();
@@ -617,7 +621,10 @@ cuda_remote_target<parent>::wait (ptid_t ptid, struct target_waitstatus *ws, int
           cuda_set_signo (ws->value.sig);
         }
     }
-  cuda_managed_memory_clean_regions();
+
+  /* Managed allocations can only change while the host runs */
+  if (!cuda_sstep_is_active ())
+    cuda_managed_memory_clean_regions ();
 
   /* Switch focus and update related data */
   cuda_update_convenience_variables ();
@@ -776,6 +776,74 @@ print_args_frame (struct frame_info *frame)
   QUIT;
 }
 
+/* CUDA - print_args_contents */
+/* Print the arguments of FUNC like print_args_frame does, but take
+   their values from CONTENTS, a copy of the SIZE bytes of parameter
+   memory starting at BASE, instead of reading them through a frame.
+   Every argument of FUNC must be a LOC_STATIC symbol lying within
+   that range.  */
+
+void
+print_args_contents (struct symbol *func, const gdb_byte *contents,
+		     CORE_ADDR base, ULONGEST size)
+{
+  struct ui_out *uiout = current_uiout;
+  int print_args = strcmp (print_frame_arguments, "none");
+  int first = 1;
+  const struct block *b;
+  struct block_iterator iter;
+  struct symbol *sym;
+
+  ui_out_emit_list list_emitter (uiout, "args");
+
+  if (!func)
+    return;
+
+  b = SYMBOL_BLOCK_VALUE (func);
+  ALL_BLOCK_SYMBOLS (b, iter, sym)
+    {
+      struct frame_arg arg;
+      struct type *type;
+      CORE_ADDR addr;
+
+      QUIT;
+
+      if (!SYMBOL_IS_ARGUMENT (sym))
+	continue;
+
+      type = SYMBOL_TYPE (sym);
+      addr = SYMBOL_VALUE_ADDRESS (sym);
+      gdb_assert (SYMBOL_CLASS (sym) == LOC_STATIC);
+      gdb_assert (addr >= base && addr + TYPE_LENGTH (type) <= base + size);
+
+      if (!first)
+	uiout->text (", ");
+      uiout->wrap_hint ("    ");
+
+      memset (&arg, 0, sizeof (arg));
+      arg.sym = sym;
+      arg.entry_kind = print_entry_values_no;
+
+      if (print_args)
+	{
+	  TRY
+	    {
+	      arg.val = value_from_contents (type, contents + (addr - base));
+	    }
+	  CATCH (except, RETURN_MASK_ERROR)
+	    {
+	      arg.error = xstrdup (except.message);
+	    }
+	  END_CATCH
+	}
+
+      print_frame_arg (&arg);
+      xfree (arg.error);
+
+      first = 0;
+    }
+}
+
 /* Set the current source and line to the location given by frame
    FRAME, if possible.  When CENTER is true, adjust so the relevant
    line is in the center of the next 'list'.  */
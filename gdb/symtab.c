@@ -88,6 +88,8 @@
 #include <algorithm>
 #include "common/pathstuff.h"
 
+#include "cuda-elf-image.h"
+
 /* Forward declarations for local functions.  */
 
 static void rbreak_command (const char *, int);
@@ -3135,6 +3137,11 @@ find_pc_sect_compunit_symtab (CORE_ADDR pc, struct obj_section *section)
   /* CUDA - query if this is a code address */
   is_device_code_address = cuda_is_device_code_address (pc);
 
+  /* CUDA - lazy symbol reading */
+  /* Read the symbols of the device ELF image the PC lands in, if deferred. */
+  if (is_device_code_address)
+    cuda_elf_image_read_symbols_by_address (pc);
+
   for (objfile *obj_file : current_program_space->objfiles ())
     {
       for (compunit_symtab *cust : obj_file->compunits ())
@@ -0,0 +1,323 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Write a synthetic GPU core dump with one device of NUM_SMS SMs, each
+   running two CTAs of WARPS_PER_CTA fully populated warps.  Every lane
+   gets a local memory, a registers and a backtrace section, which is
+   what dominates the section count of real core dumps.
+
+   Usage: cuda-core-open OUTPUT NUM_SMS  */
+
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cudacoredump.h"
+
+#ifndef EM_CUDA
+#define EM_CUDA 190
+#endif
+#define ELFOSABI_CUDA 0x33
+#define ELFOSABIV_LATEST 0x7
+
+#define CTAS_PER_SM 2
+#define WARPS_PER_CTA 4
+#define LANES_PER_WARP 32
+#define REGS_PER_LANE 16
+
+static FILE *out;
+static Elf64_Shdr *shdrs;
+static size_t num_shdrs, max_shdrs;
+static char *shstrtab;
+static size_t shstrtab_size, shstrtab_max;
+
+static void
+die (const char *msg)
+{
+  perror (msg);
+  exit (1);
+}
+
+static void *
+grow (void *buf, size_t *max, size_t needed, size_t elt_size)
+{
+  if (needed <= *max)
+    return buf;
+
+  while (*max < needed)
+    *max = *max ? *max * 2 : 1024;
+
+  buf = realloc (buf, *max * elt_size);
+  if (buf == NULL)
+    die ("realloc");
+  return buf;
+}
+
+static Elf64_Off
+write_data (const void *data, size_t size)
+{
+  long pos;
+
+  /* Keep section data 8-byte aligned.  */
+  if (fseek (out, 0, SEEK_END) != 0 || (pos = ftell (out)) < 0)
+    die ("seek");
+  while (pos % 8 != 0)
+    {
+      fputc (0, out);
+      pos++;
+    }
+
+  if (size != 0 && fwrite (data, size, 1, out) != 1)
+    die ("write");
+  return pos;
+}
+
+static Elf64_Word
+add_name (const char *name)
+{
+  size_t len = strlen (name) + 1;
+  Elf64_Word off = shstrtab_size;
+
+  shstrtab = (char *) grow (shstrtab, &shstrtab_max, shstrtab_size + len, 1);
+  memcpy (shstrtab + shstrtab_size, name, len);
+  shstrtab_size += len;
+  return off;
+}
+
+/* Add a section and return its index.  LINK and INFO designate the
+   owning table entry, see cudacoredump.h.  */
+
+static Elf64_Word
+add_section (const char *name, Elf64_Word type, const void *data,
+	     size_t size, size_t entsize, Elf64_Word link, Elf64_Word info,
+	     Elf64_Addr addr)
+{
+  Elf64_Shdr *shdr;
+
+  shdrs = (Elf64_Shdr *) grow (shdrs, &max_shdrs, num_shdrs + 1,
+			       sizeof (*shdrs));
+  shdr = &shdrs[num_shdrs];
+  memset (shdr, 0, sizeof (*shdr));
+  shdr->sh_name = add_name (name);
+  shdr->sh_type = type;
+  shdr->sh_offset = write_data (data, size);
+  shdr->sh_size = size;
+  shdr->sh_entsize = entsize;
+  shdr->sh_link = link;
+  shdr->sh_info = info;
+  shdr->sh_addr = addr;
+  return num_shdrs++;
+}
+
+static void
+add_lane (Elf64_Word ln_table, unsigned int ln)
+{
+  char local[256];
+  uint32_t regs[REGS_PER_LANE];
+  CudbgBacktraceTableEntry bt[2];
+  unsigned int i;
+
+  memset (local, 0, sizeof (local));
+  add_section (".cudbg.local", CUDBG_SHT_LOCAL_MEM, local, sizeof (local),
+	       0, ln_table, ln, 0xfffc00);
+
+  for (i = 0; i < REGS_PER_LANE; i++)
+    regs[i] = i;
+  add_section (".cudbg.regs", CUDBG_SHT_DEV_REGS, regs, sizeof (regs),
+	       0, ln_table, ln, 0);
+
+  memset (bt, 0, sizeof (bt));
+  bt[0].level = 0;
+  bt[0].virtualReturnAddress = 0x1000;
+  bt[1].level = 1;
+  bt[1].virtualReturnAddress = 0x2000;
+  add_section (".cudbg.bt", CUDBG_SHT_BT, bt, sizeof (bt), sizeof (*bt),
+	       ln_table, ln, 0);
+}
+
+static void
+add_cta (Elf64_Word cta_table, unsigned int cta)
+{
+  static char shared[1024];
+  CudbgWarpTableEntry wte[WARPS_PER_CTA];
+  CudbgThreadTableEntry tte[LANES_PER_WARP];
+  Elf64_Word wp_table, ln_table;
+  unsigned int wp, ln;
+
+  add_section (".cudbg.shared", CUDBG_SHT_SHARED_MEM, shared,
+	       sizeof (shared), 0, cta_table, cta, 0);
+
+  memset (wte, 0, sizeof (wte));
+  for (wp = 0; wp < WARPS_PER_CTA; wp++)
+    {
+      wte[wp].warpId = cta * WARPS_PER_CTA + wp;
+      wte[wp].validLanesMask = 0xffffffff;
+      wte[wp].activeLanesMask = 0xffffffff;
+    }
+  wp_table = add_section (".cudbg.wptbl", CUDBG_SHT_WP_TABLE, wte,
+			  sizeof (wte), sizeof (*wte), cta_table, cta, 0);
+
+  for (wp = 0; wp < WARPS_PER_CTA; wp++)
+    {
+      memset (tte, 0, sizeof (tte));
+      for (ln = 0; ln < LANES_PER_WARP; ln++)
+	{
+	  tte[ln].ln = ln;
+	  tte[ln].threadIdxX = wp * LANES_PER_WARP + ln;
+	  tte[ln].virtualPC = 0x1000;
+	  tte[ln].callDepth = 1;
+	}
+      ln_table = add_section (".cudbg.lntbl", CUDBG_SHT_LN_TABLE, tte,
+			      sizeof (tte), sizeof (*tte), wp_table, wp, 0);
+
+      for (ln = 0; ln < LANES_PER_WARP; ln++)
+	add_lane (ln_table, ln);
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+  static const char strtab[] = "\0Benchmark GPU\0GPU\0sm_70";
+  CudbgDeviceTableEntry dte;
+  CudbgGridTableEntry gte;
+  CudbgContextTableEntry cte;
+  CudbgSmTableEntry *ste;
+  CudbgCTATableEntry cta[CTAS_PER_SM];
+  Elf64_Word dev_table, sm_table, cta_table, shstrndx;
+  Elf64_Ehdr ehdr;
+  unsigned int num_sms, sm, i;
+
+  if (argc != 3)
+    {
+      fprintf (stderr, "usage: %s OUTPUT NUM_SMS\n", argv[0]);
+      return 1;
+    }
+
+  num_sms = atoi (argv[2]);
+  out = fopen (argv[1], "wb");
+  if (out == NULL)
+    die (argv[1]);
+
+  /* The ELF header is written last, once the section headers are.  */
+  memset (&ehdr, 0, sizeof (ehdr));
+  if (fwrite (&ehdr, sizeof (ehdr), 1, out) != 1)
+    die ("write");
+
+  add_name ("");
+  add_section ("", SHT_NULL, NULL, 0, 0, 0, 0, 0);
+  add_section (".strtab", SHT_STRTAB, strtab, sizeof (strtab), 0, 0, 0, 0);
+
+  memset (&dte, 0, sizeof (dte));
+  dte.devName = 1;
+  dte.devType = 15;
+  dte.smType = 19;
+  dte.numSMs = num_sms;
+  dte.numWarpsPerSM = CTAS_PER_SM * WARPS_PER_CTA;
+  dte.numLanesPerWarp = LANES_PER_WARP;
+  dte.numRegsPerLane = REGS_PER_LANE;
+  dte.numPredicatesPrLane = 7;
+  dte.instructionSize = 16;
+  dev_table = add_section (".cudbg.devtbl", CUDBG_SHT_DEV_TABLE, &dte,
+			   sizeof (dte), sizeof (dte), 0, 0, 0);
+
+  memset (&cte, 0, sizeof (cte));
+  cte.contextId = 1;
+  cte.deviceIdx = 0;
+  cte.tid = 1;
+  add_section (".cudbg.ctxtbl", CUDBG_SHT_CTX_TABLE, &cte, sizeof (cte),
+	       sizeof (cte), 0, 0, 0);
+
+  memset (&gte, 0, sizeof (gte));
+  gte.gridId64 = 1;
+  gte.contextId = 1;
+  gte.gridDimX = num_sms * CTAS_PER_SM;
+  gte.gridDimY = gte.gridDimZ = 1;
+  gte.blockDimX = WARPS_PER_CTA * LANES_PER_WARP;
+  gte.blockDimY = gte.blockDimZ = 1;
+  add_section (".cudbg.gridtbl", CUDBG_SHT_GRID_TABLE, &gte, sizeof (gte),
+	       sizeof (gte), dev_table, 0, 0);
+
+  ste = (CudbgSmTableEntry *) calloc (num_sms ? num_sms : 1, sizeof (*ste));
+  if (ste == NULL)
+    die ("calloc");
+  for (sm = 0; sm < num_sms; sm++)
+    ste[sm].smId = sm;
+  sm_table = add_section (".cudbg.smtbl", CUDBG_SHT_SM_TABLE, ste,
+			  num_sms * sizeof (*ste), sizeof (*ste),
+			  dev_table, 0, 0);
+  free (ste);
+
+  for (sm = 0; sm < num_sms; sm++)
+    {
+      memset (cta, 0, sizeof (cta));
+      for (i = 0; i < CTAS_PER_SM; i++)
+	{
+	  cta[i].gridId64 = 1;
+	  cta[i].blockIdxX = sm * CTAS_PER_SM + i;
+	}
+      cta_table = add_section (".cudbg.ctatbl", CUDBG_SHT_CTA_TABLE, cta,
+			       sizeof (cta), sizeof (*cta), sm_table, sm, 0);
+
+      for (i = 0; i < CTAS_PER_SM; i++)
+	add_cta (cta_table, i);
+    }
+
+  /* Add the section header string table, then the section headers,
+     using extended numbering for large dumps.  */
+  shstrndx = num_shdrs;
+  add_name (".shstrtab");
+  add_section (".shstrtab", SHT_STRTAB, NULL, 0, 0, 0, 0, 0);
+  shdrs[shstrndx].sh_name = shstrtab_size - sizeof (".shstrtab");
+  shdrs[shstrndx].sh_offset = write_data (shstrtab, shstrtab_size);
+  shdrs[shstrndx].sh_size = shstrtab_size;
+
+  memcpy (ehdr.e_ident, ELFMAG, SELFMAG);
+  ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+  ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+  ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+  ehdr.e_ident[EI_OSABI] = ELFOSABI_CUDA;
+  ehdr.e_ident[EI_ABIVERSION] = ELFOSABIV_LATEST;
+  ehdr.e_type = ET_CORE;
+  ehdr.e_machine = EM_CUDA;
+  ehdr.e_version = EV_CURRENT;
+  ehdr.e_ehsize = sizeof (ehdr);
+  ehdr.e_shentsize = sizeof (Elf64_Shdr);
+
+  if (num_shdrs >= SHN_LORESERVE)
+    {
+      shdrs[0].sh_size = num_shdrs;
+      shdrs[0].sh_link = shstrndx;
+      ehdr.e_shnum = 0;
+      ehdr.e_shstrndx = SHN_XINDEX;
+    }
+  else
+    {
+      ehdr.e_shnum = num_shdrs;
+      ehdr.e_shstrndx = shstrndx;
+    }
+
+  ehdr.e_shoff = write_data (shdrs, num_shdrs * sizeof (*shdrs));
+
+  if (fseek (out, 0, SEEK_SET) != 0
+      || fwrite (&ehdr, sizeof (ehdr), 1, out) != 1
+      || fclose (out) != 0)
+    die ("write");
+
+  return 0;
+}
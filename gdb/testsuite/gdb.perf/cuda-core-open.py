@@ -0,0 +1,43 @@
+# Copyright (C) 2019 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import os
+
+from perftest import perftest
+
+class CudaCoreOpen (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, prefix, sms, threads):
+        super (CudaCoreOpen, self).__init__ ("cuda-core-open")
+        self.prefix = prefix
+        self.sms = sms
+        self.threads = threads
+
+    def _open(self, sms):
+        gdb.execute ("target cudacore %s-%d.core" % (self.prefix, sms),
+                     False, True)
+
+    def warm_up(self):
+        # Bring the smallest core dump into the page cache.
+        self._open (self.sms[0])
+
+    def execute_test(self):
+        for threads in self.threads:
+            # libcudacore reads it each time a core dump is opened.
+            os.environ["CUCORE_THREADS"] = str (threads)
+            for sms in self.sms:
+                func = lambda: self._open (sms)
+                self.measure.measure (func, "%d-sms-%d-threads"
+                                      % (sms, threads))
+        del os.environ["CUCORE_THREADS"]
@@ -62,6 +62,7 @@ typedef struct {
 	Elf *e;
 	Elf_Scn *scn;
 	Elf64_Shdr *shdr;
+	char *data;			/* Section data, NULL if not dumped */
 } MemorySeg;
 
 /* Note: for now using string key (and fixed length) */
@@ -72,11 +73,79 @@ typedef struct {
 	UT_hash_handle hh;
 } MapEntry;
 
+/* Owner of a section: the table entries its sh_link/sh_info pair points to,
+ * together with the owners of that table. All the entries of a table
+ * section share the same owner, so it is recorded once per section. */
+typedef struct {
+	uint32_t type;			/* Section type (sh_type) */
+	void *table;			/* Table entries, NULL if not a table */
+	size_t entrySize;		/* Size of a table entry */
+	size_t numEntries;		/* Number of table entries */
+	uint32_t devIdx;		/* Index of dte in the device table */
+	uint32_t ctaIdx;		/* Index of ctate in its CTA table */
+	CudbgDeviceTableEntry *dte;
+	CudbgSmTableEntry *ste;
+	CudbgCTATableEntry *ctate;
+	CudbgWarpTableEntry *wte;
+	CudbgThreadTableEntry *tte;
+	CudbgGridTableEntry *gte;
+	CudbgContextTableEntry *cte;
+	CudbgModuleTableEntry *mte;
+} CudaCoreSection;
+
+/* Per-lane state, indexed by lane id */
+typedef struct {
+	CudbgThreadTableEntry *tte;
+	CudbgBacktraceTableEntry *bt;	/* Backtrace table of the lane */
+	size_t numBt;			/* Number of backtrace entries */
+	Elf_Scn *local;			/* Local memory section */
+	Elf_Scn *regs;			/* Registers section */
+	Elf_Scn *pred;			/* Predicates section */
+} CudaCoreLane;
+
+/* Per-warp state, indexed by (sm, wp) */
+typedef struct {
+	CudbgWarpTableEntry *wte;
+	CudbgCTATableEntry *ctate;
+	uint32_t ctaIdx;		/* Index of ctate in the SM CTA table */
+	Elf_Scn *uregs;			/* Uniform registers section */
+	Elf_Scn *upred;			/* Uniform predicates section */
+	CudaCoreLane *lanes;		/* numLanes entries, NULL if no lanes */
+} CudaCoreWarp;
+
+/* Per-device index of the core dump state, addressed by integer
+ * coordinates rather than by formatted string keys. */
+typedef struct {
+	CudbgDeviceTableEntry *dte;	/* Copy of the device table entry */
+	uint32_t numSMs;
+	uint32_t numWarps;
+	uint32_t numLanes;
+	CudaCoreWarp *warps;		/* numSMs * numWarps entries */
+	Elf_Scn **shared;		/* Shared memory sections, indexed by
+					 * (sm, CTA index) over numSMs * numWarps
+					 * entries: a resident CTA holds at least
+					 * one warp */
+} CudaCoreDevice;
+
 typedef struct CudaCoreEvent_st {
 	CUDBGEvent event;
 	struct CudaCoreEvent_st *next;
 } CudaCoreEvent;
 
+/* Sections whose processing is deferred until first use. Table sections
+ * are read when the core dump is opened, since they describe the
+ * device/grid/SM/CTA/warp/lane hierarchy; everything hanging off that
+ * hierarchy is only indexed once a request needs it. */
+typedef enum {
+	CUDA_CORE_LAZY_GLOBAL,		/* Global and managed memory */
+	CUDA_CORE_LAZY_SHARED,		/* Shared memory */
+	CUDA_CORE_LAZY_LOCAL,		/* Local memory */
+	CUDA_CORE_LAZY_PARAM,		/* Parameter memory */
+	CUDA_CORE_LAZY_REGS,		/* Registers and predicates */
+	CUDA_CORE_LAZY_ELF,		/* ELF images and their load events */
+	CUDA_CORE_LAZY_NUM,
+} CudaCoreLazyKind;
+
 typedef struct CudaCoreELFImage_st {
 	CudbgDeviceTableEntry *dte;
 	Elf *e;
@@ -92,13 +161,24 @@ struct CudaCore_st {
 	size_t strndx;			/* String table section index */
 
 	size_t numDevices;		/* Number of CUDA devices */
-	MapEntry *tableEntriesMap;	/* Hash map with state information */
+	CudaCoreDevice *devices;	/* Device index, numDevices entries */
+	CudaCoreSection *sections;	/* Section owners, shnum entries */
+	MapEntry *tableEntriesMap;	/* Hash map with grid, context and
+					 * module information */
 	UT_array *managedMemorySegs;	/* Sorted array of managed memory segments */
 	UT_array *globalMemorySegs;	/* Sorted array of global memory segments */
+	UT_array *memoryIndex;		/* Sorted, disjoint global and managed
+					 * memory segments with data */
 
 	CudaCoreEvent *eventHead;	/* Single linked list of CUDA Events */
 	CudaCoreELFImage *relocatedELFImageHead;
 					/* Single linked list of CUDA ELF images */
+	UT_array *lazySections[CUDA_CORE_LAZY_NUM];
+					/* Indices of the sections not yet
+					 * processed, NULL once loaded */
+	char *lazyErrors[CUDA_CORE_LAZY_NUM];
+					/* Error message of a failed load,
+					 * returned by every later load */
 };
 
 #ifndef _MSC_VER
@@ -134,6 +214,33 @@ struct CudaCore_st {
 	} while (0)
 #endif /*_MSC_VER*/
 
+#define GET_DEVICE(device, errcode, devId)				\
+	do {								\
+		(device) = cuCoreGetDevice(curcc, devId);		\
+		if ((device) == NULL)					\
+			return errcode;					\
+	} while (0)
+
+#define GET_WARP(warp, errcode, devId, sm, wp)				\
+	do {								\
+		(warp) = cuCoreGetWarp(curcc, devId, sm, wp);		\
+		if ((warp) == NULL)					\
+			return errcode;					\
+	} while (0)
+
+#define GET_LANE(lane, errcode, devId, sm, wp, ln)			\
+	do {								\
+		(lane) = cuCoreGetLane(curcc, devId, sm, wp, ln);	\
+		if ((lane) == NULL)					\
+			return errcode;					\
+	} while (0)
+
+#define LOAD_SECTIONS(kind, errcode)					\
+	do {								\
+		if (cuCoreLoadSections(curcc, kind) != 0)		\
+			return errcode;					\
+	} while (0)
+
 /**/
 #ifndef _MSC_VER
 #define _PRINTF_ARGS(fmt,var) __attribute__ ((format (printf, fmt, var)))
@@ -151,8 +258,15 @@ struct CudaCore_st {
 
 void dbgprintf(int level, const char *fmt, ...) _PRINTF_ARGS(2, 3);
 int cuCoreSortMemorySegs(const void *a, const void *b);
+MemorySeg *cuCoreFindMemorySeg(CudaCore *cc, uint64_t address);
 void cuCoreSetErrorMsg(const char *fmt, ...) _PRINTF_ARGS(1, 2);
 void *cuCoreGetMapEntry(MapEntry **map, const char *fmt, ...) _PRINTF_ARGS(2, 3);
+CudaCoreDevice *cuCoreGetDevice(CudaCore *cc, uint32_t devId);
+CudaCoreWarp *cuCoreGetWarp(CudaCore *cc, uint32_t devId, uint32_t sm,
+			    uint32_t wp);
+CudaCoreLane *cuCoreGetLane(CudaCore *cc, uint32_t devId, uint32_t sm,
+			    uint32_t wp, uint32_t ln);
+int cuCoreLoadSections(CudaCore *cc, CudaCoreLazyKind kind);
 size_t cuCoreGetNumDevices(CudaCore *cc);
 const char *cuCoreGetStrTabByIndex(CudaCore *cc, size_t idx);
 const CUDBGEvent *cuCoreGetEvent(CudaCore *cc);
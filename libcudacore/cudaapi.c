@@ -51,34 +51,13 @@ static int mkstemp(char *name)
 
 static __THREAD CudaCore *curcc;
 
-static CUDBGResult determineCTAId(uint32_t dev, uint32_t sm, uint32_t wp, uint32_t *cta)
-{
-	CudbgCTATableEntry *ctate, *ctate1;
-	uint32_t ctateIdx = 0;
-
-	GET_TABLE_ENTRY(ctate, CUDBG_ERROR_UNKNOWN,
-			"wp%u_sm%u_dev%u_cta", wp, sm, dev);
-
-	do {
-		ctate1 = cuCoreGetMapEntry(&curcc->tableEntriesMap, "cta%u_sm%u_dev%u", ctateIdx++, sm, dev);
-	} while (ctate1 != NULL && ctate1 != ctate);
-
-	*cta = ctateIdx-1;
-	return ctate1 == ctate ? CUDBG_SUCCESS: CUDBG_ERROR_INTERNAL;
-}
-
 static CUDBGResult getGridId(uint32_t dev, uint32_t sm, uint32_t wp, uint64_t *gridId)
 {
-	CudbgCTATableEntry *ctate;
-	CudbgWarpTableEntry *wte;
+	CudaCoreWarp *warp;
 
-	GET_TABLE_ENTRY(wte, CUDBG_ERROR_INVALID_WARP,
-			"wp%u_sm%u_dev%u", wp, sm, dev);
+	GET_WARP(warp, CUDBG_ERROR_INVALID_WARP, dev, sm, wp);
 
-	GET_TABLE_ENTRY(ctate, CUDBG_ERROR_UNKNOWN,
-			"wp%u_sm%u_dev%u_cta", wp, sm, dev);
-
-	*gridId = ctate->gridId64;
+	*gridId = warp->ctate->gridId64;
 	return CUDBG_SUCCESS;
 }
 
@@ -119,6 +98,8 @@ DEF_API_CALL(getElfImage)(uint32_t dev, uint32_t sm, uint32_t wp,
 	GET_TABLE_ENTRY(gte, CUDBG_ERROR_INVALID_GRID,
 			"grid%llu_dev%u", gridId, dev);
 
+	LOAD_SECTIONS(CUDA_CORE_LAZY_ELF, CUDBG_ERROR_INVALID_MODULE);
+
 	GET_TABLE_ENTRY(scn, CUDBG_ERROR_INVALID_MODULE,
 			"%celf_handle%llx",
 			relocated ? 'r' : 'u', gte->moduleHandle);
@@ -145,60 +126,60 @@ DEF_API_CALL(getNumDevices)(uint32_t *numDev)
 
 DEF_API_CALL(getNumSMs)(uint32_t dev, uint32_t *numSMs)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 
 	TRACE_FUNC("dev=%u numSMs=%p", dev, numSMs);
 
 	VERIFY_ARG(numSMs);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", dev);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, dev);
 
-	*numSMs = dte->numSMs;
+	*numSMs = device->dte->numSMs;
 
 	return CUDBG_SUCCESS;
 }
 
 DEF_API_CALL(getNumWarps)(uint32_t dev, uint32_t *numWarps)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 
 	TRACE_FUNC("dev=%u numWarps=%p", dev, numWarps);
 
 	VERIFY_ARG(numWarps);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", dev);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, dev);
 
-	*numWarps = dte->numWarpsPerSM;
+	*numWarps = device->dte->numWarpsPerSM;
 
 	return CUDBG_SUCCESS;
 }
 
 DEF_API_CALL(getNumLanes)(uint32_t dev, uint32_t *numLanes)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 
 	TRACE_FUNC("dev=%u numLanes=%p", dev, numLanes);
 
 	VERIFY_ARG(numLanes);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", dev);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, dev);
 
-	*numLanes = dte->numLanesPerWarp;
+	*numLanes = device->dte->numLanesPerWarp;
 
 	return CUDBG_SUCCESS;
 }
 
 DEF_API_CALL(getNumRegisters)(uint32_t dev, uint32_t *numRegs)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 
 	TRACE_FUNC("dev=%u numRegs=%p", dev, numRegs);
 
 	VERIFY_ARG(numRegs);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", dev);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, dev);
 
-	*numRegs = dte->numRegsPerLane;
+	*numRegs = device->dte->numRegsPerLane;
 
 	return CUDBG_SUCCESS;
 }
@@ -261,53 +242,58 @@ DEF_API_CALL(readCodeMemory)(uint32_t dev, uint64_t addr, void *buf,
 
 DEF_API_CALL(readGlobalMemory)(uint64_t addr, void *buf, uint32_t sz)
 {
-	MemorySeg *memorySeg, memorySegToFind;
-	Elf_Data data;
+	MemorySeg *memorySeg;
+	uint64_t offset, len;
+	uint32_t done;
 
 	TRACE_FUNC("addr=0x%llx buf=%p sz=%u", addr, buf, sz);
 
 	VERIFY_ARG(buf);
 
-	memorySegToFind.address = addr;
-	memorySegToFind.size = sz;
-
-	memorySeg = utarray_find(curcc->globalMemorySegs, &memorySegToFind,
-				 cuCoreSortMemorySegs);
-	if (memorySeg == NULL)
-		return CUDBG_ERROR_MISSING_DATA;
+	LOAD_SECTIONS(CUDA_CORE_LAZY_GLOBAL, CUDBG_ERROR_MISSING_DATA);
 
-	if (addr < memorySeg->address ||
-			addr + sz > memorySeg->address + memorySeg->size)
-		return CUDBG_ERROR_INVALID_MEMORY_ACCESS;
+	/* The read may span several adjacent segments */
+	for (done = 0; done < sz; done += len) {
+		memorySeg = cuCoreFindMemorySeg(curcc, addr + done);
+		if (memorySeg == NULL)
+			return done == 0 ? CUDBG_ERROR_MISSING_DATA :
+					   CUDBG_ERROR_INVALID_MEMORY_ACCESS;
 
-	if (cuCoreReadSectionData(memorySeg->e, memorySeg->scn, &data) != 0)
-		return CUDBG_ERROR_UNKNOWN;
+		offset = addr + done - memorySeg->address;
+		len = memorySeg->size - offset;
+		if (len > sz - done)
+			len = sz - done;
 
-	memcpy(buf, (char *)data.d_buf + (addr - memorySeg->address), sz);
+		memcpy((char *)buf + done, memorySeg->data + offset, len);
+	}
 
 	return CUDBG_SUCCESS;
-
 }
 
 DEF_API_CALL(readSharedMemory)(uint32_t dev, uint32_t sm, uint32_t wp,
 			       uint64_t addr, void *buf, uint32_t sz)
 {
-	uint32_t ctaId;
+	CudaCoreDevice *device;
+	CudaCoreWarp *warp;
 	Elf_Scn *scn;
 	Elf_Data data;
-	CUDBGResult rc;
 
 	TRACE_FUNC("dev=%u sm=%u wp=%u addr=0x%llx buf=%p sz=%u",
 		   dev, sm, wp, addr, buf, sz);
 
 	VERIFY_ARG(buf);
 
-	rc = determineCTAId (dev, sm, wp, &ctaId);
-	if (rc != CUDBG_SUCCESS)
-		return rc;
+	GET_WARP(warp, CUDBG_ERROR_UNKNOWN, dev, sm, wp);
+	GET_DEVICE(device, CUDBG_ERROR_UNKNOWN, dev);
+
+	if (warp->ctaIdx >= device->numWarps)
+		return CUDBG_ERROR_MISSING_DATA;
 
-	GET_TABLE_ENTRY(scn, CUDBG_ERROR_MISSING_DATA,
-			"cta%u_sm%u_dev%u_shared", ctaId, sm, dev);
+	LOAD_SECTIONS(CUDA_CORE_LAZY_SHARED, CUDBG_ERROR_MISSING_DATA);
+
+	scn = device->shared[sm * device->numWarps + warp->ctaIdx];
+	if (scn == NULL)
+		return CUDBG_ERROR_MISSING_DATA;
 
 	if (cuCoreReadSectionData(curcc->e, scn, &data) != 0)
 		return CUDBG_ERROR_UNKNOWN;
@@ -324,6 +310,7 @@ DEF_API_CALL(readLocalMemory)(uint32_t dev, uint32_t sm, uint32_t wp,
 			      uint32_t ln, uint64_t addr, void *buf,
 			      uint32_t sz)
 {
+	CudaCoreLane *lane;
 	Elf_Scn *scn;
 	Elf64_Shdr *shdr;
 	Elf_Data data;
@@ -334,8 +321,12 @@ DEF_API_CALL(readLocalMemory)(uint32_t dev, uint32_t sm, uint32_t wp,
 
 	VERIFY_ARG(buf);
 
-	GET_TABLE_ENTRY(scn, CUDBG_ERROR_MISSING_DATA,
-			"ln%u_wp%u_sm%u_dev%u_local", ln, wp, sm, dev);
+	GET_LANE(lane, CUDBG_ERROR_MISSING_DATA, dev, sm, wp, ln);
+	LOAD_SECTIONS(CUDA_CORE_LAZY_LOCAL, CUDBG_ERROR_MISSING_DATA);
+
+	scn = lane->local;
+	if (scn == NULL)
+		return CUDBG_ERROR_MISSING_DATA;
 
 	if (cuCoreReadSectionData(curcc->e, scn, &data) != 0)
 		return CUDBG_ERROR_UNKNOWN;
@@ -414,6 +405,8 @@ DEF_API_CALL(readParamMemory)(uint32_t dev, uint32_t sm, uint32_t wp,
 	GET_TABLE_ENTRY(gte, CUDBG_ERROR_INVALID_GRID,
 			"grid%llu_dev%u", gridId, dev);
 
+	LOAD_SECTIONS(CUDA_CORE_LAZY_PARAM, CUDBG_ERROR_UNKNOWN);
+
 	GET_TABLE_ENTRY(scn, CUDBG_ERROR_UNKNOWN,
 			"grid%llu_dev%u_param", gridId, dev);
 
@@ -446,34 +439,29 @@ DEF_API_CALL(readWarpState)(uint32_t devId, uint32_t sm, uint32_t wp,
 {
 	uint32_t numLanes;
 	uint32_t ln;
-	CudbgWarpTableEntry *wte;
+	CudaCoreWarp *warp;
 	CudbgGridTableEntry *gte;
-	CudbgCTATableEntry *ctate;
-	CudbgThreadTableEntry *tte;
+	CudaCoreLane *lane;
 	CUDBGResult rc;
 
 	TRACE_FUNC("devId=%u sm=%u wp=%u state=%p", devId, sm, wp, state);
 
 	VERIFY_ARG(state);
 
-	GET_TABLE_ENTRY(wte, CUDBG_ERROR_INVALID_WARP,
-			"wp%u_sm%u_dev%u", wp, sm, devId);
-
-	GET_TABLE_ENTRY(ctate, CUDBG_ERROR_UNKNOWN,
-			"wp%u_sm%u_dev%u_cta", wp, sm, devId);
+	GET_WARP(warp, CUDBG_ERROR_INVALID_WARP, devId, sm, wp);
 
 	GET_TABLE_ENTRY(gte, CUDBG_ERROR_INVALID_GRID,
-			"grid%llu_dev%u", ctate->gridId64, devId);
+			"grid%llu_dev%u", warp->ctate->gridId64, devId);
 
 	memset(state, 0, sizeof(*state));
 	state->gridId = gte->gridId64;
-	state->errorPC = wte->errorPC;
-	state->blockIdx.x = ctate->blockIdxX;
-	state->blockIdx.y = ctate->blockIdxY;
-	state->blockIdx.z = ctate->blockIdxZ;
-	state->validLanes = wte->validLanesMask;
-	state->activeLanes = wte->activeLanesMask;
-	state->errorPCValid = wte->errorPCValid;
+	state->errorPC = warp->wte->errorPC;
+	state->blockIdx.x = warp->ctate->blockIdxX;
+	state->blockIdx.y = warp->ctate->blockIdxY;
+	state->blockIdx.z = warp->ctate->blockIdxZ;
+	state->validLanes = warp->wte->validLanesMask;
+	state->activeLanes = warp->wte->activeLanesMask;
+	state->errorPCValid = warp->wte->errorPCValid;
 
 	/* Get number of lanes */
 	rc = API_CALL(getNumLanes)(devId, &numLanes);
@@ -486,14 +474,13 @@ DEF_API_CALL(readWarpState)(uint32_t devId, uint32_t sm, uint32_t wp,
 			continue;
 
 		/* For every valid lane there must be a corresponding ThreadTableEntry */
-		GET_TABLE_ENTRY(tte, CUDBG_ERROR_INTERNAL,
-				"ln%u_wp%u_sm%u_dev%u", ln, wp, sm, devId);
-
-		state->lane[ln].virtualPC = tte->virtualPC;
-		state->lane[ln].threadIdx.x = tte->threadIdxX;
-		state->lane[ln].threadIdx.y = tte->threadIdxY;
-		state->lane[ln].threadIdx.z = tte->threadIdxZ;
-		state->lane[ln].exception = tte->exception;
+		GET_LANE(lane, CUDBG_ERROR_INTERNAL, devId, sm, wp, ln);
+
+		state->lane[ln].virtualPC = lane->tte->virtualPC;
+		state->lane[ln].threadIdx.x = lane->tte->threadIdxX;
+		state->lane[ln].threadIdx.y = lane->tte->threadIdxY;
+		state->lane[ln].threadIdx.z = lane->tte->threadIdxZ;
+		state->lane[ln].exception = lane->tte->exception;
 	}
 
 	return CUDBG_SUCCESS;
@@ -502,19 +489,18 @@ DEF_API_CALL(readWarpState)(uint32_t devId, uint32_t sm, uint32_t wp,
 DEF_API_CALL(readThreadIdx)(uint32_t dev, uint32_t sm, uint32_t wp,
 			    uint32_t ln, CuDim3 *threadIdx)
 {
-	CudbgThreadTableEntry *tte;
+	CudaCoreLane *lane;
 
 	TRACE_FUNC("dev=%u sm=%u wp=%u ln=%u threadIdx=%p",
 		   dev, sm, wp, ln, threadIdx);
 
 	VERIFY_ARG(threadIdx);
 
-	GET_TABLE_ENTRY(tte, CUDBG_ERROR_INVALID_LANE,
-			"ln%u_wp%u_sm%u_dev%u", ln, wp, sm, dev);
+	GET_LANE(lane, CUDBG_ERROR_INVALID_LANE, dev, sm, wp, ln);
 
-	threadIdx->x = tte->threadIdxX;
-	threadIdx->y = tte->threadIdxY;
-	threadIdx->z = tte->threadIdxZ;
+	threadIdx->x = lane->tte->threadIdxX;
+	threadIdx->y = lane->tte->threadIdxY;
+	threadIdx->z = lane->tte->threadIdxZ;
 
 	return CUDBG_SUCCESS;
 }
@@ -522,16 +508,15 @@ DEF_API_CALL(readThreadIdx)(uint32_t dev, uint32_t sm, uint32_t wp,
 DEF_API_CALL(readVirtualPC)(uint32_t dev, uint32_t sm, uint32_t wp,
 			    uint32_t ln, uint64_t *pc)
 {
-	CudbgThreadTableEntry *tte;
+	CudaCoreLane *lane;
 
 	TRACE_FUNC("dev=%u sm=%u wp=%u ln=%u pc=%p", dev, sm, wp, ln, pc);
 
 	VERIFY_ARG(pc);
 
-	GET_TABLE_ENTRY(tte, CUDBG_ERROR_INVALID_LANE,
-			"ln%u_wp%u_sm%u_dev%u", ln, wp, sm, dev);
+	GET_LANE(lane, CUDBG_ERROR_INVALID_LANE, dev, sm, wp, ln);
 
-	*pc = tte->virtualPC;
+	*pc = lane->tte->virtualPC;
 
 	return CUDBG_SUCCESS;
 }
@@ -564,22 +549,17 @@ DEF_API_CALL(getTID)(uint32_t dev, uint32_t sm, uint32_t wp, uint32_t *tid)
 DEF_API_CALL(readBlockIdx)(uint32_t dev, uint32_t sm, uint32_t wp,
 			   CuDim3 *blockIdx)
 {
-	CudbgWarpTableEntry *wte;
-	CudbgCTATableEntry *ctate;
+	CudaCoreWarp *warp;
 
 	TRACE_FUNC("dev=%u sm=%u wp=%u blockIdx=%p", dev, sm, wp, blockIdx);
 
 	VERIFY_ARG(blockIdx);
 
-	GET_TABLE_ENTRY(wte, CUDBG_ERROR_INVALID_WARP,
-			"wp%u_sm%u_dev%u", wp, sm, dev);
-
-	GET_TABLE_ENTRY(ctate, CUDBG_ERROR_UNKNOWN,
-			"wp%u_sm%u_dev%u_cta", wp, sm, dev);
+	GET_WARP(warp, CUDBG_ERROR_INVALID_WARP, dev, sm, wp);
 
-	blockIdx->x = ctate->blockIdxX;
-	blockIdx->y = ctate->blockIdxY;
-	blockIdx->z = ctate->blockIdxZ;
+	blockIdx->x = warp->ctate->blockIdxX;
+	blockIdx->y = warp->ctate->blockIdxY;
+	blockIdx->z = warp->ctate->blockIdxZ;
 
 	return CUDBG_SUCCESS;
 }
@@ -719,6 +699,7 @@ DEF_API_CALL(readRegisterRange)(uint32_t devId, uint32_t sm, uint32_t wp,
 				uint32_t registers_size, uint32_t *registers)
 {
 	uint32_t max_registers;
+	CudaCoreLane *lane;
 	Elf_Scn *scn;
 	Elf_Data data;
 	unsigned offset;
@@ -745,8 +726,12 @@ DEF_API_CALL(readRegisterRange)(uint32_t devId, uint32_t sm, uint32_t wp,
 	if (index + registers_size > max_registers)
 		return CUDBG_ERROR_INVALID_ARGS;
 
-	GET_TABLE_ENTRY(scn, CUDBG_ERROR_INVALID_ARGS,
-			"regs_dev%u_sm%u_wp%u_ln%u", devId, sm, wp, ln);
+	GET_LANE(lane, CUDBG_ERROR_INVALID_ARGS, devId, sm, wp, ln);
+	LOAD_SECTIONS(CUDA_CORE_LAZY_REGS, CUDBG_ERROR_INVALID_ARGS);
+
+	scn = lane->regs;
+	if (scn == NULL)
+		return CUDBG_ERROR_INVALID_ARGS;
 
 	if (cuCoreReadSectionData(curcc->e, scn, &data) != 0)
 		return CUDBG_ERROR_UNKNOWN;
@@ -779,23 +764,23 @@ DEF_API_CALL(readRegister)(uint32_t devId, uint32_t sm, uint32_t wp,
 DEF_API_CALL(readBrokenWarps)(uint32_t devId, uint32_t sm,
 			      uint64_t *brokenWarpsMask)
 {
+	CudaCoreDevice *device;
 	CudbgWarpTableEntry *wte;
-	uint32_t wp, warpsPerSM;
-	CUDBGResult rc;
+	uint32_t wp;
 
 	TRACE_FUNC("devId=%u sm=%u brokenWarpsMask=%p",
 		   devId, sm, brokenWarpsMask);
 
 	VERIFY_ARG(brokenWarpsMask);
 
-	rc = API_CALL(getNumWarps)(devId, &warpsPerSM);
-	if (rc != CUDBG_SUCCESS)
-		return rc;
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, devId);
 
 	*brokenWarpsMask = 0;
-	for (wp = 0; wp < warpsPerSM; ++wp) {
-		wte = cuCoreGetMapEntry(&curcc->tableEntriesMap,
-					"wp%u_sm%u_dev%u", wp, sm, devId);
+	if (sm >= device->numSMs)
+		return CUDBG_SUCCESS;
+
+	for (wp = 0; wp < device->numWarps; ++wp) {
+		wte = device->warps[sm * device->numWarps + wp].wte;
 		if (wte && wte->isWarpBroken)
 			*brokenWarpsMask |= 1ULL << wp;
 	}
@@ -806,22 +791,22 @@ DEF_API_CALL(readBrokenWarps)(uint32_t devId, uint32_t sm,
 DEF_API_CALL(readValidWarps)(uint32_t devId, uint32_t sm,
 			     uint64_t *validWarpsMask)
 {
-	uint32_t wp, warpsPerSM;
-	CUDBGResult rc;
+	CudaCoreDevice *device;
+	uint32_t wp;
 
 	TRACE_FUNC("devId=%u sm=%u validWarpsMask=%p",
 		   devId, sm, validWarpsMask);
 
 	VERIFY_ARG(validWarpsMask);
 
-	rc = API_CALL(getNumWarps)(devId, &warpsPerSM);
-	if (rc != CUDBG_SUCCESS)
-		return rc;
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, devId);
 
 	*validWarpsMask = 0;
-	for (wp = 0; wp < warpsPerSM; ++wp) {
-		if (cuCoreGetMapEntry(&curcc->tableEntriesMap,
-				      "wp%u_sm%u_dev%u", wp, sm, devId))
+	if (sm >= device->numSMs)
+		return CUDBG_SUCCESS;
+
+	for (wp = 0; wp < device->numWarps; ++wp) {
+		if (device->warps[sm * device->numWarps + wp].wte != NULL)
 			*validWarpsMask |= 1ULL << wp;
 	}
 
@@ -831,17 +816,16 @@ DEF_API_CALL(readValidWarps)(uint32_t devId, uint32_t sm,
 DEF_API_CALL(readValidLanes)(uint32_t dev, uint32_t sm, uint32_t wp,
 			     uint32_t *validLanesMask)
 {
-	CudbgWarpTableEntry *wte;
+	CudaCoreWarp *warp;
 
 	TRACE_FUNC("dev=%u sm=%u wp=%u validLanesMask=%p",
 		   dev, sm, wp, validLanesMask);
 
 	VERIFY_ARG(validLanesMask);
 
-	GET_TABLE_ENTRY(wte, CUDBG_ERROR_INVALID_WARP,
-			"wp%u_sm%u_dev%u", wp, sm, dev);
+	GET_WARP(warp, CUDBG_ERROR_INVALID_WARP, dev, sm, wp);
 
-	*validLanesMask = wte->validLanesMask;
+	*validLanesMask = warp->wte->validLanesMask;
 
 	return CUDBG_SUCCESS;
 }
@@ -849,33 +833,32 @@ DEF_API_CALL(readValidLanes)(uint32_t dev, uint32_t sm, uint32_t wp,
 DEF_API_CALL(readActiveLanes)(uint32_t dev, uint32_t sm, uint32_t wp,
 			      uint32_t *activeLanesMask)
 {
-	CudbgWarpTableEntry *wte;
+	CudaCoreWarp *warp;
 
 	TRACE_FUNC("dev=%u sm=%u wp=%u activeLanesMask=%p",
 		   dev, sm, wp, activeLanesMask);
 
 	VERIFY_ARG(activeLanesMask);
 
-	GET_TABLE_ENTRY(wte, CUDBG_ERROR_INVALID_WARP,
-			"wp%u_sm%u_dev%u", wp, sm, dev);
+	GET_WARP(warp, CUDBG_ERROR_INVALID_WARP, dev, sm, wp);
 
-	*activeLanesMask = wte->activeLanesMask;
+	*activeLanesMask = warp->wte->activeLanesMask;
 
 	return CUDBG_SUCCESS;
 }
 
 DEF_API_CALL(getSmType)(uint32_t devId, char *buf, uint32_t sz)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 	const char *smType = NULL;
 
 	TRACE_FUNC("devId=%u buf=%p sz=%u", devId, buf, sz);
 
 	VERIFY_ARG(buf);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", devId);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, devId);
 
-	smType = cuCoreGetStrTabByIndex(curcc, dte->smType);
+	smType = cuCoreGetStrTabByIndex(curcc, device->dte->smType);
 	strncpy(buf, smType, sz);
 
 	return CUDBG_SUCCESS;
@@ -883,16 +866,16 @@ DEF_API_CALL(getSmType)(uint32_t devId, char *buf, uint32_t sz)
 
 DEF_API_CALL(getDeviceName)(uint32_t devId, char *buf, uint32_t sz)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 	const char *devName = NULL;
 
 	TRACE_FUNC("devId=%u buf=%p sz=%u", devId, buf, sz);
 
 	VERIFY_ARG(buf);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", devId);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, devId);
 
-	devName = cuCoreGetStrTabByIndex(curcc, dte->devName);
+	devName = cuCoreGetStrTabByIndex(curcc, device->dte->devName);
 	strncpy(buf, devName, sz);
 
 	return CUDBG_SUCCESS;
@@ -901,7 +884,7 @@ DEF_API_CALL(getDeviceName)(uint32_t devId, char *buf, uint32_t sz)
 DEF_API_CALL(getDevicePCIBusInfo)(uint32_t devId, uint32_t *pciBusId,
 				  uint32_t *pciDevId)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 
 	TRACE_FUNC("devId=%u pciBusId=%p pciDevId=%p",
 		   devId, pciBusId, pciDevId);
@@ -909,26 +892,26 @@ DEF_API_CALL(getDevicePCIBusInfo)(uint32_t devId, uint32_t *pciBusId,
 	VERIFY_ARG(pciBusId);
 	VERIFY_ARG(pciDevId);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", devId);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, devId);
 
-	*pciDevId = dte->pciDevId;
-	*pciBusId = dte->pciBusId;
+	*pciDevId = device->dte->pciDevId;
+	*pciBusId = device->dte->pciBusId;
 
 	return CUDBG_SUCCESS;
 }
 
 DEF_API_CALL(getDeviceType)(uint32_t devId, char *buf, uint32_t sz)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 	const char *devType = NULL;
 
 	TRACE_FUNC("devId=%u buf=%p sz=%u", devId, buf, sz);
 
 	VERIFY_ARG(buf);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", devId);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, devId);
 
-	devType = cuCoreGetStrTabByIndex(curcc, dte->devType);
+	devType = cuCoreGetStrTabByIndex(curcc, device->dte->devType);
 	strncpy(buf, devType, sz);
 
 	return CUDBG_SUCCESS;
@@ -942,6 +925,9 @@ DEF_API_CALL(getNextEvent)(CUDBGEventQueueType type, CUDBGEvent *event)
 
 	VERIFY_ARG(event);
 
+	/* ELF image load events are only known once the images are read */
+	LOAD_SECTIONS(CUDA_CORE_LAZY_ELF, CUDBG_ERROR_INVALID_MODULE);
+
 	inputEvent = cuCoreGetEvent(curcc);
 	if (inputEvent == NULL || type == CUDBG_EVENT_QUEUE_TYPE_ASYNC)
 		return CUDBG_ERROR_NO_EVENT_AVAILABLE;
@@ -1009,7 +995,7 @@ DEF_API_CALL(readDeviceExceptionState)(uint32_t devId,
 DEF_API_CALL(readErrorPC)(uint32_t devId, uint32_t sm, uint32_t wp,
 			  uint64_t *errorPC, bool *errorPCValid)
 {
-	CudbgWarpTableEntry *wte;
+	CudaCoreWarp *warp;
 
 	TRACE_FUNC("devId=%u sm=%u wp=%u errorPC=%p errorPCValid=%p",
 		   devId, sm, wp, errorPC, errorPCValid);
@@ -1017,11 +1003,10 @@ DEF_API_CALL(readErrorPC)(uint32_t devId, uint32_t sm, uint32_t wp,
 	VERIFY_ARG(errorPC);
 	VERIFY_ARG(errorPCValid);
 
-	GET_TABLE_ENTRY(wte, CUDBG_ERROR_INVALID_WARP,
-			"wp%u_sm%u_dev%u", wp, sm, devId);
+	GET_WARP(warp, CUDBG_ERROR_INVALID_WARP, devId, sm, wp);
 
-	*errorPC = wte->errorPC;
-	*errorPCValid = wte->errorPCValid;
+	*errorPC = warp->wte->errorPC;
+	*errorPCValid = warp->wte->errorPCValid;
 
 	return CUDBG_SUCCESS;
 }
@@ -1029,16 +1014,15 @@ DEF_API_CALL(readErrorPC)(uint32_t devId, uint32_t sm, uint32_t wp,
 DEF_API_CALL(readPC)(uint32_t devId, uint32_t sm, uint32_t wp, uint32_t ln,
 		     uint64_t *pc)
 {
-	CudbgThreadTableEntry *tte;
+	CudaCoreLane *lane;
 
 	TRACE_FUNC("devId=%u sm=%u wp=%u ln=%u pc=%p", devId, sm, wp, ln, pc);
 
 	VERIFY_ARG(pc);
 
-	GET_TABLE_ENTRY(tte, CUDBG_ERROR_INVALID_LANE,
-			"ln%u_wp%u_sm%u_dev%u", ln, wp, sm, devId);
+	GET_LANE(lane, CUDBG_ERROR_INVALID_LANE, devId, sm, wp, ln);
 
-	*pc = tte->physPC;
+	*pc = lane->tte->physPC;
 
 	return CUDBG_SUCCESS;
 }
@@ -1055,6 +1039,8 @@ DEF_API_CALL(getElfImageByHandle)(uint32_t devId, uint64_t handle,
 
 	VERIFY_ARG(elfImage);
 
+	LOAD_SECTIONS(CUDA_CORE_LAZY_ELF, CUDBG_ERROR_INVALID_ARGS);
+
 	GET_TABLE_ENTRY(scn, CUDBG_ERROR_INVALID_ARGS,
 			"%celf_handle%llx",
 			type ? 'r':'u', handle);
@@ -1073,17 +1059,16 @@ DEF_API_CALL(getElfImageByHandle)(uint32_t devId, uint64_t handle,
 DEF_API_CALL(readLaneException)(uint32_t dev, uint32_t sm, uint32_t wp,
 				uint32_t ln, CUDBGException_t *exception)
 {
-	CudbgThreadTableEntry *tte;
+	CudaCoreLane *lane;
 
 	TRACE_FUNC("dev=%u sm=%u wp=%u ln=%u exception=%p",
 		   dev, sm, wp, ln, exception);
 
 	VERIFY_ARG(exception);
 
-	GET_TABLE_ENTRY(tte, CUDBG_ERROR_INVALID_LANE,
-			"ln%u_wp%u_sm%u_dev%u", ln, wp, sm, dev);
+	GET_LANE(lane, CUDBG_ERROR_INVALID_LANE, dev, sm, wp, ln);
 
-	*exception = (CUDBGException_t)tte->exception;
+	*exception = (CUDBGException_t)lane->tte->exception;
 
 	return CUDBG_SUCCESS;
 }
@@ -1091,17 +1076,16 @@ DEF_API_CALL(readLaneException)(uint32_t dev, uint32_t sm, uint32_t wp,
 DEF_API_CALL(readLaneStatus)(uint32_t devId, uint32_t sm, uint32_t wp,
 			     uint32_t ln, bool *error)
 {
-	CudbgThreadTableEntry *tte;
+	CudaCoreLane *lane;
 
 	TRACE_FUNC("devId=%u sm=%u wp=%u ln=%u error=%p",
 		   devId, sm, wp, ln, error);
 
 	VERIFY_ARG(error);
 
-	GET_TABLE_ENTRY(tte, CUDBG_ERROR_INVALID_LANE,
-			"ln%u_wp%u_sm%u_dev%u", ln, wp, sm, devId);
+	GET_LANE(lane, CUDBG_ERROR_INVALID_LANE, devId, sm, wp, ln);
 
-	*error = tte->exception != CUDBG_EXCEPTION_UNKNOWN;
+	*error = lane->tte->exception != CUDBG_EXCEPTION_UNKNOWN;
 
 	return CUDBG_SUCCESS;
 }
@@ -1109,17 +1093,16 @@ DEF_API_CALL(readLaneStatus)(uint32_t devId, uint32_t sm, uint32_t wp,
 DEF_API_CALL(readSyscallCallDepth)(uint32_t dev, uint32_t sm, uint32_t wp,
 				   uint32_t ln, uint32_t *depth)
 {
-	CudbgThreadTableEntry *tte;
+	CudaCoreLane *lane;
 
 	TRACE_FUNC("dev=%u sm=%u wp=%u ln=%u depth=%p",
 		   dev, sm, wp, ln, depth);
 
 	VERIFY_ARG(depth);
 
-	GET_TABLE_ENTRY(tte, CUDBG_ERROR_INVALID_LANE,
-			"ln%u_wp%u_sm%u_dev%u", ln, wp, sm, dev);
+	GET_LANE(lane, CUDBG_ERROR_INVALID_LANE, dev, sm, wp, ln);
 
-	*depth = tte->syscallCallDepth;
+	*depth = lane->tte->syscallCallDepth;
 
 	return CUDBG_SUCCESS;
 }
@@ -1127,21 +1110,44 @@ DEF_API_CALL(readSyscallCallDepth)(uint32_t dev, uint32_t sm, uint32_t wp,
 DEF_API_CALL(readCallDepth)(uint32_t dev, uint32_t sm, uint32_t wp,
 			    uint32_t ln, uint32_t *depth)
 {
-	CudbgThreadTableEntry *tte;
+	CudaCoreLane *lane;
 
 	TRACE_FUNC("dev=%u sm=%u wp=%u ln=%u depth=%p",
 		   dev, sm, wp, ln, depth);
 
 	VERIFY_ARG(depth);
 
-	GET_TABLE_ENTRY(tte, CUDBG_ERROR_INVALID_LANE,
-			"ln%u_wp%u_sm%u_dev%u", ln, wp, sm, dev);
+	GET_LANE(lane, CUDBG_ERROR_INVALID_LANE, dev, sm, wp, ln);
 
-	*depth = tte->callDepth;
+	*depth = lane->tte->callDepth;
 
 	return CUDBG_SUCCESS;
 }
 
+static CudbgBacktraceTableEntry *getBacktraceEntry(uint32_t dev, uint32_t sm,
+						   uint32_t wp, uint32_t ln,
+						   uint32_t level)
+{
+	CudaCoreLane *lane;
+	size_t i;
+
+	lane = cuCoreGetLane(curcc, dev, sm, wp, ln);
+	if (lane == NULL)
+		return NULL;
+
+	/* Entries are normally stored by level */
+	if (level < lane->numBt && lane->bt[level].level == level)
+		return &lane->bt[level];
+
+	for (i = 0; i < lane->numBt; ++i)
+		if (lane->bt[i].level == level)
+			return &lane->bt[i];
+
+	cuCoreSetErrorMsg("Backtrace entry bt%u_ln%u_wp%u_sm%u_dev%u not found",
+			  level, ln, wp, sm, dev);
+	return NULL;
+}
+
 DEF_API_CALL(readReturnAddress)(uint32_t dev, uint32_t sm, uint32_t wp,
 				uint32_t ln, uint32_t level, uint64_t *ra)
 {
@@ -1152,8 +1158,9 @@ DEF_API_CALL(readReturnAddress)(uint32_t dev, uint32_t sm, uint32_t wp,
 
 	VERIFY_ARG(ra);
 
-	GET_TABLE_ENTRY(bte, CUDBG_ERROR_INVALID_CALL_LEVEL,
-			"bt%u_ln%u_wp%u_sm%u_dev%u", level, ln, wp, sm, dev);
+	bte = getBacktraceEntry(dev, sm, wp, ln, level);
+	if (bte == NULL)
+		return CUDBG_ERROR_INVALID_CALL_LEVEL;
 
 	*ra = bte->returnAddress;
 
@@ -1171,8 +1178,9 @@ DEF_API_CALL(readVirtualReturnAddress)(uint32_t dev, uint32_t sm, uint32_t wp,
 
 	VERIFY_ARG(ra);
 
-	GET_TABLE_ENTRY(bte, CUDBG_ERROR_INVALID_CALL_LEVEL,
-			"bt%u_ln%u_wp%u_sm%u_dev%u", level, ln, wp, sm, dev);
+	bte = getBacktraceEntry(dev, sm, wp, ln, level);
+	if (bte == NULL)
+		return CUDBG_ERROR_INVALID_CALL_LEVEL;
 
 	*ra = bte->virtualReturnAddress;
 
@@ -1224,15 +1232,15 @@ DEF_API_CALL(getAdjustedCodeAddress)(uint32_t devId, uint64_t address,
 
 DEF_API_CALL(getNumPredicates)(uint32_t dev, uint32_t *numPredicates)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 
 	TRACE_FUNC("dev=%u numPredicates=%p", dev, numPredicates);
 
 	VERIFY_ARG(numPredicates);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", dev);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, dev);
 
-	*numPredicates = dte->numPredicatesPrLane;
+	*numPredicates = device->dte->numPredicatesPrLane;
 
 	return CUDBG_SUCCESS;
 }
@@ -1242,6 +1250,7 @@ DEF_API_CALL(readPredicates)(uint32_t dev, uint32_t sm, uint32_t wp,
 			     uint32_t *predicates)
 {
 	uint32_t num_predicates;
+	CudaCoreLane *lane;
 	Elf_Scn *scn;
 	Elf_Data data;
 	size_t size;
@@ -1263,8 +1272,12 @@ DEF_API_CALL(readPredicates)(uint32_t dev, uint32_t sm, uint32_t wp,
 	if (predicates_size > num_predicates)
 		return CUDBG_ERROR_INVALID_ARGS;
 
-	GET_TABLE_ENTRY(scn, CUDBG_ERROR_INVALID_ARGS,
-			"pred_dev%u_sm%u_wp%u_ln%u", dev, sm, wp, ln);
+	GET_LANE(lane, CUDBG_ERROR_INVALID_ARGS, dev, sm, wp, ln);
+	LOAD_SECTIONS(CUDA_CORE_LAZY_REGS, CUDBG_ERROR_INVALID_ARGS);
+
+	scn = lane->pred;
+	if (scn == NULL)
+		return CUDBG_ERROR_INVALID_ARGS;
 
 	if (cuCoreReadSectionData(curcc->e, scn, &data) != 0)
 		return CUDBG_ERROR_UNKNOWN;
@@ -1283,16 +1296,15 @@ DEF_API_CALL(readPredicates)(uint32_t dev, uint32_t sm, uint32_t wp,
 DEF_API_CALL(readCCRegister)(uint32_t dev, uint32_t sm, uint32_t wp,
 			     uint32_t ln, uint32_t *val)
 {
-	CudbgThreadTableEntry *tte;
+	CudaCoreLane *lane;
 
 	TRACE_FUNC("dev=%u sm=%u wp=%u ln=%u val=%p", dev, sm, wp, ln, val);
 
 	VERIFY_ARG(val);
 
-	GET_TABLE_ENTRY(tte, CUDBG_ERROR_INVALID_LANE,
-			"ln%u_wp%u_sm%u_dev%u", ln, wp, sm, dev);
+	GET_LANE(lane, CUDBG_ERROR_INVALID_LANE, dev, sm, wp, ln);
 
-	*val = tte->ccRegister;
+	*val = lane->tte->ccRegister;
 
 	return CUDBG_SUCCESS;
 }
@@ -1364,7 +1376,7 @@ DEF_API_CALL(getManagedMemoryRegionInfo)(uint64_t startAddress,
 					 uint32_t *numEntries)
 {
 	UT_array *managedSegs = curcc->managedMemorySegs;
-	MemorySeg *memorySeg = (MemorySeg *)utarray_front(managedSegs);
+	MemorySeg *memorySeg;
 
 	TRACE_FUNC("startAddress=0x%llx memoryInfo=%p "
 		   "memoryInfo_size=%u numEntries=%p", 
@@ -1373,6 +1385,10 @@ DEF_API_CALL(getManagedMemoryRegionInfo)(uint64_t startAddress,
 	VERIFY_ARG(memoryInfo);
 	VERIFY_ARG(numEntries);
 
+	LOAD_SECTIONS(CUDA_CORE_LAZY_GLOBAL, CUDBG_ERROR_UNKNOWN);
+
+	memorySeg = (MemorySeg *)utarray_front(managedSegs);
+
 	/* Skip segments until startAddress is found */
 	while (memorySeg && !(memorySeg->address <= startAddress &&
 			memorySeg->address + memorySeg->size > startAddress))
@@ -1393,7 +1409,7 @@ DEF_API_CALL(getManagedMemoryRegionInfo)(uint64_t startAddress,
 DEF_API_CALL(disassemble)(uint32_t dev, uint64_t addr, uint32_t *instSize,
 			  char *buf, uint32_t sz)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 
 	TRACE_FUNC("dev=%u addr=0x%llx instSize=%p buf=%p sz=%u", dev, addr, instSize, buf, sz);
 
@@ -1403,8 +1419,8 @@ DEF_API_CALL(disassemble)(uint32_t dev, uint64_t addr, uint32_t *instSize,
 	 * size, which is true on all GPU architectures except FERMI.
 	 * Since cuda-gdb no longer supports FERMI as of 9.0 toolkit, this
 	 * assumption is valid. */
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", dev);
-	*instSize = dte->instructionSize;
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, dev);
+	*instSize = device->dte->instructionSize;
 
 	if (!sz)
 		return CUDBG_SUCCESS;
@@ -1415,15 +1431,15 @@ DEF_API_CALL(disassemble)(uint32_t dev, uint64_t addr, uint32_t *instSize,
 
 DEF_API_CALL(getNumUniformRegisters)(uint32_t dev, uint32_t *numRegs)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 
 	TRACE_FUNC("dev=%u numRegs=%p", dev, numRegs);
 
 	VERIFY_ARG(numRegs);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", dev);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, dev);
 
-	*numRegs = dte->numUniformRegsPrWarp;
+	*numRegs = device->dte->numUniformRegsPrWarp;
 
 	return CUDBG_SUCCESS;
 }
@@ -1433,6 +1449,7 @@ DEF_API_CALL(readUniformRegisterRange)(uint32_t devId, uint32_t sm, uint32_t wp,
                                        uint32_t registers_size, uint32_t *registers)
 {
 	uint32_t max_registers;
+	CudaCoreWarp *warp;
 	Elf_Scn *scn;
 	Elf_Data data;
 	unsigned offset;
@@ -1452,8 +1469,12 @@ DEF_API_CALL(readUniformRegisterRange)(uint32_t devId, uint32_t sm, uint32_t wp,
 	if (devId >= cuCoreGetNumDevices(curcc))
 		return CUDBG_ERROR_INVALID_DEVICE;
 
-	GET_TABLE_ENTRY(scn, CUDBG_ERROR_MISSING_DATA,
-			"uregs_dev%u_sm%u_wp%u", devId, sm, wp);
+	GET_WARP(warp, CUDBG_ERROR_MISSING_DATA, devId, sm, wp);
+	LOAD_SECTIONS(CUDA_CORE_LAZY_REGS, CUDBG_ERROR_MISSING_DATA);
+
+	scn = warp->uregs;
+	if (scn == NULL)
+		return CUDBG_ERROR_MISSING_DATA;
 
 	rc = API_CALL(getNumUniformRegisters)(devId, &max_registers);
 	if (rc != CUDBG_SUCCESS)
@@ -1483,15 +1504,15 @@ DEF_API_CALL(readUniformRegisterRange)(uint32_t devId, uint32_t sm, uint32_t wp,
 
 DEF_API_CALL(getNumUniformPredicates)(uint32_t dev, uint32_t *numPredicates)
 {
-	CudbgDeviceTableEntry *dte;
+	CudaCoreDevice *device;
 
 	TRACE_FUNC("dev=%u numPredicates=%p", dev, numPredicates);
 
 	VERIFY_ARG(numPredicates);
 
-	GET_TABLE_ENTRY(dte, CUDBG_ERROR_INVALID_DEVICE, "dev%u", dev);
+	GET_DEVICE(device, CUDBG_ERROR_INVALID_DEVICE, dev);
 
-	*numPredicates = dte->numUniformPredicatesPrWarp;
+	*numPredicates = device->dte->numUniformPredicatesPrWarp;
 
 	return CUDBG_SUCCESS;
 }
@@ -1501,6 +1522,7 @@ DEF_API_CALL(readUniformPredicates)(uint32_t devId, uint32_t sm, uint32_t wp,
 
 {
 	uint32_t max_predicates;
+	CudaCoreWarp *warp;
 	Elf_Scn *scn;
 	Elf_Data data;
 	int size;
@@ -1518,8 +1540,12 @@ DEF_API_CALL(readUniformPredicates)(uint32_t devId, uint32_t sm, uint32_t wp,
 	if (devId >= cuCoreGetNumDevices(curcc))
 		return CUDBG_ERROR_INVALID_DEVICE;
 
-	GET_TABLE_ENTRY(scn, CUDBG_ERROR_MISSING_DATA,
-			"upred_dev%u_sm%u_wp%u", devId, sm, wp);
+	GET_WARP(warp, CUDBG_ERROR_MISSING_DATA, devId, sm, wp);
+	LOAD_SECTIONS(CUDA_CORE_LAZY_REGS, CUDBG_ERROR_MISSING_DATA);
+
+	scn = warp->upred;
+	if (scn == NULL)
+		return CUDBG_ERROR_MISSING_DATA;
 
 	rc = API_CALL(getNumUniformPredicates)(devId, &max_predicates);
 	if (rc != CUDBG_SUCCESS)
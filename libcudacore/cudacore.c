@@ -40,8 +40,19 @@
 
 #include "common.h"
 
+#if !defined(__APPLE__) && !defined(_WIN32)
+/* Sections are only processed in parallel where error messages are
+ * thread-local (see tls.h) */
+#define CUCORE_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 #define ENV_VAR_DEBUG			"CUCORE_DEBUG"
+#define ENV_VAR_THREADS			"CUCORE_THREADS"
 #define GLOBAL_MEMORY_SEGMENTS_MIN	10
+#define PARALLEL_SECTIONS_MIN		64
+#define PARALLEL_THREADS_MAX		32
 #define ERRMSG_LEN			256
 
 static __THREAD char lastErrMsg[ERRMSG_LEN];
@@ -62,6 +73,7 @@ const char *cuCoreErrorMsg(void)
 
 /* Memory segment array descriptor */
 static UT_icd memorySeg_icd = { sizeof(MemorySeg), NULL, NULL, NULL };
+static UT_icd sectionIndex_icd = { sizeof(size_t), NULL, NULL, NULL };
 
 /* ELF core dump image identification signature */
 static unsigned char cudaElfIdent[EI_PAD] = {
@@ -209,6 +221,20 @@ static int cuCoreReadMemorySection(Elf *e, Elf_Scn *scn,
 	memorySeg.scn = scn;
 	memorySeg.address = readUint64(&memorySeg.shdr->sh_addr);
 	memorySeg.size = readUint64(&memorySeg.shdr->sh_size);
+	memorySeg.data = NULL;
+
+	/* Contents are not dumped for every segment: those have no file
+	 * offset, or a range past the end of the core dump */
+	if (readUint64(&memorySeg.shdr->sh_offset) != 0) {
+		Elf_Data data;
+
+		if (elfGetSectionData(e, scn, &data) == 0)
+			memorySeg.data = data.d_buf;
+		else
+			DPRINTF(20, "No data for memory segment 0x%llX: %s\n",
+				(long long unsigned int)memorySeg.address,
+				elfErrorMsg());
+	}
 
 	utarray_push_back(memorySegs, &memorySeg);
 
@@ -288,317 +314,379 @@ void *cuCoreGetMapEntry(MapEntry **map, const char *fmt, ...)
 	return mapEntry->entryPtr;
 }
 
-static int cuCoreReadDeviceTable(CudaCore *cc, Elf_Scn *scn)
+CudaCoreDevice *cuCoreGetDevice(CudaCore *cc, uint32_t devId)
 {
-  uint8_t *dt;
-  size_t dteCoreSz;
-  size_t dte_count;
-  CudbgDeviceTableEntry *dte;
-  size_t dteSz;
-  size_t i;
-
-  if (cuCoreGenericReadTable(cc->e, scn,
-                             &dte_count,
-                             (void **)&dt,
-                             sizeof(CudbgDeviceTableEntry),
-                             &dteCoreSz, NULL, NULL) != 0)
-    return -1;
+	size_t i;
 
-  cc->numDevices = dte_count;
+	/* Device ids normally match their device table index */
+	if (devId < cc->numDevices && cc->devices[devId].dte->devId == devId)
+		return &cc->devices[devId];
 
-  dteSz = (dteCoreSz <= sizeof(CudbgDeviceTableEntry)) ? dteCoreSz : sizeof(CudbgDeviceTableEntry);
+	for (i = 0; i < cc->numDevices; ++i)
+		if (cc->devices[i].dte->devId == devId)
+			break;
 
-  for (i = 0; i < dte_count; ++i) {
-    dte = (CudbgDeviceTableEntry *)calloc(1, sizeof(*dte));
-    VERIFY(dte != NULL, -1, "Could not allocate memory");
+	VERIFY(i < cc->numDevices, NULL, "Device %u not found", devId);
 
-    memcpy(dte, dt, dteSz);
-    dt += dteCoreSz;
+	return &cc->devices[i];
+}
 
-    /* delete the dte if this entry is deleted */
-    if (cuCoreAddMapEntry(&cc->tableEntriesMap, dte, 1,
-                          "dev%u",
-                          dte->devId))
-      return -1;
+CudaCoreWarp *cuCoreGetWarp(CudaCore *cc, uint32_t devId, uint32_t sm,
+			    uint32_t wp)
+{
+	CudaCoreDevice *device;
+	CudaCoreWarp *warp;
 
-    if (cuCoreAddMapEntry(&cc->tableEntriesMap, dte, 0,
-                          "devtbl_offset%llu", (unsigned long long)i))
-      return -1;
-  }
+	device = cuCoreGetDevice(cc, devId);
+	if (device == NULL)
+		return NULL;
 
-  return 0;
+	VERIFY(sm < device->numSMs && wp < device->numWarps, NULL,
+	       "Warp wp%u_sm%u_dev%u out of range", wp, sm, devId);
+
+	warp = &device->warps[sm * device->numWarps + wp];
+	VERIFY(warp->wte != NULL, NULL,
+	       "Warp wp%u_sm%u_dev%u not found", wp, sm, devId);
+
+	return warp;
 }
 
-static int cuCoreReadGridTable(CudaCore *cc, Elf_Scn *scn)
+CudaCoreLane *cuCoreGetLane(CudaCore *cc, uint32_t devId, uint32_t sm,
+			    uint32_t wp, uint32_t ln)
 {
-	size_t gte_count;
-	CudbgGridTableEntry *gt, *gte;
-	CudbgDeviceTableEntry *dte;
-	size_t parent, offset;
-	size_t i;
+	CudaCoreDevice *device;
+	CudaCoreWarp *warp;
 
-	if (cuCoreGenericReadTable(cc->e, scn,
-				   &gte_count,
-				   (void **)&gt,
-				   sizeof(CudbgGridTableEntry),
-				   NULL, &parent, &offset) != 0)
+	warp = cuCoreGetWarp(cc, devId, sm, wp);
+	if (warp == NULL)
+		return NULL;
+
+	device = cuCoreGetDevice(cc, devId);
+
+	VERIFY(ln < device->numLanes && warp->lanes != NULL &&
+	       warp->lanes[ln].tte != NULL, NULL,
+	       "Lane ln%u_wp%u_sm%u_dev%u not found", ln, wp, sm, devId);
+
+	return &warp->lanes[ln];
+}
+
+/* Find the owner of a section: the table entry designated by its
+ * sh_link/sh_info pair, along with the owner of that table. The parent
+ * section is always processed first. */
+static int cuCoreGetSectionOwner(CudaCore *cc, Elf_Scn *scn,
+				 CudaCoreSection *owner)
+{
+	Elf64_Shdr *shdr;
+	CudaCoreSection *parent;
+	size_t parentNdx, offset;
+	char *entry;
+
+	if (cuCoreReadSectionHeader(scn, &shdr) != 0)
 		return -1;
 
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"devtbl_offset%llu",
-				(unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry");
+	parentNdx = readUint32(&shdr->sh_link);
+	offset = readUint32(&shdr->sh_info);
 
-	for (i = 0; i < gte_count; ++i) {
-		gte = &gt[i];
+	memset(owner, 0, sizeof(*owner));
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, gte, 0,
-				      "grid%llu_dev%u",
-				      (unsigned long long)gte->gridId64,
-				      dte->devId))
-			return -1;
+	switch (readUint32(&shdr->sh_type)) {
+	case CUDBG_SHT_GRID_TABLE:
+	case CUDBG_SHT_SM_TABLE:
+		/* sh_info is the device table index */
+		VERIFY(offset < cc->numDevices, -1,
+		       "Could not find Device table entry");
+		owner->devIdx = offset;
+		owner->dte = cc->devices[offset].dte;
+		owner->type = readUint32(&shdr->sh_type);
+		return 0;
+	case CUDBG_SHT_CTX_TABLE:
+		/* Entries are linked to their device by deviceIdx */
+		owner->type = readUint32(&shdr->sh_type);
+		return 0;
+	default:
+		break;
+	}
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, gte, 0,
-				      "grid_section%llu_offset%llu",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn),
-					  (unsigned long long)i))
-			return -1;
+	owner->type = readUint32(&shdr->sh_type);
 
-		/* Index dte by grid section and offset */
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, dte, 0,
-				      "grid_section%llu_offset%llu_dev",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn),
-					  (unsigned long long)i))
-			return -1;
+	if (parentNdx == 0)
+		return 0;
+
+	VERIFY(parentNdx < cc->shnum, -1,
+	       "Invalid parent section '%llu'", (unsigned long long)parentNdx);
+
+	parent = &cc->sections[parentNdx];
+	VERIFY(parent->table != NULL && offset < parent->numEntries, -1,
+	       "Could not find table entry section%llu_offset%llu",
+	       (unsigned long long)parentNdx, (unsigned long long)offset);
+
+	*owner = *parent;
+	owner->type = readUint32(&shdr->sh_type);
+	owner->table = NULL;
+	owner->entrySize = 0;
+	owner->numEntries = 0;
+
+	entry = (char *)parent->table + offset * parent->entrySize;
+
+	switch (parent->type) {
+	case CUDBG_SHT_DEV_TABLE:
+		owner->devIdx = offset;
+		owner->dte = cc->devices[offset].dte;
+		break;
+	case CUDBG_SHT_GRID_TABLE:
+		owner->gte = (CudbgGridTableEntry *)entry;
+		break;
+	case CUDBG_SHT_SM_TABLE:
+		owner->ste = (CudbgSmTableEntry *)entry;
+		break;
+	case CUDBG_SHT_CTA_TABLE:
+		owner->ctate = (CudbgCTATableEntry *)entry;
+		owner->ctaIdx = offset;
+		break;
+	case CUDBG_SHT_WP_TABLE:
+		owner->wte = (CudbgWarpTableEntry *)entry;
+		break;
+	case CUDBG_SHT_LN_TABLE:
+		owner->tte = (CudbgThreadTableEntry *)entry;
+		break;
+	case CUDBG_SHT_CTX_TABLE:
+		owner->cte = (CudbgContextTableEntry *)entry;
+		VERIFY(owner->cte->deviceIdx < cc->numDevices, -1,
+		       "Could not find Device table entry by Context");
+		owner->devIdx = owner->cte->deviceIdx;
+		owner->dte = cc->devices[owner->devIdx].dte;
+		break;
+	case CUDBG_SHT_MOD_TABLE:
+		owner->mte = (CudbgModuleTableEntry *)entry;
+		break;
+	default:
+		VERIFY(false, -1, "Unexpected parent section type (0x%x)",
+		       parent->type);
 	}
 
 	return 0;
 }
 
-static int cuCoreReadSmTable(CudaCore *cc, Elf_Scn *scn)
+/* Read a table section and record it with its owner */
+static int cuCoreReadTableSection(CudaCore *cc, Elf_Scn *scn,
+				  size_t entrySize, CudaCoreSection **section)
 {
-	size_t ste_count;
-	CudbgSmTableEntry *st, *ste;
-	CudbgDeviceTableEntry *dte;
-	size_t parent, offset;
-	size_t i;
+	CudaCoreSection owner;
 
-	if (cuCoreGenericReadTable(cc->e, scn,
-				   &ste_count,
-				   (void **)&st,
-				   sizeof(CudbgSmTableEntry),
-				   NULL, &parent, &offset) != 0)
+	if (cuCoreGetSectionOwner(cc, scn, &owner) != 0)
+		return -1;
+
+	if (cuCoreGenericReadTable(cc->e, scn, &owner.numEntries, &owner.table,
+				   entrySize, NULL, NULL, NULL) != 0)
 		return -1;
 
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"devtbl_offset%llu",
-				(unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry");
+	owner.entrySize = entrySize;
 
-	for (i = 0; i < ste_count; ++i) {
-		ste = &st[i];
+	*section = &cc->sections[elfGetSectionIndex(cc->e, scn)];
+	**section = owner;
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, ste, 0,
-				      "sm%u_dev%u",
-				      ste->smId,
-				      dte->devId))
-			return -1;
+	return 0;
+}
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, ste, 0,
-				      "smtbl_section%llu_offset%llu",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+/* Get the warp a section belongs to */
+static CudaCoreWarp *cuCoreGetOwnerWarp(CudaCore *cc, CudaCoreSection *owner)
+{
+	CudaCoreDevice *device;
 
-		/* Link SM table entry to device */
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, dte, 0,
-				      "smtbl_section%llu_offset%llu_dev",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+	VERIFY(owner->dte != NULL && owner->ste != NULL && owner->wte != NULL,
+	       NULL, "Could not find Warp table entry");
+
+	device = &cc->devices[owner->devIdx];
+
+	VERIFY(owner->ste->smId < device->numSMs &&
+	       owner->wte->warpId < device->numWarps, NULL,
+	       "Warp wp%u_sm%u_dev%u out of range",
+	       owner->wte->warpId, owner->ste->smId, owner->dte->devId);
+
+	return &device->warps[owner->ste->smId * device->numWarps +
+			      owner->wte->warpId];
+}
+
+/* Get the lane a section belongs to */
+static CudaCoreLane *cuCoreGetOwnerLane(CudaCore *cc, CudaCoreSection *owner)
+{
+	CudaCoreWarp *warp;
+	CudaCoreDevice *device;
+
+	warp = cuCoreGetOwnerWarp(cc, owner);
+	if (warp == NULL)
+		return NULL;
+
+	VERIFY(owner->tte != NULL, NULL, "Could not find Thread table entry");
+
+	device = &cc->devices[owner->devIdx];
+
+	VERIFY(owner->tte->ln < device->numLanes, NULL,
+	       "Lane ln%u_wp%u_sm%u_dev%u out of range", owner->tte->ln,
+	       owner->wte->warpId, owner->ste->smId, owner->dte->devId);
+
+	if (warp->lanes == NULL) {
+		warp->lanes = calloc(device->numLanes, sizeof(*warp->lanes));
+		VERIFY(warp->lanes != NULL, NULL, "Could not allocate memory");
 	}
 
-	return 0;
+	return &warp->lanes[owner->tte->ln];
 }
 
-static int cuCoreReadCTATable(CudaCore *cc, Elf_Scn *scn)
+static int cuCoreReadDeviceTable(CudaCore *cc, Elf_Scn *scn)
 {
-	size_t ctate_count;
-	CudbgCTATableEntry *ctat, *ctate;
-	CudbgSmTableEntry *ste;
+	uint8_t *dt;
+	size_t dteCoreSz;
+	size_t dte_count;
 	CudbgDeviceTableEntry *dte;
-	size_t parent, offset;
+	CudaCoreDevice *device;
+	CudaCoreSection *section;
+	size_t dteSz;
+	size_t numWarps;
 	size_t i;
 
 	if (cuCoreGenericReadTable(cc->e, scn,
-				   &ctate_count,
-				   (void **)&ctat,
-				   sizeof(CudbgCTATableEntry),
-				   NULL, &parent, &offset) != 0)
+				   &dte_count,
+				   (void **)&dt,
+				   sizeof(CudbgDeviceTableEntry),
+				   &dteCoreSz, NULL, NULL) != 0)
 		return -1;
 
-	ste = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"smtbl_section%llu_offset%llu",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(ste != NULL, -1, "Could not find SM table entry");
+	VERIFY(cc->devices == NULL, -1, "Duplicate Device table");
 
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"smtbl_section%llu_offset%llu_dev",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry by SM");
+	cc->devices = calloc(dte_count, sizeof(*cc->devices));
+	VERIFY(dte_count == 0 || cc->devices != NULL, -1,
+	       "Could not allocate memory");
 
-	for (i = 0; i < ctate_count; ++i) {
-		ctate = &ctat[i];
+	section = &cc->sections[elfGetSectionIndex(cc->e, scn)];
+	section->type = CUDBG_SHT_DEV_TABLE;
+	section->table = dt;
+	section->entrySize = dteCoreSz;
+	section->numEntries = dte_count;
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, ctate, 0,
-				      "cta%u_sm%u_dev%u",
-				      (uint32_t) i,
-				      ste->smId,
-				      dte->devId))
-			return -1;
+	dteSz = (dteCoreSz <= sizeof(CudbgDeviceTableEntry)) ? dteCoreSz : sizeof(CudbgDeviceTableEntry);
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, ctate, 0,
-				      "ctatbl_section%llu_offset%llu",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+	for (i = 0; i < dte_count; ++i) {
+		dte = (CudbgDeviceTableEntry *)calloc(1, sizeof(*dte));
+		VERIFY(dte != NULL, -1, "Could not allocate memory");
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, ste, 0,
-				      "ctatbl_section%llu_offset%llu_sm",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+		memcpy(dte, dt, dteSz);
+		dt += dteCoreSz;
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, dte, 0,
-				      "ctatbl_section%llu_offset%llu_dev",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+		device = &cc->devices[i];
+		device->dte = dte;
+		cc->numDevices = i + 1;
+
+		device->numSMs = dte->numSMs;
+		device->numWarps = dte->numWarpsPerSM;
+		device->numLanes = dte->numLanesPerWarp;
+
+		numWarps = (size_t)device->numSMs * device->numWarps;
+		if (numWarps == 0)
+			continue;
+
+		device->warps = calloc(numWarps, sizeof(*device->warps));
+		device->shared = calloc(numWarps, sizeof(*device->shared));
+		VERIFY(device->warps != NULL && device->shared != NULL, -1,
+		       "Could not allocate memory");
 	}
 
 	return 0;
 }
 
-static int cuCoreReadWarpTable(CudaCore *cc, Elf_Scn *scn)
+static int cuCoreReadGridTable(CudaCore *cc, Elf_Scn *scn)
 {
-	size_t wte_count;
-	CudbgWarpTableEntry *wt, *wte;
-	CudbgCTATableEntry *ctate;
-	CudbgSmTableEntry *ste;
-	CudbgDeviceTableEntry *dte;
-	size_t parent, offset;
+	CudaCoreSection *section;
+	CudbgGridTableEntry *gte;
 	size_t i;
 
-	if (cuCoreGenericReadTable(cc->e, scn,
-				   &wte_count,
-				   (void **)&wt,
-				   sizeof(CudbgWarpTableEntry),
-				   NULL, &parent, &offset) != 0)
+	if (cuCoreReadTableSection(cc, scn, sizeof(CudbgGridTableEntry),
+				   &section) != 0)
 		return -1;
 
-	ctate = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				  "ctatbl_section%llu_offset%llu",
-				  (unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(ctate != NULL, -1, "Could not find CTA table entry");
+	for (i = 0; i < section->numEntries; ++i) {
+		gte = &((CudbgGridTableEntry *)section->table)[i];
 
-	ste = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"ctatbl_section%llu_offset%llu_sm",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(ste != NULL, -1, "Could not find SM table entry by CTA");
-
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"ctatbl_section%llu_offset%llu_dev",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry by CTA");
+		if (cuCoreAddMapEntry(&cc->tableEntriesMap, gte, 0,
+				      "grid%llu_dev%u",
+				      (unsigned long long)gte->gridId64,
+				      section->dte->devId))
+			return -1;
+	}
 
-	for (i = 0; i < wte_count; ++i) {
-		wte = &wt[i];
+	return 0;
+}
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, wte, 0,
-				      "wp%u_sm%u_dev%u",
-				      wte->warpId,
-				      ste->smId,
-				      dte->devId))
-			return -1;
+static int cuCoreReadSmTable(CudaCore *cc, Elf_Scn *scn)
+{
+	CudaCoreSection *section;
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, ctate, 0,
-				      "wp%u_sm%u_dev%u_cta",
-				      wte->warpId,
-				      ste->smId,
-				      dte->devId))
-			return -1;
+	return cuCoreReadTableSection(cc, scn, sizeof(CudbgSmTableEntry),
+				      &section);
+}
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, wte, 0,
-				      "wptbl_section%llu_offset%llu",
-                                      (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+static int cuCoreReadCTATable(CudaCore *cc, Elf_Scn *scn)
+{
+	CudaCoreSection *section;
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, ste, 0,
-				      "wptbl_section%llu_offset%llu_sm",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+	if (cuCoreReadTableSection(cc, scn, sizeof(CudbgCTATableEntry),
+				   &section) != 0)
+		return -1;
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, dte, 0,
-				      "wptbl_section%llu_offset%llu_dev",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
-	}
+	VERIFY(section->ste != NULL, -1, "Could not find SM table entry");
 
 	return 0;
 }
 
-static int cuCoreReadThreadTable(CudaCore *cc, Elf_Scn *scn)
+static int cuCoreReadWarpTable(CudaCore *cc, Elf_Scn *scn)
 {
-	size_t tt_count;
-	CudbgThreadTableEntry *tt, *tte;
-	CudbgWarpTableEntry *wte;
-	CudbgSmTableEntry *ste;
-	CudbgDeviceTableEntry *dte;
-	size_t parent, offset;
+	CudaCoreSection *section;
+	CudaCoreSection owner;
+	CudaCoreWarp *warp;
 	size_t i;
 
-	cuCoreGenericReadTable(cc->e, scn, &tt_count, (void **)&tt,
-			       sizeof(CudbgThreadTableEntry),
-			       NULL, &parent, &offset);
+	if (cuCoreReadTableSection(cc, scn, sizeof(CudbgWarpTableEntry),
+				   &section) != 0)
+		return -1;
 
-	wte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"wptbl_section%llu_offset%llu",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(wte != NULL, -1, "Could not find Warp table entry");
+	VERIFY(section->ctate != NULL, -1, "Could not find CTA table entry");
 
-	ste = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"wptbl_section%llu_offset%llu_sm",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(ste != NULL, -1, "Could not find SM table entry by Warp");
+	owner = *section;
+	for (i = 0; i < section->numEntries; ++i) {
+		owner.wte = &((CudbgWarpTableEntry *)section->table)[i];
 
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"wptbl_section%llu_offset%llu_dev",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry by Warp");
+		warp = cuCoreGetOwnerWarp(cc, &owner);
+		if (warp == NULL)
+			return -1;
 
-	for (i = 0; i < tt_count; ++i) {
-		tte = &tt[i];
+		warp->wte = owner.wte;
+		warp->ctate = section->ctate;
+		warp->ctaIdx = section->ctaIdx;
+	}
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, tte, 0,
-				      "ln%u_wp%u_sm%u_dev%u",
-				      tte->ln, wte->warpId,
-				      ste->smId, dte->devId))
-			return -1;
+	return 0;
+}
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, tte, 0,
-				      "lntbl_section%llu_offset%llu",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+static int cuCoreReadThreadTable(CudaCore *cc, Elf_Scn *scn)
+{
+	CudaCoreSection *section;
+	CudaCoreSection owner;
+	CudaCoreLane *lane;
+	size_t i;
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, wte, 0,
-				      "lntbl_section%llu_offset%llu_wp",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+	if (cuCoreReadTableSection(cc, scn, sizeof(CudbgThreadTableEntry),
+				   &section) != 0)
+		return -1;
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, ste, 0,
-				      "lntbl_section%llu_offset%llu_sm",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+	owner = *section;
+	for (i = 0; i < section->numEntries; ++i) {
+		owner.tte = &((CudbgThreadTableEntry *)section->table)[i];
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, dte, 0,
-				      "lntbl_section%llu_offset%llu_dev",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
+		lane = cuCoreGetOwnerLane(cc, &owner);
+		if (lane == NULL)
 			return -1;
+
+		lane->tte = owner.tte;
 	}
 
 	return 0;
@@ -606,76 +694,41 @@ static int cuCoreReadThreadTable(CudaCore *cc, Elf_Scn *scn)
 
 static int cuCoreReadBacktraceTable(CudaCore *cc, Elf_Scn *scn)
 {
-	size_t bt_count;
-	CudbgBacktraceTableEntry *bt, *bte;
-	CudbgThreadTableEntry *tte;
-	CudbgWarpTableEntry *wte;
-	CudbgSmTableEntry *ste;
-	CudbgDeviceTableEntry *dte;
-	size_t parent, offset;
-	size_t i;
+	CudaCoreSection *section;
+	CudaCoreLane *lane;
 
-	cuCoreGenericReadTable(cc->e, scn, &bt_count, (void **)&bt,
-			       sizeof(CudbgBacktraceTableEntry),
-			       NULL, &parent, &offset);
-
-	tte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(tte != NULL, -1, "Could not find Thread table entry");
-
-	wte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu_wp",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(wte != NULL, -1, "Could not find Warp table entry by Lane");
-
-	ste = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu_sm",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(ste != NULL, -1, "Could not find SM table entry by Lane");
-
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu_dev",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry by Lane");
-
-	for (i = 0; i < bt_count; ++i) {
-		bte = &bt[i];
-
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, bte, 0,
-				      "bt%u_ln%u_wp%u_sm%u_dev%u",
-				      bte->level, tte->ln,
-				      wte->warpId, ste->smId,
-				      dte->devId))
-			return -1;
-	}
+	if (cuCoreReadTableSection(cc, scn, sizeof(CudbgBacktraceTableEntry),
+				   &section) != 0)
+		return -1;
+
+	lane = cuCoreGetOwnerLane(cc, section);
+	if (lane == NULL)
+		return -1;
+
+	lane->bt = section->table;
+	lane->numBt = section->numEntries;
 
 	return 0;
 }
 
 static int cuCoreReadContextTable(CudaCore *cc, Elf_Scn *scn)
 {
-	size_t cte_count;
-	CudbgContextTableEntry *ct, *cte;
+	CudaCoreSection *section;
+	CudbgContextTableEntry *cte;
 	CudbgDeviceTableEntry *dte;
-	size_t parent, offset;
 	size_t i;
 	CUDBGEvent event;
 
-	if (cuCoreGenericReadTable(cc->e, scn,
-				   &cte_count,
-				   (void **)&ct,
-				   sizeof(CudbgContextTableEntry),
-				   NULL, &parent, &offset) != 0)
+	if (cuCoreReadTableSection(cc, scn, sizeof(CudbgContextTableEntry),
+				   &section) != 0)
 		return -1;
 
-	for (i = 0; i < cte_count; ++i) {
-		cte = &ct[i];
+	for (i = 0; i < section->numEntries; ++i) {
+		cte = &((CudbgContextTableEntry *)section->table)[i];
 
-		dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-					"devtbl_offset%u",
-					cte->deviceIdx);
-		VERIFY(dte != NULL, -1, "Could not find Device table entry");
+		VERIFY(cte->deviceIdx < cc->numDevices, -1,
+		       "Could not find Device table entry");
+		dte = cc->devices[cte->deviceIdx].dte;
 
 		if (cuCoreAddMapEntry(&cc->tableEntriesMap, cte, 0,
 				      "ctx%llu_dev%u",
@@ -683,11 +736,6 @@ static int cuCoreReadContextTable(CudaCore *cc, Elf_Scn *scn)
 				      dte->devId))
 			return -1;
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, cte, 0,
-				      "ctxtbl_section%llu_offset%llu",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
-
 		/* Add context created event */
 		event.kind = CUDBG_EVENT_CTX_CREATE;
 		event.cases.contextCreate.dev = dte->devId;
@@ -709,143 +757,70 @@ static int cuCoreReadContextTable(CudaCore *cc, Elf_Scn *scn)
 
 static int cuCoreReadModuleTable(CudaCore *cc, Elf_Scn *scn)
 {
-	size_t mt_count;
-	CudbgModuleTableEntry *mt, *mte;
-	CudbgContextTableEntry *cte;
-	size_t parent, offset;
-	size_t i;
-
-	cuCoreGenericReadTable(cc->e, scn, &mt_count, (void **)&mt,
-			       sizeof(CudbgModuleTableEntry),
-			       NULL, &parent, &offset);
-
-	cte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"ctxtbl_section%llu_offset%llu",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(cte != NULL, -1, "Could not find Context table entry");
+	CudaCoreSection *section;
 
-	for (i = 0; i < mt_count; ++i) {
-		mte = &mt[i];
+	if (cuCoreReadTableSection(cc, scn, sizeof(CudbgModuleTableEntry),
+				   &section) != 0)
+		return -1;
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, mte, 0,
-				      "modtbl_section%llu_offset%llu",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
+	VERIFY(section->cte != NULL, -1, "Could not find Context table entry");
 
-		if (cuCoreAddMapEntry(&cc->tableEntriesMap, cte, 0,
-				      "modtbl_section%llu_offset%llu_ctx",
-					  (unsigned long long)elfGetSectionIndex(cc->e, scn), (unsigned long long)i))
-			return -1;
-	}
 	return 0;
 }
 
 static int cuCoreReadSharedMemorySection(CudaCore *cc, Elf_Scn *scn)
 {
-	CudbgSmTableEntry *ste;
-	CudbgDeviceTableEntry *dte;
-	Elf64_Shdr *shdr;
-	size_t parent, offset;
+	CudaCoreSection owner;
+	CudaCoreDevice *device;
 
-	if (cuCoreReadSectionHeader(scn, &shdr) != 0)
+	if (cuCoreGetSectionOwner(cc, scn, &owner) != 0)
 		return -1;
 
-	parent = shdr->sh_link;
-	offset = shdr->sh_info;
-
-	ste = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"ctatbl_section%llu_offset%llu_sm",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(ste != NULL, -1, "Could not find SM table entry");
+	VERIFY(owner.ste != NULL && owner.ctate != NULL, -1,
+	       "Could not find SM table entry");
 
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"ctatbl_section%llu_offset%llu_dev",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry");
+	device = &cc->devices[owner.devIdx];
+	VERIFY(owner.ste->smId < device->numSMs &&
+	       owner.ctaIdx < device->numWarps, -1,
+	       "Shared memory cta%u_sm%u_dev%u out of range",
+	       owner.ctaIdx, owner.ste->smId, owner.dte->devId);
 
-	if (cuCoreAddMapEntry(&cc->tableEntriesMap, scn, 0,
-			      "cta%llu_sm%u_dev%u_shared",
-			      (unsigned long long)offset,
-			      ste->smId,
-			      dte->devId))
-		return -1;
+	device->shared[owner.ste->smId * device->numWarps + owner.ctaIdx] = scn;
 
 	return 0;
 }
 
 static int cuCoreReadLocalMemorySection(CudaCore *cc, Elf_Scn *scn)
 {
-	CudbgThreadTableEntry *tte;
-	CudbgWarpTableEntry *wte;
-	CudbgSmTableEntry *ste;
-	CudbgDeviceTableEntry *dte;
-	Elf64_Shdr *shdr;
-	size_t parent, offset;
+	CudaCoreSection owner;
+	CudaCoreLane *lane;
 
-	if (cuCoreReadSectionHeader(scn, &shdr) != 0)
+	if (cuCoreGetSectionOwner(cc, scn, &owner) != 0)
 		return -1;
 
-	parent = shdr->sh_link;
-	offset = shdr->sh_info;
-
-	tte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(tte != NULL, -1, "Could not find Thread table entry");
-
-	wte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu_wp",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(wte != NULL, -1, "Could not find Warp table entry by Lane");
-
-	ste = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu_sm",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(ste != NULL, -1, "Could not find SM table entry by Lane");
-
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu_dev",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry by Lane");
-
-	if (cuCoreAddMapEntry(&cc->tableEntriesMap, scn, 0,
-			      "ln%u_wp%u_sm%u_dev%u_local",
-			      tte->ln,
-			      wte->warpId,
-			      ste->smId,
-			      dte->devId))
+	lane = cuCoreGetOwnerLane(cc, &owner);
+	if (lane == NULL)
 		return -1;
 
+	lane->local = scn;
+
 	return 0;
 }
 
 static int cuCoreReadParamMemorySection(CudaCore *cc, Elf_Scn *scn)
 {
-	CudbgGridTableEntry *gte;
-	CudbgDeviceTableEntry *dte;
-	Elf64_Shdr *shdr;
-	size_t parent, offset;
+	CudaCoreSection owner;
 
-	if (cuCoreReadSectionHeader(scn, &shdr) != 0)
+	if (cuCoreGetSectionOwner(cc, scn, &owner) != 0)
 		return -1;
 
-	parent = shdr->sh_link;
-	offset = shdr->sh_info;
-
-	gte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"grid_section%llu_offset%llu",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(gte != NULL, -1, "Could not find Grid table entry");
-
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"grid_section%llu_offset%llu_dev",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry by Grid");
+	VERIFY(owner.gte != NULL && owner.dte != NULL, -1,
+	       "Could not find Grid table entry");
 
 	if (cuCoreAddMapEntry(&cc->tableEntriesMap, scn, 0,
 			      "grid%llu_dev%u_param",
-			      (unsigned long long)gte->gridId64,
-			      dte->devId))
+			      (unsigned long long)owner.gte->gridId64,
+			      owner.dte->devId))
 		return -1;
 
 	return 0;
@@ -881,51 +856,42 @@ static void cuCoreRemoveELFImage(CudaCoreELFImage **elf)
 static int cuCoreReadELFImage(CudaCore *cc, Elf_Scn *scn, bool reloc)
 {
 	Elf64_Shdr *hdr;
-	CudbgModuleTableEntry *mte;
-	CudbgContextTableEntry *cte;
-	CudbgDeviceTableEntry *dte;
+	CudaCoreSection owner;
 	CUDBGEvent event;
 
 	if (cuCoreReadSectionHeader(scn, &hdr))
 		return -1;
 
-	mte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"modtbl_section%u_offset%u",
-				hdr->sh_link, hdr->sh_info);
-	VERIFY(mte != NULL, -1, "Could not find Module table entry");
+	if (cuCoreGetSectionOwner(cc, scn, &owner) != 0)
+		return -1;
+
+	VERIFY(owner.mte != NULL, -1, "Could not find Module table entry");
 
 	/* Hash the ELFs SCN by module handle */
 	if (cuCoreAddMapEntry(&cc->tableEntriesMap, scn, 0,
 			      "%celf_handle%llx",
 			      reloc ? 'r' : 'u',
-			      (unsigned long long)readUint64(&mte->moduleHandle)))
+			      (unsigned long long)readUint64(&owner.mte->moduleHandle)))
 		return -1;
 
 	if (!reloc)
 		return 0;
 
-	cte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"modtbl_section%u_offset%u_ctx",
-				hdr->sh_link, hdr->sh_info);
-	VERIFY(cte != NULL, -1, "Could not find Context table entry");
-
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"devtbl_offset%u",
-				cte->deviceIdx);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry");
+	VERIFY(owner.cte != NULL, -1, "Could not find Context table entry");
+	VERIFY(owner.dte != NULL, -1, "Could not find Device table entry");
 
 	/* Add module loaded event */
 	event.kind = CUDBG_EVENT_ELF_IMAGE_LOADED;
-	event.cases.elfImageLoaded.dev = dte->devId;
-	event.cases.elfImageLoaded.context = cte->contextId;
-	event.cases.elfImageLoaded.module = readUint64(&mte->moduleHandle);
+	event.cases.elfImageLoaded.dev = owner.dte->devId;
+	event.cases.elfImageLoaded.context = owner.cte->contextId;
+	event.cases.elfImageLoaded.module = readUint64(&owner.mte->moduleHandle);
 	event.cases.elfImageLoaded.size = readUint64(&hdr->sh_size);
-	event.cases.elfImageLoaded.handle = readUint64(&mte->moduleHandle);
+	event.cases.elfImageLoaded.handle = readUint64(&owner.mte->moduleHandle);
 	if (cuCoreAddEvent(cc, &event) != 0)
 		return -1;
 
 	/* Add ELF image to list */
-	if (cuCoreAddELFImage(&cc->relocatedELFImageHead, dte, cc->e, scn) != 0)
+	if (cuCoreAddELFImage(&cc->relocatedELFImageHead, owner.dte, cc->e, scn) != 0)
 		return -1;
 
 	return 0;
@@ -941,106 +907,438 @@ static int cuCoreReadRelocatedELFImage(CudaCore *cc, Elf_Scn *scn)
 	return cuCoreReadELFImage(cc, scn, true);
 }
 
-static int cuCoreReadWarpInfo(const char *key, CudaCore *cc, Elf_Scn *scn)
+static int cuCoreReadWarpInfo(CudaCore *cc, Elf_Scn *scn)
 {
-	CudbgWarpTableEntry *wte;
-	CudbgSmTableEntry *ste;
-	CudbgDeviceTableEntry *dte;
-	Elf64_Shdr *shdr;
-	size_t parent, offset;
+	CudaCoreSection owner;
+	CudaCoreWarp *warp;
 
-	if (cuCoreReadSectionHeader(scn, &shdr) != 0)
+	if (cuCoreGetSectionOwner(cc, scn, &owner) != 0)
 		return -1;
 
-	parent = shdr->sh_link;
-	offset = shdr->sh_info;
+	warp = cuCoreGetOwnerWarp(cc, &owner);
+	if (warp == NULL)
+		return -1;
 
-	wte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"wptbl_section%llu_offset%llu",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(wte != NULL, -1, "Could not find Warp table entry by Lane");
+	/* Index by dev, sm and wp */
+	if (owner.type == CUDBG_SHT_DEV_UREGS)
+		warp->uregs = scn;
+	else
+		warp->upred = scn;
 
-	ste = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"wptbl_section%llu_offset%llu_sm",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(ste != NULL, -1, "Could not find SM table entry by Lane");
+	return 0;
+}
 
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"wptbl_section%llu_offset%llu_dev",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry by Lane");
+static int cuCoreReadThreadInfo(CudaCore *cc, Elf_Scn *scn)
+{
+	CudaCoreSection owner;
+	CudaCoreLane *lane;
 
-	/* Hash by dev, sm, wp and ln indexes */
-	if (cuCoreAddMapEntry(&cc->tableEntriesMap, scn, 0,
-			      "%s_dev%u_sm%u_wp%u", key,
-			      dte->devId, ste->smId, wte->warpId))
+	if (cuCoreGetSectionOwner(cc, scn, &owner) != 0)
 		return -1;
 
+	lane = cuCoreGetOwnerLane(cc, &owner);
+	if (lane == NULL)
+		return -1;
+
+	/* Index by dev, sm, wp and ln */
+	if (owner.type == CUDBG_SHT_DEV_REGS)
+		lane->regs = scn;
+	else
+		lane->pred = scn;
+
 	return 0;
 }
 
-static int cuCoreReadThreadInfo(const char *key, CudaCore *cc, Elf_Scn *scn)
+const char *cuCoreGetStrTabByIndex(CudaCore *cc, size_t idx)
 {
-	CudbgThreadTableEntry *tte;
-	CudbgWarpTableEntry *wte;
-	CudbgSmTableEntry *ste;
-	CudbgDeviceTableEntry *dte;
+	return elfGetString(cc->e, cc->strndx, idx);
+}
+
+static int cuCoreDeferSection(CudaCore *cc, CudaCoreLazyKind kind,
+			      size_t ndxscn)
+{
+	if (cc->lazySections[kind] == NULL)
+		utarray_new(cc->lazySections[kind], &sectionIndex_icd);
+
+	utarray_push_back(cc->lazySections[kind], &ndxscn);
+
+	return 0;
+}
+
+/* Process a deferred section. Its parent tables were all read when the
+ * core dump was opened. */
+static int cuCoreReadLazySection(CudaCore *cc, size_t ndxscn)
+{
+	Elf_Scn *scn;
 	Elf64_Shdr *shdr;
-	size_t parent, offset;
+
+	scn = elfGetSection(cc->e, ndxscn);
+	VERIFY(scn != NULL, -1, "Could not find section '%llu'",
+	       (unsigned long long)ndxscn);
 
 	if (cuCoreReadSectionHeader(scn, &shdr) != 0)
 		return -1;
 
-	parent = shdr->sh_link;
-	offset = shdr->sh_info;
+	switch (shdr->sh_type) {
+	case CUDBG_SHT_MANAGED_MEM:
+		return cuCoreReadMemorySection(cc->e, scn, cc->managedMemorySegs);
+	case CUDBG_SHT_GLOBAL_MEM:
+		return cuCoreReadMemorySection(cc->e, scn, cc->globalMemorySegs);
+	case CUDBG_SHT_SHARED_MEM:
+		return cuCoreReadSharedMemorySection(cc, scn);
+	case CUDBG_SHT_LOCAL_MEM:
+		return cuCoreReadLocalMemorySection(cc, scn);
+	case CUDBG_SHT_PARAM_MEM:
+		return cuCoreReadParamMemorySection(cc, scn);
+	case CUDBG_SHT_ELF_IMG:
+		return cuCoreReadUnrelocatedELFImage(cc, scn);
+	case CUDBG_SHT_RELF_IMG:
+		return cuCoreReadRelocatedELFImage(cc, scn);
+	case CUDBG_SHT_DEV_REGS:
+	case CUDBG_SHT_DEV_PRED:
+		return cuCoreReadThreadInfo(cc, scn);
+	case CUDBG_SHT_DEV_UREGS:
+	case CUDBG_SHT_DEV_UPRED:
+		return cuCoreReadWarpInfo(cc, scn);
+	default:
+		break;
+	}
 
-	tte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(tte != NULL, -1, "Could not find Thread table entry");
+	return 0;
+}
 
-	wte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu_wp",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(wte != NULL, -1, "Could not find Warp table entry by Lane");
+/* Add the segments of a sorted array to the memory index, skipping the
+ * ones without data and trimming the parts already indexed */
+static void cuCoreIndexMemorySegs(UT_array *memoryIndex, UT_array *memorySegs)
+{
+	UT_array *merged;
+	MemorySeg *seg, *idx, *last, piece;
+	uint64_t start, end;
 
-	ste = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu_sm",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(ste != NULL, -1, "Could not find SM table entry by Lane");
+	utarray_new(merged, &memorySeg_icd);
+	utarray_reserve(merged, utarray_len(memoryIndex) + utarray_len(memorySegs));
 
-	dte = cuCoreGetMapEntry(&cc->tableEntriesMap,
-				"lntbl_section%llu_offset%llu_dev",
-				(unsigned long long)parent, (unsigned long long)offset);
-	VERIFY(dte != NULL, -1, "Could not find Device table entry by Lane");
+	idx = (MemorySeg *)utarray_front(memoryIndex);
 
-	/* Hash by dev, sm, wp and ln indexes */
-	if (cuCoreAddMapEntry(&cc->tableEntriesMap, scn, 0,
-			      "%s_dev%u_sm%u_wp%u_ln%u", key,
-			      dte->devId, ste->smId, wte->warpId, tte->ln))
+	for (seg = (MemorySeg *)utarray_front(memorySegs);
+	     seg != NULL;
+	     seg = (MemorySeg *)utarray_next(memorySegs, seg)) {
+		if (seg->data == NULL || seg->size == 0)
+			continue;
+
+		start = seg->address;
+		end = seg->address + seg->size;
+
+		for (;;) {
+			/* Keep the indexed segments starting before the range */
+			while (idx != NULL && idx->address <= start) {
+				utarray_push_back(merged, idx);
+				idx = (MemorySeg *)utarray_next(memoryIndex, idx);
+			}
+
+			/* Skip the part covered by the last segment kept */
+			last = (MemorySeg *)utarray_back(merged);
+			if (last != NULL && last->address + last->size > start)
+				start = last->address + last->size;
+			if (start >= end)
+				break;
+			if (idx != NULL && idx->address <= start)
+				continue;
+
+			/* Index the part up to the next indexed segment */
+			piece = *seg;
+			piece.address = start;
+			piece.size = (idx != NULL && idx->address < end ?
+				      idx->address : end) - start;
+			piece.data = seg->data + (start - seg->address);
+			utarray_push_back(merged, &piece);
+			start += piece.size;
+		}
+	}
+
+	for (; idx != NULL; idx = (MemorySeg *)utarray_next(memoryIndex, idx))
+		utarray_push_back(merged, idx);
+
+	utarray_clear(memoryIndex);
+	utarray_concat(memoryIndex, merged);
+	utarray_free(merged);
+}
+
+/* Global memory takes precedence over managed memory where both were
+ * dumped for the same addresses */
+static void cuCoreBuildMemoryIndex(CudaCore *cc)
+{
+	cuCoreIndexMemorySegs(cc->memoryIndex, cc->globalMemorySegs);
+	cuCoreIndexMemorySegs(cc->memoryIndex, cc->managedMemorySegs);
+
+	DPRINTF(10, "Memory index contains %u segments.\n",
+		utarray_len(cc->memoryIndex));
+}
+
+/* Find the indexed segment containing an address */
+MemorySeg *cuCoreFindMemorySeg(CudaCore *cc, uint64_t address)
+{
+	MemorySeg *segs = (MemorySeg *)utarray_front(cc->memoryIndex);
+	size_t lo = 0, hi = utarray_len(cc->memoryIndex), mid;
+
+	/* Find the last segment starting at or before address */
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (segs[mid].address <= address)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == 0 || address - segs[lo - 1].address >= segs[lo - 1].size)
+		return NULL;
+
+	return &segs[lo - 1];
+}
+
+typedef int (*ProcessSectionIndex)(CudaCore *cc, size_t ndxscn);
+
+/* A thread's share of a batch of independent sections */
+typedef struct {
+	CudaCore *cc;
+	const size_t *sections;		/* Section indices of the batch */
+	size_t begin;			/* Range of the batch to process */
+	size_t end;
+	ProcessSectionIndex process;
+	size_t failed;			/* Batch position of the first failure,
+					 * end if none */
+	char errMsg[ERRMSG_LEN];	/* Error message of that failure */
+} SectionWorker;
+
+static void *cuCoreSectionWorker(void *arg)
+{
+	SectionWorker *worker = arg;
+	size_t i;
+
+	for (i = worker->begin; i < worker->end; ++i) {
+		if (worker->process(worker->cc, worker->sections[i]) != 0) {
+			worker->failed = i;
+			_SNPRINTF(worker->errMsg, ERRMSG_LEN, "%s",
+				  cuCoreErrorMsg());
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static unsigned int cuCoreNumThreads(size_t numSections)
+{
+	unsigned int numThreads = 1;
+#ifdef CUCORE_THREADS
+	char *env_var_threads;
+	long n;
+
+	env_var_threads = getenv(ENV_VAR_THREADS);
+	if (env_var_threads)
+		n = atol(env_var_threads);
+	else
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (n > PARALLEL_THREADS_MAX)
+		n = PARALLEL_THREADS_MAX;
+	if (n > 1)
+		numThreads = n;
+
+	/* Leave each thread enough sections to pay for starting it */
+	if (numThreads > numSections / PARALLEL_SECTIONS_MIN)
+		numThreads = numSections / PARALLEL_SECTIONS_MIN;
+	if (numThreads == 0)
+		numThreads = 1;
+#endif
+	return numThreads;
+}
+
+/* Process a batch of sections that do not depend on each other, split
+ * in contiguous ranges across threads. If several sections fail, the
+ * error of the first one in batch order is reported, so the outcome
+ * does not depend on thread scheduling. */
+static int cuCoreProcessSectionBatch(CudaCore *cc, const size_t *sections,
+				     size_t numSections,
+				     ProcessSectionIndex process)
+{
+	SectionWorker workers[PARALLEL_THREADS_MAX];
+#ifdef CUCORE_THREADS
+	pthread_t threads[PARALLEL_THREADS_MAX];
+	bool started[PARALLEL_THREADS_MAX];
+#endif
+	SectionWorker *failed = NULL;
+	unsigned int numThreads, i;
+
+	if (numSections == 0)
+		return 0;
+
+	numThreads = cuCoreNumThreads(numSections);
+
+	for (i = 0; i < numThreads; ++i) {
+		workers[i].cc = cc;
+		workers[i].sections = sections;
+		workers[i].begin = numSections * i / numThreads;
+		workers[i].end = numSections * (i + 1) / numThreads;
+		workers[i].process = process;
+		workers[i].failed = workers[i].end;
+	}
+
+#ifdef CUCORE_THREADS
+	for (i = 1; i < numThreads; ++i)
+		started[i] = pthread_create(&threads[i], NULL,
+					    cuCoreSectionWorker,
+					    &workers[i]) == 0;
+#endif
+
+	cuCoreSectionWorker(&workers[0]);
+
+#ifdef CUCORE_THREADS
+	for (i = 1; i < numThreads; ++i) {
+		/* Fall back to this thread if one could not be started */
+		if (started[i])
+			pthread_join(threads[i], NULL);
+		else
+			cuCoreSectionWorker(&workers[i]);
+	}
+#endif
+
+	for (i = 0; i < numThreads && failed == NULL; ++i)
+		if (workers[i].failed != workers[i].end)
+			failed = &workers[i];
+
+	if (failed != NULL) {
+		cuCoreSetErrorMsg("%s", failed->errMsg);
 		return -1;
+	}
+
+	DPRINTF(20, "Processed %llu sections on %u threads.\n",
+		(unsigned long long)numSections, numThreads);
 
 	return 0;
 }
 
-const char *cuCoreGetStrTabByIndex(CudaCore *cc, size_t idx)
+int cuCoreLoadSections(CudaCore *cc, CudaCoreLazyKind kind)
 {
-	return elfGetString(cc->e, cc->strndx, idx);
+	UT_array *lazy = cc->lazySections[kind];
+	size_t *ndxscn;
+	int ret = 0;
+
+	/* A failed load stays failed */
+	if (cc->lazyErrors[kind] != NULL) {
+		cuCoreSetErrorMsg("%s", cc->lazyErrors[kind]);
+		return -1;
+	}
+
+	/* Already loaded, or nothing to load */
+	if (lazy == NULL)
+		return 0;
+
+	DPRINTF(10, "Loading %u deferred sections of kind %d.\n",
+		utarray_len(lazy), kind);
+
+	/* Sections are only ever processed once, even on failure */
+	cc->lazySections[kind] = NULL;
+
+	switch (kind) {
+	case CUDA_CORE_LAZY_SHARED:
+	case CUDA_CORE_LAZY_LOCAL:
+	case CUDA_CORE_LAZY_REGS:
+		/* Each section fills its own slot of the device index */
+		ret = cuCoreProcessSectionBatch(cc,
+						(size_t *)utarray_front(lazy),
+						utarray_len(lazy),
+						cuCoreReadLazySection);
+		break;
+	default:
+		for (ndxscn = (size_t *)utarray_front(lazy);
+		     ndxscn != NULL && ret == 0;
+		     ndxscn = (size_t *)utarray_next(lazy, ndxscn))
+			ret = cuCoreReadLazySection(cc, *ndxscn);
+		break;
+	}
+
+	utarray_free(lazy);
+
+	if (kind == CUDA_CORE_LAZY_GLOBAL) {
+		/* Sort memory sections so that we can binary search by address */
+		utarray_sort(cc->managedMemorySegs, cuCoreSortMemorySegs);
+		utarray_sort(cc->globalMemorySegs, cuCoreSortMemorySegs);
+		cuCoreBuildMemoryIndex(cc);
+	}
+
+	if (ret != 0) {
+		cc->lazyErrors[kind] = strdup(cuCoreErrorMsg());
+		if (cc->lazyErrors[kind] == NULL)
+			cc->lazyErrors[kind] = strdup("Could not allocate memory");
+	}
+
+	return ret;
 }
 
-static int cuCoreProcessSection(CudaCore *cc, bool *processed, Elf_Scn *scn)
+/* Depth of a section in the hierarchy, following sh_link up to a section
+ * without parent */
+static int cuCoreGetSectionLevel(CudaCore *cc, int *levels, size_t ndxscn)
 {
-	size_t ndxscn;
+	Elf_Scn *scn;
 	Elf64_Shdr *shdr;
-	const char *name;
+	size_t parentNdx;
+	int level = 0;
 
-	ndxscn = elfGetSectionIndex(cc->e, scn);
-	VERIFY(ndxscn != SHN_UNDEF, -1, "elfGetSectionIndex() failed: %s",
-	       elfErrorMsg());
+	if (levels[ndxscn] >= 0)
+		return levels[ndxscn];
 
-	/* Avoid processing the same section twice */
-	if (processed[ndxscn])
-		return 0;
+	VERIFY(levels[ndxscn] == -1, -1,
+	       "Section '%llu' is its own parent", (unsigned long long)ndxscn);
+	levels[ndxscn] = -2;
+
+	scn = elfGetSection(cc->e, ndxscn);
+	VERIFY(scn != NULL, -1, "elfGetSection() failed: %s", elfErrorMsg());
+
+	if (cuCoreReadSectionHeader(scn, &shdr) != 0)
+		return -1;
+
+	parentNdx = readUint32(&shdr->sh_link);
+	if (parentNdx != 0) {
+		VERIFY(parentNdx < cc->shnum, -1,
+		       "Could not find parent section '%llu'",
+		       (unsigned long long)parentNdx);
+
+		level = cuCoreGetSectionLevel(cc, levels, parentNdx);
+		if (level < 0)
+			return -1;
+		++level;
+	}
+
+	levels[ndxscn] = level;
+
+	return level;
+}
+
+/* Sections that only fill their own slots of the device index, and can
+ * be processed concurrently with the other sections of their level */
+static bool cuCoreIsIndexSection(uint32_t type)
+{
+	switch (type) {
+	case CUDBG_SHT_SM_TABLE:
+	case CUDBG_SHT_CTA_TABLE:
+	case CUDBG_SHT_WP_TABLE:
+	case CUDBG_SHT_LN_TABLE:
+	case CUDBG_SHT_BT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static int cuCoreProcessSection(CudaCore *cc, size_t ndxscn)
+{
+	Elf_Scn *scn;
+	Elf64_Shdr *shdr;
+	const char *name;
+
+	scn = elfGetSection(cc->e, ndxscn);
+	VERIFY(scn != NULL, -1, "elfGetSection() failed: %s", elfErrorMsg());
 
 	shdr = elfGetSectionHeader(scn);
 	VERIFY(shdr != NULL, -1, "elfGetSectionHeader() failed: %s",
@@ -1049,22 +1347,8 @@ static int cuCoreProcessSection(CudaCore *cc, bool *processed, Elf_Scn *scn)
 	name = elfGetString(cc->e, cc->shstrndx, shdr->sh_name);
 	VERIFY(name != NULL, -1, "elfGetString() failed: %s", elfErrorMsg());
 
-	/* Process parent section first */
-	if (shdr->sh_link != 0) {
-		Elf_Scn *parent_scn;
-
-		parent_scn = elfGetSection(cc->e, shdr->sh_link);
-		VERIFY(parent_scn != NULL, -1,
-		       "Could not find parent section '%u'", shdr->sh_link);
-
-		cuCoreProcessSection(cc, processed, parent_scn);
-	}
-
 	DPRINTF(40, "Processing section %s (#%llu)\n", name, (unsigned long long)ndxscn);
 
-	/* Mark section as processed */
-	processed[ndxscn] = true;
-
 	/* Handle string table special way */
 	if (strcmp(name, ".strtab") == 0) {
 		cc->strndx = ndxscn;
@@ -1075,18 +1359,25 @@ static int cuCoreProcessSection(CudaCore *cc, bool *processed, Elf_Scn *scn)
 	if (strcmp(name, ".shstrtab") == 0)
 		return 0;
 
-	/* Handle Cudbg tables */
+	/* Handle Cudbg tables, defer everything else until first use */
 	switch (shdr->sh_type) {
 	case CUDBG_SHT_MANAGED_MEM:
-		return cuCoreReadMemorySection(cc->e, scn, cc->managedMemorySegs);
 	case CUDBG_SHT_GLOBAL_MEM:
-		return cuCoreReadMemorySection(cc->e, scn, cc->globalMemorySegs);
+		return cuCoreDeferSection(cc, CUDA_CORE_LAZY_GLOBAL, ndxscn);
 	case CUDBG_SHT_SHARED_MEM:
-		return cuCoreReadSharedMemorySection(cc, scn);
+		return cuCoreDeferSection(cc, CUDA_CORE_LAZY_SHARED, ndxscn);
 	case CUDBG_SHT_LOCAL_MEM:
-		return cuCoreReadLocalMemorySection(cc, scn);
+		return cuCoreDeferSection(cc, CUDA_CORE_LAZY_LOCAL, ndxscn);
 	case CUDBG_SHT_PARAM_MEM:
-		return cuCoreReadParamMemorySection(cc, scn);
+		return cuCoreDeferSection(cc, CUDA_CORE_LAZY_PARAM, ndxscn);
+	case CUDBG_SHT_ELF_IMG:
+	case CUDBG_SHT_RELF_IMG:
+		return cuCoreDeferSection(cc, CUDA_CORE_LAZY_ELF, ndxscn);
+	case CUDBG_SHT_DEV_REGS:
+	case CUDBG_SHT_DEV_PRED:
+	case CUDBG_SHT_DEV_UREGS:
+	case CUDBG_SHT_DEV_UPRED:
+		return cuCoreDeferSection(cc, CUDA_CORE_LAZY_REGS, ndxscn);
 	case CUDBG_SHT_DEV_TABLE:
 		return cuCoreReadDeviceTable(cc, scn);
 	case CUDBG_SHT_GRID_TABLE:
@@ -1097,10 +1388,6 @@ static int cuCoreProcessSection(CudaCore *cc, bool *processed, Elf_Scn *scn)
 		return cuCoreReadThreadTable(cc, scn);
 	case CUDBG_SHT_MOD_TABLE:
 		return cuCoreReadModuleTable(cc, scn);
-	case CUDBG_SHT_ELF_IMG:
-		return cuCoreReadUnrelocatedELFImage(cc, scn);
-	case CUDBG_SHT_RELF_IMG:
-		return cuCoreReadRelocatedELFImage(cc, scn);
 	case CUDBG_SHT_BT:
 		return cuCoreReadBacktraceTable(cc, scn);
 	case CUDBG_SHT_CTX_TABLE:
@@ -1109,14 +1396,6 @@ static int cuCoreProcessSection(CudaCore *cc, bool *processed, Elf_Scn *scn)
 		return cuCoreReadSmTable(cc, scn);
 	case CUDBG_SHT_CTA_TABLE:
 		return cuCoreReadCTATable(cc, scn);
-	case CUDBG_SHT_DEV_REGS:
-		return cuCoreReadThreadInfo("regs", cc, scn);
-	case CUDBG_SHT_DEV_PRED:
-		return cuCoreReadThreadInfo("pred", cc, scn);
-	case CUDBG_SHT_DEV_UREGS:
-		return cuCoreReadWarpInfo("uregs", cc, scn);
-	case CUDBG_SHT_DEV_UPRED:
-		return cuCoreReadWarpInfo("upred", cc, scn);
 	default:
 		DPRINTF(5, "Found section of unknown type (0x%x)\n",
 			shdr->sh_type);
@@ -1128,9 +1407,12 @@ static int cuCoreProcessSection(CudaCore *cc, bool *processed, Elf_Scn *scn)
 
 static int cuCoreReadSections(CudaCore *cc)
 {
-	Elf_Scn *scn = NULL;
-	bool *processed;
-	int ret = 0;
+	Elf64_Shdr *shdr;
+	size_t *batch = NULL;
+	int *levels = NULL;
+	int level, maxLevel = 0;
+	size_t ndxscn, numBatch;
+	int ret = -1;
 
 	VERIFY(elfGetSectionHeaderStrTblIdx(cc->e, &cc->shstrndx) == 0, -1,
 	       "elfGetSectionHeaderStrTblIdx() failed: %s", elfErrorMsg());
@@ -1140,18 +1422,55 @@ static int cuCoreReadSections(CudaCore *cc)
 
 	DPRINTF(10, "Found %llu sections.\n", (unsigned long long)cc->shnum);
 
-	processed = calloc(cc->shnum, sizeof(*processed));
-	VERIFY(processed != NULL, -1, "Could not allocate memory");
+	cc->sections = calloc(cc->shnum, sizeof(*cc->sections));
+	VERIFY(cc->sections != NULL, -1, "Could not allocate memory");
 
-	while ((scn = elfGetNextSection(cc->e, scn)) != NULL) {
-		if (cuCoreProcessSection(cc, processed, scn) != 0) {
-			ret = -1;
+	levels = malloc(cc->shnum * sizeof(*levels));
+	batch = malloc(cc->shnum * sizeof(*batch));
+	if (levels == NULL || batch == NULL) {
+		cuCoreSetErrorMsg("Could not allocate memory");
+		goto cleanup;
+	}
+
+	for (ndxscn = 0; ndxscn < cc->shnum; ++ndxscn)
+		levels[ndxscn] = -1;
+
+	for (ndxscn = 1; ndxscn < cc->shnum; ++ndxscn) {
+		level = cuCoreGetSectionLevel(cc, levels, ndxscn);
+		if (level < 0)
 			goto cleanup;
+		if (level > maxLevel)
+			maxLevel = level;
+	}
+
+	/* A section only depends on its parent, so the sections are
+	 * processed one level of the hierarchy at a time. Within a level,
+	 * the sections updating shared maps and lists are processed in
+	 * order, and the ones filling the device index in parallel. */
+	for (level = 0; level <= maxLevel; ++level) {
+		numBatch = 0;
+
+		for (ndxscn = 1; ndxscn < cc->shnum; ++ndxscn) {
+			if (levels[ndxscn] != level)
+				continue;
+
+			shdr = elfGetSectionHeader(elfGetSection(cc->e, ndxscn));
+			if (cuCoreIsIndexSection(readUint32(&shdr->sh_type)))
+				batch[numBatch++] = ndxscn;
+			else if (cuCoreProcessSection(cc, ndxscn) != 0)
+				goto cleanup;
 		}
+
+		if (cuCoreProcessSectionBatch(cc, batch, numBatch,
+					      cuCoreProcessSection) != 0)
+			goto cleanup;
 	}
 
+	ret = 0;
+
 cleanup:
-	free(processed);
+	free(levels);
+	free(batch);
 	return ret;
 }
 
@@ -1230,6 +1549,9 @@ int cuCoreIterateELFImages(CudaCore *cc, cs_t *callStack)
 	bool relocated = POP(callStack, bool);
 	ProcessELF processELF = POP_PTR(callStack, ProcessELF);
 
+	if (cuCoreLoadSections(cc, CUDA_CORE_LAZY_ELF) != 0)
+		return -1;
+
 	for (elfImage = relocated ? cc->relocatedELFImageHead : NULL;
 			elfImage != NULL && ret == 0;
 			elfImage = elfImage->next) {
@@ -1493,14 +1815,11 @@ static int cuCoreInit(CudaCore *cc)
 	utarray_new(cc->managedMemorySegs, &memorySeg_icd);
 	utarray_new(cc->globalMemorySegs, &memorySeg_icd);
 	utarray_reserve(cc->globalMemorySegs, GLOBAL_MEMORY_SEGMENTS_MIN);
+	utarray_new(cc->memoryIndex, &memorySeg_icd);
 
 	if (cuCoreReadSections(cc))
 		return -1;
 
-	/* Sort memory sections so that we can binary search by address */
-	utarray_sort(cc->managedMemorySegs, cuCoreSortMemorySegs);
-	utarray_sort(cc->globalMemorySegs, cuCoreSortMemorySegs);
-
 	{ /* Get statistic on generic hash map */
 		unsigned int entries = HASH_COUNT(cc->tableEntriesMap);
 		DPRINTF(10, "Table entries map contains %d elements.\n",
@@ -1522,6 +1841,21 @@ void cuCoreFree(CudaCore *cc)
 	while (cc->relocatedELFImageHead != NULL)
 		cuCoreRemoveELFImage(&cc->relocatedELFImageHead);
 
+	{ /* Cleanup device index */
+		size_t i, j;
+		for (i = 0; i < cc->numDevices; ++i) {
+			CudaCoreDevice *device = &cc->devices[i];
+			if (device->warps != NULL)
+				for (j = 0; j < (size_t)device->numSMs * device->numWarps; ++j)
+					free(device->warps[j].lanes);
+			free(device->warps);
+			free(device->shared);
+			free(device->dte);
+		}
+		free(cc->devices);
+		free(cc->sections);
+	}
+
 	{ /* Cleanup table entries map */
 		MapEntry *mapEntry, *tmp;
 		HASH_ITER(hh, cc->tableEntriesMap, mapEntry, tmp) {
@@ -1532,11 +1866,22 @@ void cuCoreFree(CudaCore *cc)
 		}
 	}
 
+	{ /* Cleanup sections never loaded and failed load errors */
+		int kind;
+		for (kind = 0; kind < CUDA_CORE_LAZY_NUM; ++kind) {
+			if (cc->lazySections[kind] != NULL)
+				utarray_free(cc->lazySections[kind]);
+			free(cc->lazyErrors[kind]);
+		}
+	}
+
 	/* Cleanup memory segments arrays */
 	if (cc->managedMemorySegs)
 		utarray_free(cc->managedMemorySegs);
 	if (cc->globalMemorySegs)
 		utarray_free(cc->globalMemorySegs);
+	if (cc->memoryIndex)
+		utarray_free(cc->memoryIndex);
 
 	if (cc->e != NULL)
 		elfFree(cc->e);
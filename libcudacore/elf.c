@@ -322,14 +322,20 @@ Elf64_Shdr *elfGetSectionHeader(Elf_Scn *scn)
 int elfGetSectionData(Elf *e, Elf_Scn *scn, Elf_Data *data)
 {
 	Elf64_Shdr *shdr;
+	uint64_t offset, size;
 
 	shdr = elfGetSectionHeader(scn);
 	VERIFY(shdr != NULL, -1, "Could not get section header");
 
 	VERIFY(readUint32(&shdr->sh_type) != SHT_NOBITS, -1, "No data for SHT_NOBITS");
 
-	data->d_buf = (void *)((char *)e->mapped_addr + readUint64(&shdr->sh_offset));
-	data->d_size = readUint64(&shdr->sh_size);
+	offset = readUint64(&shdr->sh_offset);
+	size = readUint64(&shdr->sh_size);
+	VERIFY(offset <= (uint64_t)e->size && size <= (uint64_t)e->size - offset, -1,
+	       "Section data out of ELF image bounds");
+
+	data->d_buf = (void *)((char *)e->mapped_addr + offset);
+	data->d_size = size;
 	data->d_type = readUint32(&shdr->sh_type);
 	data->d_entsize = readUint64(&shdr->sh_entsize);
 